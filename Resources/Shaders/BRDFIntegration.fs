@@ -0,0 +1,63 @@
+#version 330 core
+// Second term of the split sum( PrefilteredEnvironment ): GGX specular integrated against white light, stored as
+// scale and bias to F0 over NdotV( x ) and roughness( y ). Independent of the environment.
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+uniform int sampleCount;
+
+const float PI = 3.14159265359;
+
+vec2 Hammersley(uint idx, uint count)
+{
+    uint bits = idx;
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return vec2(float(idx) / float(count), float(bits) * 2.3283064365386963e-10);
+}
+
+// Tangent space sample around +z
+vec3 ImportanceSampleGGX(vec2 xi, float alpha)
+{
+    float phi = 2.0 * PI * xi.x;
+    float cosTheta = sqrt((1.0 - xi.y) / (1.0 + (alpha * alpha - 1.0) * xi.y));
+    float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    return vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+}
+
+// Smith Schlick-GGX with the image based lighting remapping k = alpha / 2
+float GeometrySmith(float NdotV, float NdotL, float alpha)
+{
+    float k = alpha * 0.5;
+    return (NdotV / (NdotV * (1.0 - k) + k)) * (NdotL / (NdotL * (1.0 - k) + k));
+}
+
+void main()
+{
+    float NdotV = max(texCoords.x, 0.001);
+    float roughness = texCoords.y;
+    float alpha = roughness * roughness;
+    vec3 V = vec3(sqrt(1.0 - NdotV * NdotV), 0.0, NdotV);
+
+    vec2 result = vec2(0.0);
+    for (int idx = 0; idx < sampleCount; ++idx)
+    {
+        vec3 H = ImportanceSampleGGX(Hammersley(uint(idx), uint(sampleCount)), alpha);
+        vec3 L = normalize(2.0 * dot(V, H) * H - V);
+        float NdotL = max(L.z, 0.0);
+        if (NdotL > 0.0)
+        {
+            float NdotH = max(H.z, 0.0);
+            float VdotH = max(dot(V, H), 0.0);
+            float visibility = GeometrySmith(NdotV, NdotL, alpha) * VdotH / max(NdotH * NdotV, 0.0001);
+            float fresnel = pow(1.0 - VdotH, 5.0);
+            result += vec2(1.0 - fresnel, fresnel) * visibility;
+        }
+    }
+
+    FragColor = vec4(result / float(sampleCount), 0.0, 1.0);
+}
\ No newline at end of file
@@ -1,23 +1,31 @@
 #version 330 core
+// Permutations( ShaderPermutations ):
+//  SHADOW_FILTER <n>     : ShadowFilter tier, see FilterShadow
+//  POINT_SHADOW_MODE <n> : PointShadowMode, 0 = cube map, 1 = dual paraboloid
+#ifndef SHADOW_FILTER
+#define SHADOW_FILTER 0
+#endif
+#ifndef POINT_SHADOW_MODE
+#define POINT_SHADOW_MODE 0
+#endif
+
 layout (location = 0) out vec4 FragColor;
 layout (location = 1) out vec4 BrightColor;
+layout (location = 2) out vec2 Velocity;
 
 in VS_OUT
 {
     vec3 fragPos;
     vec3 normal;
     vec2 texCoords;
+    float viewDepth;
+    vec4 currentClip;
+    vec4 previousClip;
 }fsin;
 
-struct Light
-{
-    vec3 position;
-    vec3 color;
-};
+#include "SceneLighting.glsl"
 
-uniform Light lights[3];
 uniform vec3 viewPos;
-
 uniform sampler2D diffuseMap;
 
 void main()
@@ -25,24 +33,10 @@ void main()
     vec3 normal = normalize(fsin.normal);
     vec3 color = texture(diffuseMap, fsin.texCoords).rgb;
 
-    float ambient = 0.1f;
-    vec3 ambientColor = ambient * color;
-
-    vec3 lightRes = vec3(0.0);
-    for(int idx = 0; idx < 3; ++idx)
-    {
-        vec3 lightPos = lights[idx].position;
-
-        vec3 fragToLight = normalize(lightPos - fsin.fragPos);
-        float diffuse = max(0.0, dot(fragToLight, normal));
-        vec3 diffuseColor = diffuse * color * lights[idx].color;
+    vec3 ambientColor = AmbientIrradiance(normal) * color + AmbientSpecular(normal, normalize(viewPos - fsin.fragPos));
 
-        vec3 res = diffuseColor;
-        float dist = length(lightPos - fsin.fragPos);
-        float attenutation = 1.0 / (dist * dist);
-        res *= attenutation;
-        lightRes += res;
-    }
+    vec3 lightRes = ShadeClusterLights(fsin.fragPos, normal, color, fsin.viewDepth);
+    lightRes += ShadeSun(fsin.fragPos, normal, color, fsin.viewDepth);
 
     vec3 result = lightRes + ambientColor;
     FragColor = vec4(result, 1.0);
@@ -56,4 +50,7 @@ void main()
     {
         BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
     }
+
+    // Screen space motion since last frame in uv units
+    Velocity = (fsin.currentClip.xy / fsin.currentClip.w - fsin.previousClip.xy / fsin.previousClip.w) * 0.5;
 }
\ No newline at end of file
@@ -8,18 +8,33 @@ out VS_OUT
     vec3 fragPos;
     vec3 normal;
     vec2 texCoords;
+    float viewDepth;
+    vec4 currentClip;
+    vec4 previousClip;
 }vsout;
 
 uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
+// Per draw from the render queue( BatchMath ): inverse transpose of model, projection * view * model
+uniform mat4 normalMatrix;
+uniform mat4 modelViewProjection;
+
+// Unjittered, only used for velocity
+uniform mat4 currentViewProjection;
+uniform mat4 previousViewProjection;
 
 void main()
 {
     vsout.fragPos = vec3(model * vec4(aPosition, 1.0));
     vsout.texCoords = aTexCoords;
+    vsout.viewDepth = -(view * model * vec4(aPosition, 1.0)).z;
+
+    vsout.normal = mat3(normalMatrix) * aNormal;
 
-    vsout.normal = mat3(transpose(inverse(model))) * aNormal;
+    gl_Position = modelViewProjection * vec4(aPosition, 1.0);
 
-    gl_Position = projection * view * model * vec4(aPosition, 1.0);
+    // Objects are static, only camera motion contributes
+    vsout.currentClip = currentViewProjection * model * vec4(aPosition, 1.0);
+    vsout.previousClip = previousViewProjection * model * vec4(aPosition, 1.0);
 }
\ No newline at end of file
@@ -1,8 +1,11 @@
 #version 330 core
 layout (location = 0) out vec4 FragColor;
 layout (location = 1) out vec4 BrightColor;
+layout (location = 2) out vec2 Velocity;
 
-uniform vec3 lightColor;
+in vec4 currentClip;
+in vec4 previousClip;
+flat in vec3 lightColor;
 
 void main()
 {
@@ -16,4 +19,6 @@ void main()
     {
         BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
     }
+
+    Velocity = (currentClip.xy / currentClip.w - previousClip.xy / previousClip.w) * 0.5;
 }
\ No newline at end of file
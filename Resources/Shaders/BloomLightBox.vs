@@ -5,9 +5,26 @@ layout (location = 2) in vec2 aTexCoords;
 
 uniform mat4 projection;
 uniform mat4 view;
-uniform mat4 model;
+
+// Drawn instanced, one box per light: 2 texels per light( position.xyz + radius, color.rgb )
+uniform samplerBuffer lightData;
+uniform float proxyScale;
+
+// Unjittered, only used for velocity
+uniform mat4 currentViewProjection;
+uniform mat4 previousViewProjection;
+
+out vec4 currentClip;
+out vec4 previousClip;
+flat out vec3 lightColor;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec3 lightPosition = texelFetch(lightData, gl_InstanceID * 2).xyz;
+    lightColor = texelFetch(lightData, gl_InstanceID * 2 + 1).rgb;
+
+    vec4 worldPos = vec4(aPos * proxyScale + lightPosition, 1.0);
+    gl_Position = projection * view * worldPos;
+    currentClip = currentViewProjection * worldPos;
+    previousClip = previousViewProjection * worldPos;
 }
\ No newline at end of file
@@ -1,32 +1,26 @@
 #version 330 core
+// Permutations( ShaderPermutations ): HORIZONTAL blurs along x, otherwise along y
 out vec4 FragColor;
 
 in vec2 texCoords;
 
 uniform sampler2D image;
 
-uniform bool horizontal;
 uniform float weights[5] = float[](0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
 
 void main()
 {
-    vec2 tex_offset = 1.0 / textureSize(image, 0);
+#ifdef HORIZONTAL
+    vec2 texelStep = vec2(1.0 / float(textureSize(image, 0).x), 0.0);
+#else
+    vec2 texelStep = vec2(0.0, 1.0 / float(textureSize(image, 0).y));
+#endif
+
     vec3 result = texture(image, texCoords).rgb * weights[0];
-    if (horizontal)
-    {
-        for (int idx = 1; idx < 5; ++idx)
-        {
-            result += texture(image, texCoords + vec2(tex_offset.x * idx, 0.0)).rgb * weights[idx];
-            result += texture(image, texCoords - vec2(tex_offset.x * idx, 0.0)).rgb * weights[idx];
-        }
-    }
-    else
+    for (int idx = 1; idx < 5; ++idx)
     {
-        for (int idx = 1; idx < 5; ++idx)
-        {
-            result += texture(image, texCoords + vec2(0.0, tex_offset.y * idx)).rgb * weights[idx];
-            result += texture(image, texCoords - vec2(0.0, tex_offset.y * idx)).rgb * weights[idx];
-        }
+        result += texture(image, texCoords + texelStep * float(idx)).rgb * weights[idx];
+        result += texture(image, texCoords - texelStep * float(idx)).rgb * weights[idx];
     }
 
     FragColor = vec4(result, 1.0);
@@ -0,0 +1,49 @@
+#version 430 core
+#define TILE_SIZE 128
+#define MAX_RADIUS 32
+
+layout (local_size_x = TILE_SIZE, local_size_y = 1) in;
+
+layout (rgba16f, binding = 0) uniform writeonly image2D outputImage;
+uniform sampler2D image;
+
+uniform bool horizontal;
+uniform int radius;
+uniform float weights[MAX_RADIUS + 1];
+
+// Whole row( or column ) segment + apron, every texel fetched from memory exactly once per work group
+shared vec3 tile[TILE_SIZE + 2 * MAX_RADIUS];
+
+void main()
+{
+    ivec2 size = textureSize(image, 0);
+    ivec2 axis = horizontal ? ivec2(1, 0) : ivec2(0, 1);
+    ivec2 across = (ivec2(1) - axis) * int(gl_WorkGroupID.y);
+    int length = horizontal ? size.x : size.y;
+
+    int local = int(gl_LocalInvocationID.x);
+    int tileStart = int(gl_WorkGroupID.x) * TILE_SIZE - radius;
+    int tileLength = TILE_SIZE + 2 * radius;
+    for (int idx = local; idx < tileLength; idx += TILE_SIZE)
+    {
+        int coord = clamp(tileStart + idx, 0, length - 1);
+        tile[idx] = texelFetch(image, axis * coord + across, 0).rgb;
+    }
+
+    barrier();
+
+    int along = int(gl_WorkGroupID.x) * TILE_SIZE + local;
+    if (along >= length)
+    {
+        return;
+    }
+
+    int center = local + radius;
+    vec3 result = tile[center] * weights[0];
+    for (int idx = 1; idx <= radius; ++idx)
+    {
+        result += (tile[center + idx] + tile[center - idx]) * weights[idx];
+    }
+
+    imageStore(outputImage, axis * along + across, vec4(result, 1.0));
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+// Permutations( ShaderPermutations ): TAP_COUNT <n> fetches per side including the center( GaussianKernel tap count ),
+// the loop below gets a compile time trip count
+#ifndef TAP_COUNT
+#define TAP_COUNT 1
+#endif
+
+uniform sampler2D image;
+
+// Blur axis pre-multiplied by texel size, ex) (1/width, 0) for horizontal pass
+uniform vec2 direction;
+uniform float weights[TAP_COUNT];
+uniform float offsets[TAP_COUNT];
+
+void main()
+{
+    vec3 result = texture(image, texCoords).rgb * weights[0];
+    // Each fetch lands between two texels, bilinear filter blends them with the proper weights
+    for (int idx = 1; idx < TAP_COUNT; ++idx)
+    {
+        vec2 offset = direction * offsets[idx];
+        result += texture(image, texCoords + offset).rgb * weights[idx];
+        result += texture(image, texCoords - offset).rgb * weights[idx];
+    }
+
+    FragColor = vec4(result, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#version 330 core
+// Final post process pass: bloom add -> exposure -> tonemap -> color grading -> output encoding.
+// Permutation defines( injected by PostProcessComposite )
+//  BLOOM               : add blurred bright color
+//  AUTO_EXPOSURE       : exposure from GPU adapted average luminance, 'exposure' becomes compensation
+//  TONEMAP <n>         : 0 exponential, 1 reinhard, 2 aces, 3 filmic( uncharted 2 )
+//  COLOR_GRADING       : 3D LUT lookup on tonemapped color
+//  OUTPUT_ENCODING <n> : 0 linear( sRGB framebuffer ), 1 gamma 2.2, 2 exact sRGB curve
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+#ifndef TONEMAP
+#define TONEMAP 0
+#endif
+
+#ifndef OUTPUT_ENCODING
+#define OUTPUT_ENCODING 1
+#endif
+
+uniform sampler2D scene;
+uniform float exposure;
+
+#ifdef BLOOM
+uniform sampler2D bloomBlur;
+uniform float bloomStrength;
+#endif
+
+#ifdef AUTO_EXPOSURE
+uniform sampler2D adaptedLuminance;
+#endif
+
+#ifdef COLOR_GRADING
+uniform sampler3D colorGradingLUT;
+uniform float lutSize;
+#endif
+
+vec3 ToneMap(vec3 color)
+{
+#if TONEMAP == 0
+    return vec3(1.0) - exp(-color);
+#elif TONEMAP == 1
+    return color / (vec3(1.0) + color);
+#elif TONEMAP == 2
+    // Narkowicz ACES filmic curve fit
+    const float a = 2.51;
+    const float b = 0.03;
+    const float c = 2.43;
+    const float d = 0.59;
+    const float e = 0.14;
+    return clamp((color * (a * color + b)) / (color * (c * color + d) + e), 0.0, 1.0);
+#else
+    // Hable( uncharted 2 ), white point 11.2
+    const float A = 0.15;
+    const float B = 0.50;
+    const float C = 0.10;
+    const float D = 0.20;
+    const float E = 0.02;
+    const float F = 0.30;
+    const float whiteScale = 1.0 / 0.7251; // 1 / curve(11.2)
+    vec3 x = color * 2.0;
+    vec3 curve = ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+    return curve * whiteScale;
+#endif
+}
+
+vec3 Encode(vec3 color)
+{
+#if OUTPUT_ENCODING == 0
+    return color;
+#elif OUTPUT_ENCODING == 1
+    return pow(color, vec3(1.0 / 2.2));
+#else
+    vec3 low = color * 12.92;
+    vec3 high = 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055;
+    return mix(high, low, vec3(lessThanEqual(color, vec3(0.0031308))));
+#endif
+}
+
+void main()
+{
+    vec3 hdrColor = texture(scene, texCoords).rgb;
+#ifdef BLOOM
+    hdrColor += texture(bloomBlur, texCoords).rgb * bloomStrength;
+#endif
+
+#ifdef AUTO_EXPOSURE
+    // Maps the average luminance onto middle grey
+    const float keyValue = 0.18;
+    float finalExposure = exposure * keyValue / max(texelFetch(adaptedLuminance, ivec2(0, 0), 0).r, 0.0001);
+#else
+    float finalExposure = exposure;
+#endif
+
+    vec3 result = ToneMap(hdrColor * finalExposure);
+
+#ifdef COLOR_GRADING
+    // Remap [0,1] onto texel centers of the LUT
+    vec3 lutCoords = clamp(result, 0.0, 1.0) * ((lutSize - 1.0) / lutSize) + (0.5 / lutSize);
+    result = texture(colorGradingLUT, lutCoords).rgb;
+#endif
+
+    FragColor = vec4(Encode(result), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#version 330 core
+// Cone step relief mapping( vertex stage ParallaxMapping.vs ), cone map made by Tools/ConeMapGenerator:
+// R = depth, G = sqrt( cone ratio ). Every step moves the ray to the side of the empty cone below it, so a few
+// fetches converge where ParallaxMapping.fs walks up to 32 layers. Distant or minified surfaces, where relief is
+// not visible anyway, fade into plain normal mapping and skip the search.
+// Not loaded by the demo, whose scene has no relief mapped surface( ParallaxMapping.fs is not drawn either ).
+// Using it means binding the cone map and the uniforms below on a draw with ParallaxMapping.vs.
+out vec4 FragColor;
+
+in VS_OUT
+{
+    vec3 fragPosition;
+    vec2 texCoords;
+    vec3 tangentLightPos;
+    vec3 tangentViewPos;
+    vec3 tangentFragPos;
+}fsin;
+
+uniform sampler2D diffuseMap;
+uniform sampler2D normalMap;
+uniform sampler2D coneMap;
+
+uniform float heightScale;
+uniform int coneSteps;                  // ex) 8 ~ 16
+uniform vec2 reliefFadeRange;           // view distance over which relief fades out
+uniform float reliefMaxTexelsPerPixel;  // texel footprint at which relief is fully faded out
+
+vec2 ConeStepMapping(vec2 texCoords, vec3 viewDir, float scale)
+{
+    // One unit of depth moves the ray by ds.xy in uv
+    vec3 ds = vec3(-viewDir.xy / max(viewDir.z, 0.05) * scale, 1.0);
+    float rayRatio = length(ds.xy);
+
+    vec3 pos = vec3(texCoords, 0.0);
+    for (int idx = 0; idx < coneSteps; ++idx)
+    {
+        // Cone ratios do not survive averaging, always read the base level
+        vec2 cone = textureLod(coneMap, pos.xy, 0.0).rg;
+        float coneRatio = cone.g * cone.g;
+        float depthLeft = max(cone.r - pos.z, 0.0);
+        pos += ds * (coneRatio * depthLeft / (rayRatio + coneRatio));
+    }
+
+    return pos.xy;
+}
+
+float ReliefStrength(vec2 texCoords, float viewDistance)
+{
+    vec2 footprint = max(abs(dFdx(texCoords)), abs(dFdy(texCoords))) * vec2(textureSize(coneMap, 0));
+    float texelsPerPixel = max(footprint.x, footprint.y);
+    float distanceFade = smoothstep(reliefFadeRange.x, reliefFadeRange.y, viewDistance);
+    float footprintFade = smoothstep(reliefMaxTexelsPerPixel * 0.5, reliefMaxTexelsPerPixel, texelsPerPixel);
+    return (1.0 - distanceFade) * (1.0 - footprintFade);
+}
+
+void main()
+{
+    vec3 fragToView = fsin.tangentViewPos - fsin.tangentFragPos;
+
+    // Depth shrinks with strength instead of switching off, no popping at the fade boundary
+    vec2 texCoords = fsin.texCoords;
+    float strength = ReliefStrength(fsin.texCoords, length(fragToView));
+    if (strength > 0.0)
+    {
+        texCoords = ConeStepMapping(fsin.texCoords, normalize(fragToView), heightScale * strength);
+        if (texCoords.x > 1.0 || texCoords.x < 0.0 || texCoords.y > 1.0 || texCoords.y < 0.0)
+        {
+            discard;
+        }
+    }
+
+    vec3 normal = texture(normalMap, texCoords).rgb;
+    normal = normalize((normal * 2.0) - 1.0); // Map to [-1, 1]
+
+    vec3 color = texture(diffuseMap, texCoords).rgb;
+    vec3 fragToLight = normalize(fsin.tangentLightPos - fsin.tangentFragPos);
+    float diffuse = max(0.0, dot(normal, fragToLight));
+    vec3 diffuseColor = diffuse * color;
+
+    vec3 halfway = normalize(fragToLight + normalize(fragToView));
+    float specular = pow(max(0.0, dot(normal, halfway)), 32.0);
+    vec3 specularColor = vec3(0.2) * specular;
+
+    float ambient = 0.1;
+    vec3 ambientColor = ambient * color;
+
+    FragColor = vec4(ambientColor + diffuseColor + specularColor, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#version 330 core
+// Deferred lighting: full screen, every pixel shades only the lights of its cluster( same lists as forward ).
+// Cost follows visible pixels x local light count, overdraw was resolved by the G-buffer depth test.
+// Permutations( ShaderPermutations ), same as Bloom.fs:
+//  SHADOW_FILTER <n>     : ShadowFilter tier, see FilterShadow
+//  POINT_SHADOW_MODE <n> : PointShadowMode, 0 = cube map, 1 = dual paraboloid
+#ifndef SHADOW_FILTER
+#define SHADOW_FILTER 0
+#endif
+#ifndef POINT_SHADOW_MODE
+#define POINT_SHADOW_MODE 0
+#endif
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 BrightColor;
+
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+uniform mat4 inverseViewProjection;
+uniform mat4 view;
+uniform vec3 backgroundColor;
+uniform vec3 viewPos;
+
+#include "SceneLighting.glsl"
+
+vec3 DecodeNormal(vec2 encoded)
+{
+    encoded = encoded * 2.0 - 1.0;
+    vec3 normal = vec3(encoded.x, encoded.y, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = clamp(-normal.z, 0.0, 1.0);
+    normal.xy += vec2(normal.x >= 0.0 ? -t : t, normal.y >= 0.0 ? -t : t);
+    return normalize(normal);
+}
+
+void main()
+{
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(gDepth, coord, 0).r;
+    if (depth >= 1.0)
+    {
+        FragColor = vec4(backgroundColor, 1.0);
+        BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    vec2 uv = (vec2(coord) + 0.5) / clusterScreenSize;
+    vec4 worldPos = inverseViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    vec3 fragPos = worldPos.xyz / worldPos.w;
+    float viewDepth = -(view * vec4(fragPos, 1.0)).z;
+
+    vec3 color = texelFetch(gAlbedo, coord, 0).rgb;
+    vec3 normal = DecodeNormal(texelFetch(gNormal, coord, 0).xy);
+
+    // Same terms as Bloom.fs
+    vec3 ambientColor = AmbientIrradiance(normal) * color + AmbientSpecular(normal, normalize(viewPos - fragPos));
+    vec3 result = ShadeClusterLights(fragPos, normal, color, viewDepth) + ShadeSun(fragPos, normal, color, viewDepth) + ambientColor;
+    FragColor = vec4(result, 1.0);
+
+    float brightness = dot(result, vec3(0.2126, 0.7152, 0.0722));
+    BrightColor = (brightness > 1.0) ? vec4(result, 1.0) : vec4(0.0, 0.0, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#version 330 core
+// Separable gaussian over one layer of the EVSM moments( linear sampled kernel, see BlurLinear.fs ).
+// Moments filter linearly, so blurring them once here replaces a PCF kernel at every shaded pixel.
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+#define MAX_TAPS 8
+
+uniform sampler2DArray image;
+uniform int layer;
+
+// Blur axis pre-multiplied by texel size
+uniform vec2 direction;
+uniform int tapCount;
+uniform float weights[MAX_TAPS];
+uniform float offsets[MAX_TAPS];
+
+void main()
+{
+    vec4 result = texture(image, vec3(texCoords, layer)) * weights[0];
+    for (int idx = 1; idx < tapCount; ++idx)
+    {
+        vec2 offset = direction * offsets[idx];
+        result += texture(image, vec3(texCoords + offset, layer)) * weights[idx];
+        result += texture(image, vec3(texCoords - offset, layer)) * weights[idx];
+    }
+
+    FragColor = result;
+}
\ No newline at end of file
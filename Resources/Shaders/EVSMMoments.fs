@@ -0,0 +1,29 @@
+#version 330 core
+// Converts one shadow cascade into exponential variance moments at half resolution:
+// ( e^(c1 d), e^(2 c1 d), -e^(-c2 d), e^(-2 c2 d) ) with depth d remapped to [-1, 1].
+// The 2x2 source texels are averaged after warping, so the downsample keeps the moments exact.
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+uniform sampler2DArray depthMap;  // read through a sampler without compare mode
+uniform int layer;
+uniform vec2 exponents;           // positive, negative
+
+vec4 WarpedMoments(float depth)
+{
+    depth = depth * 2.0 - 1.0;
+    vec2 warped = vec2(exp(exponents.x * depth), -exp(-exponents.y * depth));
+    return vec4(warped.x, warped.x * warped.x, warped.y, warped.y * warped.y);
+}
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy) * 2;
+    vec4 moments = WarpedMoments(texelFetch(depthMap, ivec3(texel, layer), 0).r);
+    moments += WarpedMoments(texelFetch(depthMap, ivec3(texel + ivec2(1, 0), layer), 0).r);
+    moments += WarpedMoments(texelFetch(depthMap, ivec3(texel + ivec2(0, 1), layer), 0).r);
+    moments += WarpedMoments(texelFetch(depthMap, ivec3(texel + ivec2(1, 1), layer), 0).r);
+
+    FragColor = moments * 0.25;
+}
\ No newline at end of file
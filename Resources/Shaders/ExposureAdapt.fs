@@ -0,0 +1,15 @@
+#version 330 core
+// Downsample fallback: 1x1 temporal adaptation, previous result comes from the other ping-pong texture
+out vec4 FragColor;
+
+uniform sampler2D logLuminance;
+uniform sampler2D previousLuminance;
+uniform float averageLevel;
+uniform float adaptationFactor;
+
+void main()
+{
+    float target = exp2(textureLod(logLuminance, vec2(0.5, 0.5), averageLevel).r);
+    float previous = texelFetch(previousLuminance, ivec2(0, 0), 0).r;
+    FragColor = vec4(previous + (target - previous) * adaptationFactor, 0.0, 0.0, 1.0);
+}
\ No newline at end of file
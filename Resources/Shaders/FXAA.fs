@@ -0,0 +1,53 @@
+#version 330 core
+// Post process AA on the encoded( display referred ) composite output.
+// Edge direction from the luma gradient of the 2x2 neighbourhood, blurred along the edge with two taps.
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+uniform sampler2D image;
+uniform vec2 inverseScreenSize;
+
+#define FXAA_SPAN_MAX 8.0
+#define FXAA_REDUCE_MUL (1.0 / 8.0)
+#define FXAA_REDUCE_MIN (1.0 / 128.0)
+
+float Luma(vec3 color)
+{
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+void main()
+{
+    vec3 rgbNW = texture(image, texCoords + vec2(-1.0, -1.0) * inverseScreenSize).rgb;
+    vec3 rgbNE = texture(image, texCoords + vec2(1.0, -1.0) * inverseScreenSize).rgb;
+    vec3 rgbSW = texture(image, texCoords + vec2(-1.0, 1.0) * inverseScreenSize).rgb;
+    vec3 rgbSE = texture(image, texCoords + vec2(1.0, 1.0) * inverseScreenSize).rgb;
+    vec3 rgbM = texture(image, texCoords).rgb;
+
+    float lumaNW = Luma(rgbNW);
+    float lumaNE = Luma(rgbNE);
+    float lumaSW = Luma(rgbSW);
+    float lumaSE = Luma(rgbSE);
+    float lumaM = Luma(rgbM);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    vec2 direction;
+    direction.x = -((lumaNW + lumaNE) - (lumaSW + lumaSE));
+    direction.y = ((lumaNW + lumaSW) - (lumaNE + lumaSE));
+
+    // Shorter of both gradient components scaled to one texel, flat areas get a tiny span
+    float directionReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * FXAA_REDUCE_MUL), FXAA_REDUCE_MIN);
+    float inverseDirectionMin = 1.0 / (min(abs(direction.x), abs(direction.y)) + directionReduce);
+    direction = clamp(direction * inverseDirectionMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * inverseScreenSize;
+
+    vec3 rgbA = 0.5 * (texture(image, texCoords + direction * (1.0 / 3.0 - 0.5)).rgb +
+                       texture(image, texCoords + direction * (2.0 / 3.0 - 0.5)).rgb);
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (texture(image, texCoords + direction * -0.5).rgb +
+                                     texture(image, texCoords + direction * 0.5).rgb);
+
+    // Wide blur crossed another edge, fall back to the narrow one
+    float lumaB = Luma(rgbB);
+    FragColor = vec4((lumaB < lumaMin || lumaB > lumaMax) ? rgbA : rgbB, 1.0);
+}
\ No newline at end of file
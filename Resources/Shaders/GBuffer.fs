@@ -0,0 +1,40 @@
+#version 330 core
+// Deferred geometry pass( vertex stage is Bloom.vs ). 8 bytes per pixel + depth:
+//  0 : RGBA8 albedo.rgb, alpha unused
+//  1 : RG16  octahedral encoded world normal
+//  2 : RG16F velocity( TAA only, ignored when not attached )
+layout (location = 0) out vec4 GAlbedo;
+layout (location = 1) out vec2 GNormal;
+layout (location = 2) out vec2 Velocity;
+
+in VS_OUT
+{
+    vec3 fragPos;
+    vec3 normal;
+    vec2 texCoords;
+    float viewDepth;
+    vec4 currentClip;
+    vec4 previousClip;
+}fsin;
+
+uniform sampler2D diffuseMap;
+
+vec2 OctWrap(vec2 v)
+{
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Unit vector -> octahedron -> square, [0, 1] for unorm storage
+vec2 EncodeNormal(vec3 normal)
+{
+    normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+    normal.xy = normal.z >= 0.0 ? normal.xy : OctWrap(normal.xy);
+    return normal.xy * 0.5 + 0.5;
+}
+
+void main()
+{
+    GAlbedo = vec4(texture(diffuseMap, fsin.texCoords).rgb, 1.0);
+    GNormal = EncodeNormal(normalize(fsin.normal));
+    Velocity = (fsin.currentClip.xy / fsin.currentClip.w - fsin.previousClip.xy / fsin.previousClip.w) * 0.5;
+}
\ No newline at end of file
@@ -6,42 +6,64 @@ in VS_OUT
     vec3 fragPos;
     vec3 normal;
     vec2 texCoords;
+    float viewDepth;
 }fsin;
 
-struct Light
-{
-    vec3 position;
-    vec3 color;
-};
-
-uniform Light lights[3];
+// Clustered light lists( ClusteredLighting )
+uniform samplerBuffer lightData;     // 2 texels per light: position.xyz + radius, color.rgb
+uniform usamplerBuffer clusterData;  // offset, count into lightIndices per cluster
+uniform usamplerBuffer lightIndices;
+uniform vec3 clusterGrid;
+uniform vec2 clusterScreenSize;
+uniform float clusterDepthScale;
+uniform float clusterDepthBias;
 uniform vec3 viewPos;
 
 uniform sampler2D diffuseMap;
 
-void main()
+// Inverse square falloff windowed to reach zero at the light radius
+float Attenuation(float dist, float radius)
 {
-    vec3 normal = normalize(fsin.normal);
-    vec3 color = texture(diffuseMap, fsin.texCoords).rgb;
+    float ratio = dist / radius;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return window * window / max(dist * dist, 0.0001);
+}
 
-    float ambient = 0.1f;
-    vec3 ambientColor = ambient * color;
+int ClusterIndex(float viewDepth)
+{
+    vec2 tile = clamp(floor(gl_FragCoord.xy / clusterScreenSize * clusterGrid.xy), vec2(0.0), clusterGrid.xy - 1.0);
+    float slice = clamp(floor(log(viewDepth) * clusterDepthScale + clusterDepthBias), 0.0, clusterGrid.z - 1.0);
+    return int((slice * clusterGrid.y + tile.y) * clusterGrid.x + tile.x);
+}
 
+vec3 ShadeClusterLights(vec3 fragPos, vec3 normal, vec3 color, float viewDepth)
+{
     vec3 lightRes = vec3(0.0);
-    for(int idx = 0; idx < 16; ++idx)
+    uvec2 cluster = texelFetch(clusterData, ClusterIndex(viewDepth)).xy;
+    for (uint idx = 0u; idx < cluster.y; ++idx)
     {
-        vec3 lightPos = lights[idx].position;
+        int lightIdx = int(texelFetch(lightIndices, int(cluster.x + idx)).r);
+        vec4 positionRadius = texelFetch(lightData, lightIdx * 2);
+        vec3 lightColor = texelFetch(lightData, lightIdx * 2 + 1).rgb;
 
-        vec3 fragToLight = normalize(lightPos - fsin.fragPos);
+        vec3 fragToLight = normalize(positionRadius.xyz - fragPos);
         float diffuse = max(0.0, dot(fragToLight, normal));
-        vec3 diffuseColor = diffuse * color * lights[idx].color;
-
-        vec3 res = diffuseColor;
-        float dist = length(lightPos - fsin.fragPos);
-        float attenutation = 1.0 / (dist * dist);
-        res *= attenutation;
-        lightRes += res;
+        float dist = length(positionRadius.xyz - fragPos);
+        lightRes += diffuse * color * lightColor * Attenuation(dist, positionRadius.w);
     }
 
+    return lightRes;
+}
+
+void main()
+{
+    vec3 normal = normalize(fsin.normal);
+    vec3 color = texture(diffuseMap, fsin.texCoords).rgb;
+
+    float ambient = 0.1f;
+    vec3 ambientColor = ambient * color;
+
+    vec3 lightRes = ShadeClusterLights(fsin.fragPos, normal, color, fsin.viewDepth);
+
     FragColor = vec4(lightRes + ambientColor, 1.0);
 }
\ No newline at end of file
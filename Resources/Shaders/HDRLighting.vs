@@ -8,6 +8,7 @@ out VS_OUT
     vec3 fragPos;
     vec3 normal;
     vec2 texCoords;
+    float viewDepth;
 }vsout;
 
 uniform mat4 projection;
@@ -18,6 +19,7 @@ void main()
 {
     vsout.fragPos = vec3(model * vec4(aPosition, 1.0));
     vsout.texCoords = aTexCoords;
+    vsout.viewDepth = -(view * model * vec4(aPosition, 1.0)).z;
 
     vsout.normal = mat3(transpose(inverse(model))) * aNormal;
 
@@ -0,0 +1,16 @@
+#version 330 core
+// Downsample fallback( no compute ): log luminance into a mip mapped target, the last mip is the average
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+uniform sampler2D hdrBuffer;
+uniform float minLogLuminance;
+uniform float maxLogLuminance;
+
+void main()
+{
+    float luminance = dot(texture(hdrBuffer, texCoords).rgb, vec3(0.2126, 0.7152, 0.0722));
+    float logLuminance = clamp(log2(max(luminance, 0.0001)), minLogLuminance, maxLogLuminance);
+    FragColor = vec4(logLuminance, 0.0, 0.0, 1.0);
+}
\ No newline at end of file
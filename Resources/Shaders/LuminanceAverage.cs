@@ -0,0 +1,57 @@
+#version 430 core
+#define HISTOGRAM_BINS 256
+
+// Single work group: weighted sum of the histogram by parallel reduction, then temporal adaptation
+layout (local_size_x = HISTOGRAM_BINS) in;
+
+layout (std430, binding = 0) buffer Histogram
+{
+    uint bins[HISTOGRAM_BINS];
+};
+
+layout (r32f, binding = 0) uniform image2D adaptedLuminance;
+
+uniform int pixelCount;
+uniform float minLogLuminance;
+uniform float logLuminanceRange;
+uniform float adaptationFactor; // 1 - exp( -deltaTime * speed ), computed on cpu
+
+shared float weightedBins[HISTOGRAM_BINS];
+
+void main()
+{
+    uint bin = gl_LocalInvocationIndex;
+    uint count = bins[bin];
+    weightedBins[bin] = float(count) * float(bin);
+
+    // Ready for next frame's histogram pass
+    bins[bin] = 0u;
+    barrier();
+
+    for (uint stride = HISTOGRAM_BINS / 2; stride > 0u; stride >>= 1)
+    {
+        if (bin < stride)
+        {
+            weightedBins[bin] += weightedBins[bin + stride];
+        }
+        barrier();
+    }
+
+    if (bin == 0u)
+    {
+        float previous = imageLoad(adaptedLuminance, ivec2(0, 0)).r;
+
+        // Thread 0 holds the black bin count
+        float litPixels = float(pixelCount) - float(count);
+        float target = previous;
+        if (litPixels > 0.0)
+        {
+            float averageBin = weightedBins[0] / litPixels - 1.0;
+            float averageLogLuminance = averageBin / float(HISTOGRAM_BINS - 2) * logLuminanceRange + minLogLuminance;
+            target = exp2(averageLogLuminance);
+        }
+
+        float adapted = previous + (target - previous) * adaptationFactor;
+        imageStore(adaptedLuminance, ivec2(0, 0), vec4(adapted, 0.0, 0.0, 0.0));
+    }
+}
\ No newline at end of file
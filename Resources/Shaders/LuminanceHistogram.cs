@@ -0,0 +1,45 @@
+#version 430 core
+#define HISTOGRAM_BINS 256
+
+// One thread per bin in a work group, so clearing and flushing the local histogram is a single step
+layout (local_size_x = 16, local_size_y = 16) in;
+
+layout (std430, binding = 0) buffer Histogram
+{
+    uint bins[HISTOGRAM_BINS];
+};
+
+uniform sampler2D hdrBuffer;
+uniform float minLogLuminance;
+uniform float inverseLogLuminanceRange;
+
+shared uint localBins[HISTOGRAM_BINS];
+
+// Bin 0 collects( near ) black pixels which are excluded from the average
+uint LuminanceToBin(vec3 color)
+{
+    float luminance = dot(color, vec3(0.2126, 0.7152, 0.0722));
+    if (luminance < 0.0001)
+    {
+        return 0u;
+    }
+
+    float logLuminance = clamp((log2(luminance) - minLogLuminance) * inverseLogLuminanceRange, 0.0, 1.0);
+    return uint(logLuminance * float(HISTOGRAM_BINS - 2) + 1.0);
+}
+
+void main()
+{
+    localBins[gl_LocalInvocationIndex] = 0u;
+    barrier();
+
+    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    if (all(lessThan(coord, textureSize(hdrBuffer, 0))))
+    {
+        atomicAdd(localBins[LuminanceToBin(texelFetch(hdrBuffer, coord, 0).rgb)], 1u);
+    }
+    barrier();
+
+    // Shared memory atomics absorb the contention, global memory only sees one add per bin per group
+    atomicAdd(bins[gl_LocalInvocationIndex], localBins[gl_LocalInvocationIndex]);
+}
\ No newline at end of file
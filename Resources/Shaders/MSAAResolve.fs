@@ -0,0 +1,37 @@
+#version 330 core
+// Custom MSAA resolve. A plain box resolve of HDR samples lets a single very bright sample dominate the
+// pixel, so edges against lights stay aliased after tonemapping. Each sample is weighted by 1 / (1 + luma)
+// ( reinhard tonemap ), averaged, and the weight divided back out( inverse tonemap ), output stays HDR.
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 BrightColor;
+
+uniform sampler2DMS sceneColor;
+uniform sampler2DMS brightColor;
+uniform int sampleCount;
+
+float Luma(vec3 color)
+{
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+vec3 Resolve(sampler2DMS image, ivec2 coord)
+{
+    vec3 sum = vec3(0.0);
+    float weightSum = 0.0;
+    for (int idx = 0; idx < sampleCount; ++idx)
+    {
+        vec3 color = texelFetch(image, coord, idx).rgb;
+        float weight = 1.0 / (1.0 + Luma(color));
+        sum += color * weight;
+        weightSum += weight;
+    }
+
+    return sum / weightSum;
+}
+
+void main()
+{
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+    FragColor = vec4(Resolve(sceneColor, coord), 1.0);
+    BrightColor = vec4(Resolve(brightColor, coord), 1.0);
+}
\ No newline at end of file
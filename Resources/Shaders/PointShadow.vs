@@ -15,6 +15,7 @@ out VS_OUT {
 uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
+uniform mat4 normalMatrix; // Inverse transpose of model, built on the CPU
 
 uniform bool reverse_normals;
 
@@ -22,9 +23,9 @@ void main()
 {
     vs_out.FragPos = vec3(model * vec4(aPos, 1.0));
     if(reverse_normals)
-        vs_out.Normal = transpose(inverse(mat3(model))) * (-1.0 * aNormal);
+        vs_out.Normal = mat3(normalMatrix) * (-1.0 * aNormal);
     else
-        vs_out.Normal = transpose(inverse(mat3(model))) * aNormal;
+        vs_out.Normal = mat3(normalMatrix) * aNormal;
     vs_out.TexCoords = aTexCoords;
     gl_Position = projection * view * model * vec4(aPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 330 core
+in vec3 worldPos;
+
+uniform vec3 lightPos;
+uniform float farPlane;
+
+void main()
+{
+    // Linear distance for both modes, shading compares against the same ratio
+    gl_FragDepth = length(worldPos - lightPos) / farPlane;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#version 330 core
+// Point shadow caster( PointShadowRenderer ), drawn with one instance per face it touches.
+// LAYERED routes every instance to its face layer here, otherwise the face is the bound framebuffer.
+#ifdef LAYERED
+#ifdef AMD_LAYER
+#extension GL_AMD_vertex_shader_layer : require
+#else
+#extension GL_ARB_shader_viewport_layer_array : require
+#endif
+#endif
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+uniform mat4 faceMatrices[6];  // cube: view projection per face, paraboloid: [0] = paraboloid view
+uniform int faceLayers[6];     // visible faces of this caster, indexed by instance
+uniform int layerBase;         // first layer of the light's slot
+uniform float farPlane;
+
+out vec3 worldPos;
+
+void main()
+{
+    int face = faceLayers[gl_InstanceID];
+    vec4 position = model * vec4(aPos, 1.0);
+    worldPos = position.xyz;
+#ifdef LAYERED
+    gl_Layer = layerBase + face;
+#endif
+
+#ifdef PARABOLOID
+    // Hemisphere 0 looks down -z of the paraboloid view, hemisphere 1 down +z
+    vec3 viewPos = (faceMatrices[0] * position).xyz;
+    float dist = length(viewPos);
+    vec3 dir = viewPos / dist;
+    float dz = (face == 0) ? -dir.z : dir.z;
+    gl_ClipDistance[0] = dz;
+    gl_Position = vec4(dir.xy / (1.0 + dz), dist / farPlane * 2.0 - 1.0, 1.0);
+#else
+    gl_Position = faceMatrices[face] * position;
+#endif
+}
\ No newline at end of file
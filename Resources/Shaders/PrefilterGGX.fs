@@ -0,0 +1,93 @@
+#version 330 core
+// GGX prefiltered radiance of one cube face at one roughness( PrefilteredEnvironment ), first term of the split sum.
+// Assumes N = V = R. Each sample reads the source mip matching its solid angle( filtered importance sampling ),
+// so a few hundred samples converge without fireflies from bright texels.
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+uniform samplerCube environmentMap;
+uniform int face;
+uniform float roughness;
+uniform float sourceResolution;  // face size of environmentMap mip 0
+uniform float faceResolution;    // face size of the target mip
+uniform int sampleCount;
+
+const float PI = 3.14159265359;
+
+// OpenGL cube map table, t = 0 is the first row of the face
+vec3 FaceDirection(vec2 uv)
+{
+    vec2 st = uv * 2.0 - 1.0;
+    if (face == 0) return normalize(vec3(1.0, -st.y, -st.x));
+    if (face == 1) return normalize(vec3(-1.0, -st.y, st.x));
+    if (face == 2) return normalize(vec3(st.x, 1.0, st.y));
+    if (face == 3) return normalize(vec3(st.x, -1.0, -st.y));
+    if (face == 4) return normalize(vec3(st.x, -st.y, 1.0));
+    return normalize(vec3(-st.x, -st.y, -1.0));
+}
+
+vec2 Hammersley(uint idx, uint count)
+{
+    uint bits = idx;
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return vec2(float(idx) / float(count), float(bits) * 2.3283064365386963e-10);
+}
+
+vec3 ImportanceSampleGGX(vec2 xi, vec3 N, float alpha)
+{
+    float phi = 2.0 * PI * xi.x;
+    float cosTheta = sqrt((1.0 - xi.y) / (1.0 + (alpha * alpha - 1.0) * xi.y));
+    float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    vec3 H = vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+
+    vec3 up = (abs(N.z) < 0.999) ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
+    vec3 tangent = normalize(cross(up, N));
+    vec3 bitangent = cross(N, tangent);
+    return normalize(tangent * H.x + bitangent * H.y + N * H.z);
+}
+
+float DistributionGGX(float NdotH, float alpha)
+{
+    float alphaSq = alpha * alpha;
+    float denom = NdotH * NdotH * (alphaSq - 1.0) + 1.0;
+    return alphaSq / (PI * denom * denom);
+}
+
+void main()
+{
+    vec3 N = FaceDirection(texCoords);
+    if (roughness <= 0.0)
+    {
+        // Mirror: plain downsample to the target size
+        FragColor = vec4(textureLod(environmentMap, N, log2(sourceResolution / faceResolution)).rgb, 1.0);
+        return;
+    }
+
+    float alpha = roughness * roughness;
+    float texelSolidAngle = 4.0 * PI / (6.0 * sourceResolution * sourceResolution);
+
+    vec3 result = vec3(0.0);
+    float totalWeight = 0.0;
+    for (int idx = 0; idx < sampleCount; ++idx)
+    {
+        vec3 H = ImportanceSampleGGX(Hammersley(uint(idx), uint(sampleCount)), N, alpha);
+        vec3 L = normalize(2.0 * dot(N, H) * H - N);
+        float NdotL = dot(N, L);
+        if (NdotL > 0.0)
+        {
+            // pdf = D * NdotH / ( 4 * VdotH ) = D / 4 with N = V
+            float pdf = DistributionGGX(max(dot(N, H), 0.0), alpha) * 0.25;
+            float sampleSolidAngle = 1.0 / (float(sampleCount) * pdf + 0.0001);
+            float lod = max(0.5 * log2(sampleSolidAngle / texelSolidAngle), 0.0);
+            result += textureLod(environmentMap, L, lod).rgb * NdotL;
+            totalWeight += NdotL;
+        }
+    }
+
+    FragColor = vec4(result / max(totalWeight, 0.0001), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,277 @@
+// Scene lighting shared by the forward( Bloom.fs ) and deferred( DeferredLighting.fs ) paths, expanded by Shader.
+// The includer defines SHADOW_FILTER and POINT_SHADOW_MODE first.
+
+// Clustered light lists( ClusteredLighting )
+uniform samplerBuffer lightData;     // 2 texels per light: position.xyz + radius, color.rgb + shadow slot
+uniform usamplerBuffer clusterData;  // offset, count into lightIndices per cluster
+uniform usamplerBuffer lightIndices;
+uniform vec3 clusterGrid;
+uniform vec2 clusterScreenSize;
+uniform float clusterDepthScale;
+uniform float clusterDepthBias;
+
+// Point light shadows( PointShadowRenderer ), slot of the light is lightData color.w( -1 = unshadowed )
+uniform sampler2DArrayShadow pointShadowMaps;  // 6 layers per slot
+
+// Cascaded sun shadow( CascadedShadowMap )
+const int CascadeCount = 4;
+uniform sampler2DArrayShadow cascadeShadowMap;
+uniform mat4 cascadeMatrices[CascadeCount];
+uniform float cascadeSplits[CascadeCount];     // far view depth of each cascade
+uniform float cascadeTexelSizes[CascadeCount]; // world size of one shadow texel
+uniform float cascadeBlendBand;
+uniform vec3 sunDirection;                     // direction the light travels in
+uniform vec3 sunColor;
+
+// Diffuse ambient( IrradianceSH ), L2 coefficients already convolved with the cosine lobe
+uniform vec3 ambientSH[9];
+
+// Specular ambient( PrefilteredEnvironment ), split sum: prefiltered radiance * ( F0 * scale + bias )
+uniform samplerCube prefilteredMap;
+uniform sampler2D brdfLut;
+uniform float prefilterMaxLod;
+uniform float environmentIntensity;
+const float EnvironmentRoughness = 0.4;        // materials have no roughness yet
+const vec3 EnvironmentF0 = vec3(0.04);         // dielectric
+
+// Shadow filter tier( ShadowFilter ), shared by sun and point shadows
+// 0 = hardware 2x2, 1 = poisson disk, 2 = optimized 5x5 PCF, 3 = EVSM( point shadows use optimized PCF )
+uniform float shadowFilterRadius;              // poisson disk radius in shadow texels
+uniform sampler2DArray cascadeMoments;         // pre blurred EVSM moments
+uniform vec2 evsmExponents;
+uniform float evsmBleedReduction;
+
+const vec2 PoissonDisk[16] = vec2[](
+    vec2(-0.94201624, -0.39906216), vec2(0.94558609, -0.76890725), vec2(-0.09418410, -0.92938870), vec2(0.34495938, 0.29387760),
+    vec2(-0.91588581, 0.45771432), vec2(-0.81544232, -0.87912464), vec2(-0.38277543, 0.27676845), vec2(0.97484398, 0.75648379),
+    vec2(0.44323325, -0.97511554), vec2(0.53742981, -0.47373420), vec2(-0.26496911, -0.41893023), vec2(0.79197514, 0.19090188),
+    vec2(-0.24188840, 0.99706507), vec2(-0.81409955, 0.91437590), vec2(0.19984126, 0.78641367), vec2(0.14383161, -0.14100790));
+
+// Inverse square falloff windowed to reach zero at the light radius
+float Attenuation(float dist, float radius)
+{
+    float ratio = dist / radius;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return window * window / max(dist * dist, 0.0001);
+}
+
+int ClusterIndex(float viewDepth)
+{
+    vec2 tile = clamp(floor(gl_FragCoord.xy / clusterScreenSize * clusterGrid.xy), vec2(0.0), clusterGrid.xy - 1.0);
+    float slice = clamp(floor(log(viewDepth) * clusterDepthScale + clusterDepthBias), 0.0, clusterGrid.z - 1.0);
+    return int((slice * clusterGrid.y + tile.y) * clusterGrid.x + tile.x);
+}
+
+// Layer and uv of a cube map lookup( OpenGL major axis table ), faces are stored as array layers
+vec3 CubeFaceCoords(vec3 dir)
+{
+    vec3 absDir = abs(dir);
+    if (absDir.x >= absDir.y && absDir.x >= absDir.z)
+    {
+        return (dir.x > 0.0) ? vec3(vec2(-dir.z, -dir.y) / absDir.x * 0.5 + 0.5, 0.0)
+                             : vec3(vec2(dir.z, -dir.y) / absDir.x * 0.5 + 0.5, 1.0);
+    }
+    if (absDir.y >= absDir.z)
+    {
+        return (dir.y > 0.0) ? vec3(vec2(dir.x, dir.z) / absDir.y * 0.5 + 0.5, 2.0)
+                             : vec3(vec2(dir.x, -dir.z) / absDir.y * 0.5 + 0.5, 3.0);
+    }
+    return (dir.z > 0.0) ? vec3(vec2(dir.x, -dir.y) / absDir.z * 0.5 + 0.5, 4.0)
+                         : vec3(vec2(-dir.x, -dir.y) / absDir.z * 0.5 + 0.5, 5.0);
+}
+
+float InterleavedGradientNoise(vec2 pixel)
+{
+    return fract(52.9829189 * fract(dot(pixel, vec2(0.06711056, 0.00583715))));
+}
+
+// Every tap is a bilinear comparison, the disk is rotated per pixel so under sampling turns into noise( resolved by TAA )
+float PoissonPCF(sampler2DArrayShadow shadowMap, vec4 coords, vec2 texelSize)
+{
+    float angle = InterleavedGradientNoise(gl_FragCoord.xy) * 6.2831853;
+    vec2 rotation = vec2(cos(angle), sin(angle));
+    vec2 scale = texelSize * shadowFilterRadius;
+
+    float visibility = 0.0;
+    for (int idx = 0; idx < 16; ++idx)
+    {
+        vec2 offset = vec2(PoissonDisk[idx].x * rotation.x - PoissonDisk[idx].y * rotation.y,
+                           PoissonDisk[idx].x * rotation.y + PoissonDisk[idx].y * rotation.x);
+        visibility += texture(shadowMap, vec4(coords.xy + offset * scale, coords.zw));
+    }
+
+    return visibility / 16.0;
+}
+
+// 5x5 tent filter out of 9 bilinear comparison taps( The Witness style gather PCF ): every tap is moved inside its
+// 2x2 footprint and weighted so that the hardware weights add up to the tent weights of all 25 texels.
+float OptimizedPCF(sampler2DArrayShadow shadowMap, vec4 coords, vec2 mapSize)
+{
+    vec2 uv = coords.xy * mapSize;
+    vec2 baseUV = floor(uv + 0.5);
+    vec2 st = uv + 0.5 - baseUV;
+    baseUV = (baseUV - 0.5) / mapSize;
+
+    vec3 uw = vec3(4.0 - 3.0 * st.x, 7.0, 1.0 + 3.0 * st.x);
+    vec3 u = vec3((3.0 - 2.0 * st.x) / uw.x - 2.0, (3.0 + st.x) / uw.y, st.x / uw.z + 2.0);
+    vec3 vw = vec3(4.0 - 3.0 * st.y, 7.0, 1.0 + 3.0 * st.y);
+    vec3 v = vec3((3.0 - 2.0 * st.y) / vw.x - 2.0, (3.0 + st.y) / vw.y, st.y / vw.z + 2.0);
+
+    float visibility = 0.0;
+    for (int y = 0; y < 3; ++y)
+    {
+        for (int x = 0; x < 3; ++x)
+        {
+            visibility += uw[x] * vw[y] * texture(shadowMap, vec4(baseUV + vec2(u[x], v[y]) / mapSize, coords.zw));
+        }
+    }
+
+    return visibility / 144.0;
+}
+
+// coords: uv, layer, reference depth
+float FilterShadow(sampler2DArrayShadow shadowMap, vec4 coords)
+{
+#if SHADOW_FILTER == 1
+    return PoissonPCF(shadowMap, coords, 1.0 / vec2(textureSize(shadowMap, 0).xy));
+#elif SHADOW_FILTER >= 2
+    return OptimizedPCF(shadowMap, coords, vec2(textureSize(shadowMap, 0).xy));
+#else
+    return texture(shadowMap, coords);
+#endif
+}
+
+float PointShadow(vec3 fragPos, vec3 normal, vec4 positionRadius, int slot)
+{
+    vec3 offsetPos = fragPos + normal * 0.02;
+    vec3 dir = offsetPos - positionRadius.xyz;
+    float reference = length(dir) / positionRadius.w - 0.002;
+
+#if POINT_SHADOW_MODE == 0
+    vec3 coords = CubeFaceCoords(dir);
+#else
+    // Paraboloid view: looks down -y with +z up
+    vec3 viewDir = normalize(vec3(-dir.x, dir.z, dir.y));
+    vec3 coords = vec3(viewDir.xy / (1.0 + abs(viewDir.z)) * 0.5 + 0.5, (viewDir.z <= 0.0) ? 0.0 : 1.0);
+#endif
+
+    return FilterShadow(pointShadowMaps, vec4(coords.xy, float(slot * 6) + coords.z, reference));
+}
+
+// One sided Chebyshev upper bound, the tail below the bleed reduction threshold is cut to hide light bleeding
+float Chebyshev(vec2 moments, float mean, float minVariance)
+{
+    float variance = max(moments.y - moments.x * moments.x, minVariance);
+    float delta = mean - moments.x;
+    float pMax = variance / (variance + delta * delta);
+    pMax = clamp((pMax - evsmBleedReduction) / (1.0 - evsmBleedReduction), 0.0, 1.0);
+    return (mean <= moments.x) ? 1.0 : pMax;
+}
+
+float EVSM(vec3 uvLayer, float depth)
+{
+    vec4 moments = texture(cascadeMoments, uvLayer);
+    float warpDepth = clamp(depth, 0.0, 1.0) * 2.0 - 1.0;
+    vec2 warped = vec2(exp(evsmExponents.x * warpDepth), -exp(-evsmExponents.y * warpDepth));
+
+    // Minimum variance follows the warp derivative so it is the same in depth units for both moments
+    vec2 depthScale = 0.0001 * evsmExponents * abs(warped);
+    vec2 minVariance = depthScale * depthScale;
+    return min(Chebyshev(moments.xy, warped.x, minVariance.x), Chebyshev(moments.zw, warped.y, minVariance.y));
+}
+
+// Irradiance / pi around the normal, albedo times this is the diffuse ambient
+vec3 AmbientIrradiance(vec3 n)
+{
+    vec3 result = ambientSH[0] * 0.282095;
+    result += (ambientSH[1] * n.y + ambientSH[2] * n.z + ambientSH[3] * n.x) * 0.488603;
+    result += (ambientSH[4] * n.x * n.y + ambientSH[5] * n.y * n.z + ambientSH[7] * n.x * n.z) * 1.092548;
+    result += ambientSH[6] * 0.315392 * (3.0 * n.z * n.z - 1.0);
+    result += ambientSH[8] * 0.546274 * (n.x * n.x - n.y * n.y);
+
+    // Band limited lobes ring slightly negative opposite to bright light
+    return max(result, vec3(0.0));
+}
+
+vec3 AmbientSpecular(vec3 normal, vec3 viewDir)
+{
+    float NdotV = max(dot(normal, viewDir), 0.0);
+    vec3 radiance = textureLod(prefilteredMap, reflect(-viewDir, normal), EnvironmentRoughness * prefilterMaxLod).rgb;
+    vec2 brdf = texture(brdfLut, vec2(NdotV, EnvironmentRoughness)).rg;
+    return radiance * (EnvironmentF0 * brdf.x + brdf.y) * environmentIntensity;
+}
+
+vec3 ShadeClusterLights(vec3 fragPos, vec3 normal, vec3 color, float viewDepth)
+{
+    vec3 lightRes = vec3(0.0);
+    uvec2 cluster = texelFetch(clusterData, ClusterIndex(viewDepth)).xy;
+    for (uint idx = 0u; idx < cluster.y; ++idx)
+    {
+        int lightIdx = int(texelFetch(lightIndices, int(cluster.x + idx)).r);
+        vec4 positionRadius = texelFetch(lightData, lightIdx * 2);
+        vec4 colorShadowSlot = texelFetch(lightData, lightIdx * 2 + 1);
+        vec3 lightColor = colorShadowSlot.rgb;
+        int shadowSlot = int(colorShadowSlot.w);
+
+        vec3 fragToLight = normalize(positionRadius.xyz - fragPos);
+        float diffuse = max(0.0, dot(fragToLight, normal));
+        float dist = length(positionRadius.xyz - fragPos);
+        float shadow = (shadowSlot >= 0) ? PointShadow(fragPos, normal, positionRadius, shadowSlot) : 1.0;
+        lightRes += diffuse * color * lightColor * Attenuation(dist, positionRadius.w) * shadow;
+    }
+
+    return lightRes;
+}
+
+float SampleCascade(int cascade, vec3 fragPos, vec3 normal)
+{
+    // Normal offset scaled by the texel footprint removes acne without a large depth bias, wider kernels need more
+#if SHADOW_FILTER == 1 || SHADOW_FILTER == 2
+    const float OffsetTexels = 2.5;
+#else
+    const float OffsetTexels = 1.5;
+#endif
+    vec3 offsetPos = fragPos + normal * cascadeTexelSizes[cascade] * OffsetTexels;
+    vec3 coords = (cascadeMatrices[cascade] * vec4(offsetPos, 1.0)).xyz * 0.5 + 0.5;
+#if SHADOW_FILTER == 3
+    return EVSM(vec3(coords.xy, float(cascade)), coords.z);
+#else
+    return FilterShadow(cascadeShadowMap, vec4(coords.xy, float(cascade), coords.z - 0.0005));
+#endif
+}
+
+float SunShadow(vec3 fragPos, vec3 normal, float viewDepth)
+{
+    int cascade = 0;
+    while (cascade < CascadeCount && viewDepth > cascadeSplits[cascade])
+    {
+        ++cascade;
+    }
+    if (cascade >= CascadeCount)
+    {
+        return 1.0;
+    }
+
+    // Cross fade into the next cascade( or no shadow after the last ) over the end of this one
+    float visibility = SampleCascade(cascade, fragPos, normal);
+    float cascadeStart = (cascade == 0) ? 0.0 : cascadeSplits[cascade - 1];
+    float blendStart = cascadeSplits[cascade] - (cascadeSplits[cascade] - cascadeStart) * cascadeBlendBand;
+    if (viewDepth > blendStart)
+    {
+        float next = (cascade + 1 < CascadeCount) ? SampleCascade(cascade + 1, fragPos, normal) : 1.0;
+        visibility = mix(visibility, next, (viewDepth - blendStart) / (cascadeSplits[cascade] - blendStart));
+    }
+
+    return visibility;
+}
+
+vec3 ShadeSun(vec3 fragPos, vec3 normal, vec3 color, float viewDepth)
+{
+    float diffuse = max(0.0, dot(-sunDirection, normal));
+    if (diffuse <= 0.0)
+    {
+        return vec3(0.0);
+    }
+
+    return diffuse * color * sunColor * SunShadow(fragPos, normal, viewDepth);
+}
\ No newline at end of file
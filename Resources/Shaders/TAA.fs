@@ -0,0 +1,132 @@
+#version 330 core
+// Temporal anti aliasing resolve with upsampling.
+// Current frame( render resolution, jittered ) is reconstructed at the output pixel from its 3x3 neighbourhood,
+// history( output resolution ) is reprojected with the velocity of the closest surface, clamped to the
+// neighbourhood color distribution and blended in.
+out vec4 FragColor;
+
+uniform sampler2D currentColor;
+uniform sampler2D velocityBuffer;
+uniform sampler2D depthBuffer;
+uniform sampler2D history;
+
+uniform vec2 jitter;        // pixels, projection offset of the current frame
+uniform vec2 renderSize;
+uniform vec2 outputSize;
+uniform float blendFactor;  // weight of the current frame
+uniform bool historyValid;
+
+vec3 RGBToYCoCg(vec3 color)
+{
+    return vec3(0.25 * color.r + 0.5 * color.g + 0.25 * color.b,
+                0.5 * color.r - 0.5 * color.b,
+                -0.25 * color.r + 0.5 * color.g - 0.25 * color.b);
+}
+
+vec3 YCoCgToRGB(vec3 color)
+{
+    return vec3(color.x + color.y - color.z, color.x + color.z, color.x - color.y - color.z);
+}
+
+float Luma(vec3 color)
+{
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+// Blackman-Harris window approximated by a gaussian, distance in render pixels
+float ReconstructionWeight(vec2 offset)
+{
+    return exp(-2.29 * dot(offset, offset));
+}
+
+// Bicubic( Catmull-Rom ) with 5 bilinear fetches, keeps the history sharp under subpixel motion
+vec3 SampleHistory(vec2 uv)
+{
+    vec2 samplePos = uv * outputSize;
+    vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+    vec2 f = samplePos - texPos1;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+    vec2 w12 = w1 + w2;
+    vec2 texPos0 = (texPos1 - 1.0) / outputSize;
+    vec2 texPos3 = (texPos1 + 2.0) / outputSize;
+    vec2 texPos12 = (texPos1 + w2 / w12) / outputSize;
+
+    vec3 result = texture(history, vec2(texPos12.x, texPos0.y)).rgb * w12.x * w0.y;
+    result += texture(history, vec2(texPos0.x, texPos12.y)).rgb * w0.x * w12.y;
+    result += texture(history, texPos12).rgb * w12.x * w12.y;
+    result += texture(history, vec2(texPos3.x, texPos12.y)).rgb * w3.x * w12.y;
+    result += texture(history, vec2(texPos12.x, texPos3.y)).rgb * w12.x * w3.y;
+
+    float weightSum = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+    return max(result / weightSum, vec3(0.0));
+}
+
+void main()
+{
+    vec2 uv = gl_FragCoord.xy / outputSize;
+
+    // Output pixel center in render pixels. Sample of render texel k was taken at k + 0.5 - jitter.
+    vec2 renderPos = uv * renderSize;
+    ivec2 center = ivec2(floor(renderPos + jitter));
+    ivec2 maxCoord = ivec2(renderSize) - 1;
+
+    vec3 colorSum = vec3(0.0);
+    float weightSum = 0.0;
+    vec3 moment1 = vec3(0.0);
+    vec3 moment2 = vec3(0.0);
+    float closestDepth = 1.0;
+    ivec2 closestCoord = center;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            ivec2 coord = clamp(center + ivec2(x, y), ivec2(0), maxCoord);
+            vec3 color = texelFetch(currentColor, coord, 0).rgb;
+
+            // Tonemap weighted so single bright samples do not ring
+            float weight = ReconstructionWeight(vec2(coord) + 0.5 - jitter - renderPos) / (1.0 + Luma(color));
+            colorSum += color * weight;
+            weightSum += weight;
+
+            vec3 ycocg = RGBToYCoCg(color);
+            moment1 += ycocg;
+            moment2 += ycocg * ycocg;
+
+            float depth = texelFetch(depthBuffer, coord, 0).r;
+            if (depth < closestDepth)
+            {
+                closestDepth = depth;
+                closestCoord = coord;
+            }
+        }
+    }
+    vec3 current = colorSum / max(weightSum, 0.0001);
+
+    // Velocity of the closest surface keeps silhouettes from smearing over the background
+    vec2 historyUV = uv - texelFetch(velocityBuffer, closestCoord, 0).xy;
+    if (!historyValid || any(lessThan(historyUV, vec2(0.0))) || any(greaterThan(historyUV, vec2(1.0))))
+    {
+        FragColor = vec4(current, 1.0);
+        return;
+    }
+
+    // Variance clipping box in YCoCg
+    vec3 mean = moment1 / 9.0;
+    vec3 deviation = sqrt(max(moment2 / 9.0 - mean * mean, vec3(0.0)));
+    vec3 boxMin = mean - 1.25 * deviation;
+    vec3 boxMax = mean + 1.25 * deviation;
+    vec3 historyColor = YCoCgToRGB(clamp(RGBToYCoCg(SampleHistory(historyUV)), boxMin, boxMax));
+
+    // When upsampling most output pixels have no nearby sample this frame, trust history more for those
+    float confidence = ReconstructionWeight(vec2(center) + 0.5 - jitter - renderPos);
+    float alpha = blendFactor * max(confidence, 0.1);
+
+    float currentWeight = alpha / (1.0 + Luma(current));
+    float historyWeight = (1.0 - alpha) / (1.0 + Luma(historyColor));
+    FragColor = vec4((current * currentWeight + historyColor * historyWeight) / (currentWeight + historyWeight), 1.0);
+}
\ No newline at end of file
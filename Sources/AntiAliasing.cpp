@@ -0,0 +1,75 @@
+#include "AntiAliasing.h"
+#include "Primitives.h"
+
+#include <algorithm>
+
+const char* ToString( AntiAliasingMode mode )
+{
+   switch ( mode )
+   {
+   case AntiAliasingMode::None:
+      return "None";
+   case AntiAliasingMode::MSAA:
+      return "MSAA";
+   case AntiAliasingMode::FXAA:
+      return "FXAA";
+   case AntiAliasingMode::TAA:
+      return "TAA";
+   default:
+      break;
+   }
+
+   return "Unknown";
+}
+
+AntiAliasing::AntiAliasing( ) :
+   m_resolveShader( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/MSAAResolve.fs" ),
+   m_fxaaShader( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/FXAA.fs" )
+{
+   m_resolveShader.Use( );
+   m_resolveShader.SetInt( "sceneColor", 0 );
+   m_resolveShader.SetInt( "brightColor", 1 );
+   m_fxaaShader.Use( );
+   m_fxaaShader.SetInt( "image", 0 );
+}
+
+unsigned int AntiAliasing::GetMaxSamples( )
+{
+   GLint maxColorSamples = 1;
+   GLint maxDepthSamples = 1;
+   glGetIntegerv( GL_MAX_COLOR_TEXTURE_SAMPLES, &maxColorSamples );
+   glGetIntegerv( GL_MAX_DEPTH_TEXTURE_SAMPLES, &maxDepthSamples );
+   return static_cast<unsigned int>( std::max( 1, std::min( maxColorSamples, maxDepthSamples ) ) );
+}
+
+void AntiAliasing::Resolve( unsigned int sceneColor, unsigned int brightColor, unsigned int samples )
+{
+   m_resolveShader.Use( );
+   m_resolveShader.SetInt( "sampleCount", samples );
+
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D_MULTISAMPLE, sceneColor );
+   glActiveTexture( GL_TEXTURE1 );
+   glBindTexture( GL_TEXTURE_2D_MULTISAMPLE, brightColor );
+
+   glDisable( GL_DEPTH_TEST );
+   renderQuad( );
+   glEnable( GL_DEPTH_TEST );
+
+   glBindTexture( GL_TEXTURE_2D_MULTISAMPLE, 0 );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D_MULTISAMPLE, 0 );
+}
+
+void AntiAliasing::ApplyFXAA( unsigned int ldrTexture, unsigned int width, unsigned int height )
+{
+   m_fxaaShader.Use( );
+   m_fxaaShader.SetVec2f( "inverseScreenSize", glm::vec2( 1.0f / width, 1.0f / height ) );
+
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D, ldrTexture );
+
+   glDisable( GL_DEPTH_TEST );
+   renderQuad( );
+   glEnable( GL_DEPTH_TEST );
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include "Shader.h"
+
+enum class AntiAliasingMode
+{
+   None = 0,
+   MSAA,    // Multisampled scene targets + MSAAResolve.fs
+   FXAA,    // Post process on composite output
+   TAA,     // Jittered scene + TemporalAA resolve, optionally upsampling
+   EnumMax
+};
+
+const char* ToString( AntiAliasingMode mode );
+
+// Resolve and post process passes for the anti aliasing modes, render targets come from the frame graph.
+class AntiAliasing
+{
+public:
+   AntiAliasing( );
+
+   // Highest sample count usable for both color and depth textures.
+   static unsigned int GetMaxSamples( );
+
+   // Writes resolved HDR scene color( location 0 ) and bright color( location 1 ) into currently bound framebuffer.
+   // Samples are tonemap weighted before averaging, see MSAAResolve.fs.
+   void Resolve( unsigned int sceneColor, unsigned int brightColor, unsigned int samples );
+
+   // Renders FXAA of 'ldrTexture'( width x height ) into currently bound framebuffer.
+   void ApplyFXAA( unsigned int ldrTexture, unsigned int width, unsigned int height );
+
+private:
+   Shader m_resolveShader;
+   Shader m_fxaaShader;
+
+};
\ No newline at end of file
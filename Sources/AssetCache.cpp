@@ -0,0 +1,37 @@
+#include "AssetCache.h"
+
+#include <sys/stat.h>
+
+namespace
+{
+   bool ModificationTime( const std::string& path, time_t& time )
+   {
+      struct stat info;
+      if ( stat( path.c_str( ), &info ) != 0 )
+      {
+         return false;
+      }
+      time = info.st_mtime;
+      return true;
+   }
+}
+
+bool IsCacheFresh( const std::string& cachePath, const std::vector<std::string>& sources )
+{
+   time_t cacheTime;
+   if ( !ModificationTime( cachePath, cacheTime ) )
+   {
+      return false;
+   }
+
+   for ( const auto& source : sources )
+   {
+      time_t sourceTime;
+      if ( ModificationTime( source, sourceTime ) && sourceTime > cacheTime )
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Baked data stored next to its source assets is reused while it is not older than any source.
+// Missing sources are ignored, a missing cache is never fresh.
+bool IsCacheFresh( const std::string& cachePath, const std::vector<std::string>& sources );
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "AutoExposure.h"
+#include "Primitives.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+   unsigned int CreateLuminanceTexture( unsigned int size, GLenum internalFormat, bool mipmapped )
+   {
+      unsigned int texture;
+      glGenTextures( 1, &texture );
+      glBindTexture( GL_TEXTURE_2D, texture );
+      glTexImage2D( GL_TEXTURE_2D, 0, internalFormat, size, size, 0, GL_RED, GL_FLOAT, nullptr );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_NEAREST : GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mipmapped ? GL_LINEAR : GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+      if ( mipmapped )
+      {
+         glGenerateMipmap( GL_TEXTURE_2D );
+      }
+      glBindTexture( GL_TEXTURE_2D, 0 );
+      return texture;
+   }
+
+   unsigned int CreateFramebuffer( unsigned int texture )
+   {
+      unsigned int fbo;
+      glGenFramebuffers( 1, &fbo );
+      glBindFramebuffer( GL_FRAMEBUFFER, fbo );
+      glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0 );
+      if ( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+      {
+         std::cout << "Auto exposure framebuffer not complete!" << std::endl;
+      }
+      glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+      return fbo;
+   }
+}
+
+AutoExposure::AutoExposure( ) :
+   m_histogramBuffer( 0 ),
+   m_logLuminanceTexture( 0 ),
+   m_logLuminanceFBO( 0 ),
+   m_adaptFBO{ 0, 0 },
+   m_current( 0 )
+{
+   // Start from mid grey so the first frames do not flash
+   const float initialLuminance = 0.18f;
+   for ( unsigned int& texture : m_adaptedLuminance )
+   {
+      texture = CreateLuminanceTexture( 1, GL_R32F, false );
+      glBindTexture( GL_TEXTURE_2D, texture );
+      glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RED, GL_FLOAT, &initialLuminance );
+   }
+   glBindTexture( GL_TEXTURE_2D, 0 );
+
+   if ( IsComputeSupported( ) )
+   {
+      m_histogramShader = std::make_unique<Shader>( "../Resources/Shaders/LuminanceHistogram.cs" );
+      m_averageShader = std::make_unique<Shader>( "../Resources/Shaders/LuminanceAverage.cs" );
+      m_histogramShader->Use( );
+      m_histogramShader->SetInt( "hdrBuffer", 0 );
+
+      std::vector<unsigned int> zeros( HistogramBins, 0 );
+      glGenBuffers( 1, &m_histogramBuffer );
+      glBindBuffer( GL_SHADER_STORAGE_BUFFER, m_histogramBuffer );
+      glBufferData( GL_SHADER_STORAGE_BUFFER, HistogramBins * sizeof( unsigned int ), zeros.data( ), GL_DYNAMIC_COPY );
+      glBindBuffer( GL_SHADER_STORAGE_BUFFER, 0 );
+   }
+   else
+   {
+      m_logLuminanceShader = std::make_unique<Shader>( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/LogLuminance.fs" );
+      m_adaptShader = std::make_unique<Shader>( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/ExposureAdapt.fs" );
+      m_logLuminanceShader->Use( );
+      m_logLuminanceShader->SetInt( "hdrBuffer", 0 );
+      m_adaptShader->Use( );
+      m_adaptShader->SetInt( "logLuminance", 0 );
+      m_adaptShader->SetInt( "previousLuminance", 1 );
+
+      m_logLuminanceTexture = CreateLuminanceTexture( DownsampleSize, GL_R16F, true );
+      m_logLuminanceFBO = CreateFramebuffer( m_logLuminanceTexture );
+      for ( unsigned int idx = 0; idx < 2; ++idx )
+      {
+         m_adaptFBO[ idx ] = CreateFramebuffer( m_adaptedLuminance[ idx ] );
+      }
+   }
+}
+
+AutoExposure::~AutoExposure( )
+{
+   glDeleteTextures( 2, m_adaptedLuminance );
+   if ( m_histogramBuffer != 0 )
+   {
+      glDeleteBuffers( 1, &m_histogramBuffer );
+   }
+   if ( m_logLuminanceTexture != 0 )
+   {
+      glDeleteFramebuffers( 1, &m_logLuminanceFBO );
+      glDeleteFramebuffers( 2, m_adaptFBO );
+      glDeleteTextures( 1, &m_logLuminanceTexture );
+   }
+}
+
+bool AutoExposure::IsComputeSupported( )
+{
+   return GLAD_GL_VERSION_4_3 != 0;
+}
+
+FrameGraphResource AutoExposure::AddPass( FrameGraph& frameGraph, FrameGraphResource hdrColor, float deltaTime )
+{
+   // Frame rate independent exponential adaptation
+   float adaptationFactor = 1.0f - std::exp( -std::max( deltaTime, 0.0f ) * m_settings.AdaptationSpeed );
+
+   // Downsample path writes the other texture and reads the previous result
+   if ( m_histogramShader == nullptr )
+   {
+      m_current = 1 - m_current;
+   }
+
+   FrameGraphResource adapted = frameGraph.Import( "Adapted Luminance", m_adaptedLuminance[ m_current ], 1, 1 );
+   frameGraph.AddPass( "Auto Exposure",
+                       [ & ]( FrameGraphBuilder& builder )
+   {
+      builder.Read( hdrColor );
+      builder.Write( adapted );
+   },
+                       [ this, hdrColor, adaptationFactor ]( const FrameGraphPassContext& context )
+   {
+      if ( m_histogramShader != nullptr )
+      {
+         ExecuteCompute( context.GetTexture( hdrColor ), context.GetWidth( hdrColor ), context.GetHeight( hdrColor ), adaptationFactor );
+      }
+      else
+      {
+         ExecuteDownsample( context.GetTexture( hdrColor ), adaptationFactor );
+      }
+   } );
+
+   return adapted;
+}
+
+void AutoExposure::ExecuteCompute( unsigned int hdrTexture, unsigned int width, unsigned int height, float adaptationFactor )
+{
+   float logLuminanceRange = m_settings.MaxLogLuminance - m_settings.MinLogLuminance;
+   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 0, m_histogramBuffer );
+
+   m_histogramShader->Use( );
+   m_histogramShader->SetFloat( "minLogLuminance", m_settings.MinLogLuminance );
+   m_histogramShader->SetFloat( "inverseLogLuminanceRange", 1.0f / logLuminanceRange );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D, hdrTexture );
+   glDispatchCompute( ( width + HistogramGroupSize - 1 ) / HistogramGroupSize, ( height + HistogramGroupSize - 1 ) / HistogramGroupSize, 1 );
+   glMemoryBarrier( GL_SHADER_STORAGE_BARRIER_BIT );
+
+   m_averageShader->Use( );
+   m_averageShader->SetInt( "pixelCount", static_cast<int>( width * height ) );
+   m_averageShader->SetFloat( "minLogLuminance", m_settings.MinLogLuminance );
+   m_averageShader->SetFloat( "logLuminanceRange", logLuminanceRange );
+   m_averageShader->SetFloat( "adaptationFactor", adaptationFactor );
+   glBindImageTexture( 0, m_adaptedLuminance[ m_current ], 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32F );
+   glDispatchCompute( 1, 1, 1 );
+
+   // Composite samples the result, next frame's histogram pass accumulates into the cleared bins
+   glMemoryBarrier( GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT );
+}
+
+void AutoExposure::ExecuteDownsample( unsigned int hdrTexture, float adaptationFactor )
+{
+   glDisable( GL_DEPTH_TEST );
+
+   glBindFramebuffer( GL_FRAMEBUFFER, m_logLuminanceFBO );
+   glViewport( 0, 0, DownsampleSize, DownsampleSize );
+   m_logLuminanceShader->Use( );
+   m_logLuminanceShader->SetFloat( "minLogLuminance", m_settings.MinLogLuminance );
+   m_logLuminanceShader->SetFloat( "maxLogLuminance", m_settings.MaxLogLuminance );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D, hdrTexture );
+   renderQuad( );
+
+   // Box filtered mip chain averages the log luminance down to a single texel
+   glBindTexture( GL_TEXTURE_2D, m_logLuminanceTexture );
+   glGenerateMipmap( GL_TEXTURE_2D );
+
+   glBindFramebuffer( GL_FRAMEBUFFER, m_adaptFBO[ m_current ] );
+   glViewport( 0, 0, 1, 1 );
+   m_adaptShader->Use( );
+   m_adaptShader->SetFloat( "averageLevel", std::log2( static_cast<float>( DownsampleSize ) ) );
+   m_adaptShader->SetFloat( "adaptationFactor", adaptationFactor );
+   glActiveTexture( GL_TEXTURE1 );
+   glBindTexture( GL_TEXTURE_2D, m_adaptedLuminance[ 1 - m_current ] );
+   renderQuad( );
+
+   glActiveTexture( GL_TEXTURE0 );
+   glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+   glEnable( GL_DEPTH_TEST );
+}
\ No newline at end of file
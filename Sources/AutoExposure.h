@@ -0,0 +1,62 @@
+#pragma once
+#include "Shader.h"
+#include "FrameGraph.h"
+
+#include <memory>
+
+struct AutoExposureSettings
+{
+   float MinLogLuminance = -8.0f;   // log2, darker pixels clamp here
+   float MaxLogLuminance = 4.0f;    // log2, brighter pixels clamp here
+   float AdaptationSpeed = 1.5f;    // Higher adapts faster
+};
+
+// Average scene luminance computed and adapted entirely on the GPU.
+// 4.3+ : log luminance histogram( LuminanceHistogram.cs ) reduced by a single work group( LuminanceAverage.cs ).
+// 3.3  : log luminance rendered into a mip mapped target, last mip sampled by ExposureAdapt.fs.
+// Result stays in a 1x1 R32F texture which the composite samples directly, nothing is read back.
+class AutoExposure
+{
+public:
+   AutoExposure( );
+   ~AutoExposure( );
+
+   AutoExposure( const AutoExposure& ) = delete;
+   AutoExposure& operator=( const AutoExposure& ) = delete;
+
+   static bool IsComputeSupported( );
+
+   void SetSettings( const AutoExposureSettings& settings ) { m_settings = settings; }
+   const AutoExposureSettings& GetSettings( ) const { return m_settings; }
+
+   // Adds the luminance pass reading 'hdrColor'. Returned resource is the adapted luminance( 1x1 R32F ).
+   FrameGraphResource AddPass( FrameGraph& frameGraph, FrameGraphResource hdrColor, float deltaTime );
+
+private:
+   void ExecuteCompute( unsigned int hdrTexture, unsigned int width, unsigned int height, float adaptationFactor );
+   void ExecuteDownsample( unsigned int hdrTexture, float adaptationFactor );
+
+private:
+   static constexpr unsigned int HistogramBins = 256;     // LuminanceHistogram.cs HISTOGRAM_BINS
+   static constexpr unsigned int HistogramGroupSize = 16; // LuminanceHistogram.cs local size
+   static constexpr unsigned int DownsampleSize = 256;
+
+   AutoExposureSettings m_settings;
+
+   // Compute path
+   std::unique_ptr<Shader> m_histogramShader;
+   std::unique_ptr<Shader> m_averageShader;
+   unsigned int m_histogramBuffer;
+
+   // Downsample path
+   std::unique_ptr<Shader> m_logLuminanceShader;
+   std::unique_ptr<Shader> m_adaptShader;
+   unsigned int m_logLuminanceTexture;
+   unsigned int m_logLuminanceFBO;
+   unsigned int m_adaptFBO[ 2 ];
+
+   // Compute path adapts in place, downsample path ping-pongs between both
+   unsigned int m_adaptedLuminance[ 2 ];
+   unsigned int m_current;
+
+};
\ No newline at end of file
@@ -0,0 +1,694 @@
+#include "BatchMath.h"
+
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BATCH_MATH_AVX
+#else
+#include <cpuid.h>
+// Only these functions may use AVX, the rest of the binary keeps running on CPUs without it
+#define BATCH_MATH_AVX __attribute__( ( target( "avx" ) ) )
+#endif
+
+#include <algorithm>
+
+namespace
+{
+   // Outputs of TransformBounds: MinX, MinY, MinZ, MaxX, MaxY, MaxZ
+   using BoundsOutput = float* const[ 6 ];
+
+   struct BatchMathTable
+   {
+      void ( *MultiplyMatrices )( const glm::mat4& lhs, const glm::mat4* matrices, glm::mat4* result, size_t count );
+      void ( *TransformPoints )( const glm::mat4& matrix, const glm::vec3* points, size_t count, float* x, float* y, float* z );
+      void ( *TransformBounds )( const glm::mat4* models, size_t count, const glm::vec3* localMins, const glm::vec3* localMaxs, BoundsOutput result );
+      void ( *BuildNormalMatrices )( const glm::mat4* models, glm::mat4* result, size_t count );
+      size_t ( *CullSpheres )( const glm::vec4 planes[ 6 ], const float* x, const float* y, const float* z, const float* radius,
+                               size_t count, uint32_t* visible );
+   };
+
+   bool IsAvxSupported( )
+   {
+      // CPUID.1:ECX AVX( bit 28 ) and OSXSAVE( bit 27 ), then XCR0 must have XMM and YMM state enabled
+#ifdef _MSC_VER
+      int registers[ 4 ];
+      __cpuid( registers, 1 );
+      unsigned int ecx = static_cast<unsigned int>( registers[ 2 ] );
+#else
+      unsigned int eax, ebx, ecx, edx;
+      if ( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+      {
+         return false;
+      }
+#endif
+      if ( ( ecx & ( 1u << 27 ) ) == 0 || ( ecx & ( 1u << 28 ) ) == 0 )
+      {
+         return false;
+      }
+
+#ifdef _MSC_VER
+      unsigned long long xcr0 = _xgetbv( 0 );
+#else
+      unsigned int xcr0Low, xcr0High;
+      __asm__( "xgetbv" : "=a"( xcr0Low ), "=d"( xcr0High ) : "c"( 0 ) );
+      unsigned long long xcr0 = xcr0Low;
+#endif
+      return ( xcr0 & 6 ) == 6;
+   }
+
+   BatchMathIsa GetSupportedIsa( )
+   {
+      static const BatchMathIsa supported = IsAvxSupported( ) ? BatchMathIsa::AVX : BatchMathIsa::SSE;
+      return supported;
+   }
+
+   BatchMathIsa& GetCurrentIsa( )
+   {
+      static BatchMathIsa current = GetSupportedIsa( );
+      return current;
+   }
+
+   size_t CompactVisible( int mask, size_t first, uint32_t* visible )
+   {
+      size_t written = 0;
+      while ( mask != 0 )
+      {
+         unsigned int lane = 0;
+         while ( ( mask & ( 1 << lane ) ) == 0 )
+         {
+            ++lane;
+         }
+         visible[ written++ ] = static_cast<uint32_t>( first + lane );
+         mask &= mask - 1;
+      }
+
+      return written;
+   }
+
+   namespace Scalar
+   {
+      void MultiplyMatrices( const glm::mat4& lhs, const glm::mat4* matrices, glm::mat4* result, size_t count )
+      {
+         for ( size_t idx = 0; idx < count; ++idx )
+         {
+            result[ idx ] = lhs * matrices[ idx ];
+         }
+      }
+
+      void TransformPoints( const glm::mat4& matrix, const glm::vec3* points, size_t count, float* x, float* y, float* z )
+      {
+         for ( size_t idx = 0; idx < count; ++idx )
+         {
+            glm::vec4 point = matrix * glm::vec4( points[ idx ], 1.0f );
+            x[ idx ] = point.x;
+            y[ idx ] = point.y;
+            z[ idx ] = point.z;
+         }
+      }
+
+      void TransformBounds( const glm::mat4* models, size_t count, const glm::vec3* localMins, const glm::vec3* localMaxs, BoundsOutput result )
+      {
+         for ( size_t idx = 0; idx < count; ++idx )
+         {
+            const glm::mat4& model = models[ idx ];
+            glm::vec3 center = ( localMins[ idx ] + localMaxs[ idx ] ) * 0.5f;
+            glm::vec3 extent = ( localMaxs[ idx ] - localMins[ idx ] ) * 0.5f;
+            glm::vec3 worldCenter = glm::vec3( model * glm::vec4( center, 1.0f ) );
+            glm::vec3 worldExtent = glm::abs( glm::vec3( model[ 0 ] ) ) * extent.x +
+                                    glm::abs( glm::vec3( model[ 1 ] ) ) * extent.y +
+                                    glm::abs( glm::vec3( model[ 2 ] ) ) * extent.z;
+            for ( int axis = 0; axis < 3; ++axis )
+            {
+               result[ axis ][ idx ] = worldCenter[ axis ] - worldExtent[ axis ];
+               result[ axis + 3 ][ idx ] = worldCenter[ axis ] + worldExtent[ axis ];
+            }
+         }
+      }
+
+      void BuildNormalMatrices( const glm::mat4* models, glm::mat4* result, size_t count )
+      {
+         for ( size_t idx = 0; idx < count; ++idx )
+         {
+            // Rows of the inverse are the cross products of the other two columns over the determinant
+            glm::vec3 c0( models[ idx ][ 0 ] );
+            glm::vec3 c1( models[ idx ][ 1 ] );
+            glm::vec3 c2( models[ idx ][ 2 ] );
+            glm::vec3 r0 = glm::cross( c1, c2 );
+            float invDet = 1.0f / glm::dot( c0, r0 );
+
+            glm::mat4 normal;
+            normal[ 0 ] = glm::vec4( r0 * invDet, 0.0f );
+            normal[ 1 ] = glm::vec4( glm::cross( c2, c0 ) * invDet, 0.0f );
+            normal[ 2 ] = glm::vec4( glm::cross( c0, c1 ) * invDet, 0.0f );
+            normal[ 3 ] = glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f );
+            result[ idx ] = normal;
+         }
+      }
+
+      size_t CullSpheres( const glm::vec4 planes[ 6 ], const float* x, const float* y, const float* z, const float* radius,
+                          size_t count, uint32_t* visible )
+      {
+         size_t written = 0;
+         for ( size_t idx = 0; idx < count; ++idx )
+         {
+            bool inside = true;
+            for ( int plane = 0; plane < 6 && inside; ++plane )
+            {
+               const glm::vec4& p = planes[ plane ];
+               inside = p.x * x[ idx ] + p.y * y[ idx ] + p.z * z[ idx ] + p.w + radius[ idx ] >= 0.0f;
+            }
+
+            if ( inside )
+            {
+               visible[ written++ ] = static_cast<uint32_t>( idx );
+            }
+         }
+
+         return written;
+      }
+   }
+
+   namespace SSE
+   {
+      inline __m128 LoadColumn( const glm::mat4& matrix, int column )
+      {
+         return _mm_loadu_ps( &matrix[ column ][ 0 ] );
+      }
+
+      inline __m128 Splat( __m128 value, int lane )
+      {
+         switch ( lane )
+         {
+         case 0:
+            return _mm_shuffle_ps( value, value, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+         case 1:
+            return _mm_shuffle_ps( value, value, _MM_SHUFFLE( 1, 1, 1, 1 ) );
+         case 2:
+            return _mm_shuffle_ps( value, value, _MM_SHUFFLE( 2, 2, 2, 2 ) );
+         default:
+            return _mm_shuffle_ps( value, value, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+         }
+      }
+
+      // 4 packed vec3( 12 floats ) => x, y, z lanes
+      inline void Deinterleave( const float* source, __m128& x, __m128& y, __m128& z )
+      {
+         __m128 a = _mm_loadu_ps( source );       // x0 y0 z0 x1
+         __m128 b = _mm_loadu_ps( source + 4 );   // y1 z1 x2 y2
+         __m128 c = _mm_loadu_ps( source + 8 );   // z2 x3 y3 z3
+
+         x = _mm_shuffle_ps( a, _mm_shuffle_ps( b, c, _MM_SHUFFLE( 1, 1, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 3, 0 ) );
+         y = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) ), _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+         z = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) ), _mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 3, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+      }
+
+      inline __m128 Cross( __m128 a, __m128 b )
+      {
+         __m128 aYZX = _mm_shuffle_ps( a, a, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+         __m128 bYZX = _mm_shuffle_ps( b, b, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+         __m128 result = _mm_sub_ps( _mm_mul_ps( a, bYZX ), _mm_mul_ps( aYZX, b ) );
+         return _mm_shuffle_ps( result, result, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+      }
+
+      void MultiplyMatrices( const glm::mat4& lhs, const glm::mat4* matrices, glm::mat4* result, size_t count )
+      {
+         const __m128 l0 = LoadColumn( lhs, 0 );
+         const __m128 l1 = LoadColumn( lhs, 1 );
+         const __m128 l2 = LoadColumn( lhs, 2 );
+         const __m128 l3 = LoadColumn( lhs, 3 );
+
+         for ( size_t idx = 0; idx < count; ++idx )
+         {
+            __m128 columns[ 4 ];
+            for ( int column = 0; column < 4; ++column )
+            {
+               columns[ column ] = LoadColumn( matrices[ idx ], column );
+            }
+
+            for ( int column = 0; column < 4; ++column )
+            {
+               __m128 value = _mm_mul_ps( l0, Splat( columns[ column ], 0 ) );
+               value = _mm_add_ps( value, _mm_mul_ps( l1, Splat( columns[ column ], 1 ) ) );
+               value = _mm_add_ps( value, _mm_mul_ps( l2, Splat( columns[ column ], 2 ) ) );
+               value = _mm_add_ps( value, _mm_mul_ps( l3, Splat( columns[ column ], 3 ) ) );
+               _mm_storeu_ps( &result[ idx ][ column ][ 0 ], value );
+            }
+         }
+      }
+
+      void TransformPoints( const glm::mat4& matrix, const glm::vec3* points, size_t count, float* x, float* y, float* z )
+      {
+         __m128 m[ 4 ][ 3 ];
+         for ( int column = 0; column < 4; ++column )
+         {
+            for ( int row = 0; row < 3; ++row )
+            {
+               m[ column ][ row ] = _mm_set1_ps( matrix[ column ][ row ] );
+            }
+         }
+
+         size_t idx = 0;
+         for ( ; idx + 4 <= count; idx += 4 )
+         {
+            __m128 px, py, pz;
+            Deinterleave( &points[ idx ].x, px, py, pz );
+
+            __m128 out[ 3 ];
+            for ( int row = 0; row < 3; ++row )
+            {
+               out[ row ] = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[ 0 ][ row ], px ), _mm_mul_ps( m[ 1 ][ row ], py ) ),
+                                        _mm_add_ps( _mm_mul_ps( m[ 2 ][ row ], pz ), m[ 3 ][ row ] ) );
+            }
+            _mm_storeu_ps( x + idx, out[ 0 ] );
+            _mm_storeu_ps( y + idx, out[ 1 ] );
+            _mm_storeu_ps( z + idx, out[ 2 ] );
+         }
+
+         Scalar::TransformPoints( matrix, points + idx, count - idx, x + idx, y + idx, z + idx );
+      }
+
+      void TransformBounds( const glm::mat4* models, size_t count, const glm::vec3* localMins, const glm::vec3* localMaxs, BoundsOutput result )
+      {
+         const __m128 signMask = _mm_set1_ps( -0.0f );
+         for ( size_t idx = 0; idx < count; ++idx )
+         {
+            glm::vec3 center = ( localMins[ idx ] + localMaxs[ idx ] ) * 0.5f;
+            glm::vec3 extent = ( localMaxs[ idx ] - localMins[ idx ] ) * 0.5f;
+            __m128 cx = _mm_set1_ps( center.x );
+            __m128 cy = _mm_set1_ps( center.y );
+            __m128 cz = _mm_set1_ps( center.z );
+            __m128 ex = _mm_set1_ps( extent.x );
+            __m128 ey = _mm_set1_ps( extent.y );
+            __m128 ez = _mm_set1_ps( extent.z );
+
+            __m128 c0 = LoadColumn( models[ idx ], 0 );
+            __m128 c1 = LoadColumn( models[ idx ], 1 );
+            __m128 c2 = LoadColumn( models[ idx ], 2 );
+            __m128 c3 = LoadColumn( models[ idx ], 3 );
+
+            __m128 worldCenter = _mm_add_ps( _mm_add_ps( _mm_mul_ps( c0, cx ), _mm_mul_ps( c1, cy ) ), _mm_add_ps( _mm_mul_ps( c2, cz ), c3 ) );
+            __m128 worldExtent = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_andnot_ps( signMask, c0 ), ex ), _mm_mul_ps( _mm_andnot_ps( signMask, c1 ), ey ) ),
+                                             _mm_mul_ps( _mm_andnot_ps( signMask, c2 ), ez ) );
+
+            float bounds[ 8 ];
+            _mm_storeu_ps( bounds, _mm_sub_ps( worldCenter, worldExtent ) );
+            _mm_storeu_ps( bounds + 4, _mm_add_ps( worldCenter, worldExtent ) );
+            for ( int axis = 0; axis < 3; ++axis )
+            {
+               result[ axis ][ idx ] = bounds[ axis ];
+               result[ axis + 3 ][ idx ] = bounds[ axis + 4 ];
+            }
+         }
+      }
+
+      void BuildNormalMatrices( const glm::mat4* models, glm::mat4* result, size_t count )
+      {
+         const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+         const __m128 lastColumn = _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f );
+
+         for ( size_t idx = 0; idx < count; ++idx )
+         {
+            __m128 c0 = _mm_and_ps( LoadColumn( models[ idx ], 0 ), xyzMask );
+            __m128 c1 = _mm_and_ps( LoadColumn( models[ idx ], 1 ), xyzMask );
+            __m128 c2 = _mm_and_ps( LoadColumn( models[ idx ], 2 ), xyzMask );
+
+            __m128 r0 = Cross( c1, c2 );
+            __m128 r1 = Cross( c2, c0 );
+            __m128 r2 = Cross( c0, c1 );
+
+            // det in every lane
+            __m128 products = _mm_mul_ps( c0, r0 );
+            __m128 det = _mm_add_ps( _mm_add_ps( Splat( products, 0 ), Splat( products, 1 ) ), Splat( products, 2 ) );
+            __m128 invDet = _mm_div_ps( _mm_set1_ps( 1.0f ), det );
+
+            _mm_storeu_ps( &result[ idx ][ 0 ][ 0 ], _mm_mul_ps( r0, invDet ) );
+            _mm_storeu_ps( &result[ idx ][ 1 ][ 0 ], _mm_mul_ps( r1, invDet ) );
+            _mm_storeu_ps( &result[ idx ][ 2 ][ 0 ], _mm_mul_ps( r2, invDet ) );
+            _mm_storeu_ps( &result[ idx ][ 3 ][ 0 ], lastColumn );
+         }
+      }
+
+      size_t CullSpheres( const glm::vec4 planes[ 6 ], const float* x, const float* y, const float* z, const float* radius,
+                          size_t count, uint32_t* visible )
+      {
+         __m128 p[ 6 ][ 4 ];
+         for ( int plane = 0; plane < 6; ++plane )
+         {
+            for ( int component = 0; component < 4; ++component )
+            {
+               p[ plane ][ component ] = _mm_set1_ps( planes[ plane ][ component ] );
+            }
+         }
+
+         const __m128 zero = _mm_setzero_ps( );
+         size_t written = 0;
+         size_t idx = 0;
+         for ( ; idx + 4 <= count; idx += 4 )
+         {
+            __m128 sx = _mm_loadu_ps( x + idx );
+            __m128 sy = _mm_loadu_ps( y + idx );
+            __m128 sz = _mm_loadu_ps( z + idx );
+            __m128 sr = _mm_loadu_ps( radius + idx );
+
+            __m128 inside = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+            for ( int plane = 0; plane < 6; ++plane )
+            {
+               __m128 distance = _mm_add_ps( _mm_add_ps( _mm_mul_ps( p[ plane ][ 0 ], sx ), _mm_mul_ps( p[ plane ][ 1 ], sy ) ),
+                                             _mm_add_ps( _mm_mul_ps( p[ plane ][ 2 ], sz ), _mm_add_ps( p[ plane ][ 3 ], sr ) ) );
+               inside = _mm_and_ps( inside, _mm_cmpge_ps( distance, zero ) );
+            }
+
+            written += CompactVisible( _mm_movemask_ps( inside ), idx, visible + written );
+         }
+
+         size_t tail = Scalar::CullSpheres( planes, x + idx, y + idx, z + idx, radius + idx, count - idx, visible + written );
+         for ( size_t entry = written; entry < written + tail; ++entry )
+         {
+            visible[ entry ] += static_cast<uint32_t>( idx );
+         }
+
+         return written + tail;
+      }
+   }
+
+   namespace AVX
+   {
+      // Same column of two matrices, one per 128 bit lane
+      BATCH_MATH_AVX inline __m256 LoadColumnPair( const glm::mat4& first, const glm::mat4& second, int column )
+      {
+         return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( &first[ column ][ 0 ] ) ), _mm_loadu_ps( &second[ column ][ 0 ] ), 1 );
+      }
+
+      BATCH_MATH_AVX inline void StoreColumnPair( glm::mat4& first, glm::mat4& second, int column, __m256 value )
+      {
+         _mm_storeu_ps( &first[ column ][ 0 ], _mm256_castps256_ps128( value ) );
+         _mm_storeu_ps( &second[ column ][ 0 ], _mm256_extractf128_ps( value, 1 ) );
+      }
+
+      BATCH_MATH_AVX inline __m256 Cross( __m256 a, __m256 b )
+      {
+         __m256 aYZX = _mm256_shuffle_ps( a, a, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+         __m256 bYZX = _mm256_shuffle_ps( b, b, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+         __m256 result = _mm256_sub_ps( _mm256_mul_ps( a, bYZX ), _mm256_mul_ps( aYZX, b ) );
+         return _mm256_shuffle_ps( result, result, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+      }
+
+      BATCH_MATH_AVX void MultiplyMatrices( const glm::mat4& lhs, const glm::mat4* matrices, glm::mat4* result, size_t count )
+      {
+         __m128 lhsColumns[ 4 ];
+         for ( int column = 0; column < 4; ++column )
+         {
+            lhsColumns[ column ] = _mm_loadu_ps( &lhs[ column ][ 0 ] );
+         }
+         const __m256 l0 = _mm256_broadcast_ps( &lhsColumns[ 0 ] );
+         const __m256 l1 = _mm256_broadcast_ps( &lhsColumns[ 1 ] );
+         const __m256 l2 = _mm256_broadcast_ps( &lhsColumns[ 2 ] );
+         const __m256 l3 = _mm256_broadcast_ps( &lhsColumns[ 3 ] );
+
+         // Two result columns per register
+         for ( size_t idx = 0; idx < count; ++idx )
+         {
+            __m256 pairs[ 2 ] = { _mm256_loadu_ps( &matrices[ idx ][ 0 ][ 0 ] ), _mm256_loadu_ps( &matrices[ idx ][ 2 ][ 0 ] ) };
+            __m256 values[ 2 ];
+            for ( int pair = 0; pair < 2; ++pair )
+            {
+               __m256 value = _mm256_mul_ps( l0, _mm256_permute_ps( pairs[ pair ], _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+               value = _mm256_add_ps( value, _mm256_mul_ps( l1, _mm256_permute_ps( pairs[ pair ], _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+               value = _mm256_add_ps( value, _mm256_mul_ps( l2, _mm256_permute_ps( pairs[ pair ], _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+               value = _mm256_add_ps( value, _mm256_mul_ps( l3, _mm256_permute_ps( pairs[ pair ], _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+               values[ pair ] = value;
+            }
+            _mm256_storeu_ps( &result[ idx ][ 0 ][ 0 ], values[ 0 ] );
+            _mm256_storeu_ps( &result[ idx ][ 2 ][ 0 ], values[ 1 ] );
+         }
+      }
+
+      // 'first' in the low lane, 'second' in the high lane
+      BATCH_MATH_AVX inline __m256 BroadcastPair( float first, float second )
+      {
+         return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_set1_ps( first ) ), _mm_set1_ps( second ), 1 );
+      }
+
+      BATCH_MATH_AVX void TransformPoints( const glm::mat4& matrix, const glm::vec3* points, size_t count, float* x, float* y, float* z )
+      {
+         __m256 m[ 4 ][ 3 ];
+         for ( int column = 0; column < 4; ++column )
+         {
+            for ( int row = 0; row < 3; ++row )
+            {
+               m[ column ][ row ] = _mm256_set1_ps( matrix[ column ][ row ] );
+            }
+         }
+
+         size_t idx = 0;
+         for ( ; idx + 8 <= count; idx += 8 )
+         {
+            __m128 lowX, lowY, lowZ, highX, highY, highZ;
+            SSE::Deinterleave( &points[ idx ].x, lowX, lowY, lowZ );
+            SSE::Deinterleave( &points[ idx + 4 ].x, highX, highY, highZ );
+            __m256 px = _mm256_insertf128_ps( _mm256_castps128_ps256( lowX ), highX, 1 );
+            __m256 py = _mm256_insertf128_ps( _mm256_castps128_ps256( lowY ), highY, 1 );
+            __m256 pz = _mm256_insertf128_ps( _mm256_castps128_ps256( lowZ ), highZ, 1 );
+
+            __m256 out[ 3 ];
+            for ( int row = 0; row < 3; ++row )
+            {
+               out[ row ] = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m[ 0 ][ row ], px ), _mm256_mul_ps( m[ 1 ][ row ], py ) ),
+                                           _mm256_add_ps( _mm256_mul_ps( m[ 2 ][ row ], pz ), m[ 3 ][ row ] ) );
+            }
+            _mm256_storeu_ps( x + idx, out[ 0 ] );
+            _mm256_storeu_ps( y + idx, out[ 1 ] );
+            _mm256_storeu_ps( z + idx, out[ 2 ] );
+         }
+
+         SSE::TransformPoints( matrix, points + idx, count - idx, x + idx, y + idx, z + idx );
+      }
+
+      BATCH_MATH_AVX void TransformBounds( const glm::mat4* models, size_t count, const glm::vec3* localMins, const glm::vec3* localMaxs,
+                                           BoundsOutput result )
+      {
+         const __m256 signMask = _mm256_set1_ps( -0.0f );
+
+         // Two models per register
+         size_t idx = 0;
+         for ( ; idx + 2 <= count; idx += 2 )
+         {
+            const glm::vec3* boxMin = localMins + idx;
+            const glm::vec3* boxMax = localMaxs + idx;
+            glm::vec3 center[ 2 ] = { ( boxMin[ 0 ] + boxMax[ 0 ] ) * 0.5f, ( boxMin[ 1 ] + boxMax[ 1 ] ) * 0.5f };
+            glm::vec3 extent[ 2 ] = { ( boxMax[ 0 ] - boxMin[ 0 ] ) * 0.5f, ( boxMax[ 1 ] - boxMin[ 1 ] ) * 0.5f };
+            __m256 cx = BroadcastPair( center[ 0 ].x, center[ 1 ].x );
+            __m256 cy = BroadcastPair( center[ 0 ].y, center[ 1 ].y );
+            __m256 cz = BroadcastPair( center[ 0 ].z, center[ 1 ].z );
+            __m256 ex = BroadcastPair( extent[ 0 ].x, extent[ 1 ].x );
+            __m256 ey = BroadcastPair( extent[ 0 ].y, extent[ 1 ].y );
+            __m256 ez = BroadcastPair( extent[ 0 ].z, extent[ 1 ].z );
+
+            __m256 c0 = LoadColumnPair( models[ idx ], models[ idx + 1 ], 0 );
+            __m256 c1 = LoadColumnPair( models[ idx ], models[ idx + 1 ], 1 );
+            __m256 c2 = LoadColumnPair( models[ idx ], models[ idx + 1 ], 2 );
+            __m256 c3 = LoadColumnPair( models[ idx ], models[ idx + 1 ], 3 );
+
+            __m256 worldCenter = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( c0, cx ), _mm256_mul_ps( c1, cy ) ), _mm256_add_ps( _mm256_mul_ps( c2, cz ), c3 ) );
+            __m256 worldExtent = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_andnot_ps( signMask, c0 ), ex ), _mm256_mul_ps( _mm256_andnot_ps( signMask, c1 ), ey ) ),
+                                                _mm256_mul_ps( _mm256_andnot_ps( signMask, c2 ), ez ) );
+
+            float minimum[ 8 ];
+            float maximum[ 8 ];
+            _mm256_storeu_ps( minimum, _mm256_sub_ps( worldCenter, worldExtent ) );
+            _mm256_storeu_ps( maximum, _mm256_add_ps( worldCenter, worldExtent ) );
+            for ( int axis = 0; axis < 3; ++axis )
+            {
+               result[ axis ][ idx ] = minimum[ axis ];
+               result[ axis ][ idx + 1 ] = minimum[ axis + 4 ];
+               result[ axis + 3 ][ idx ] = maximum[ axis ];
+               result[ axis + 3 ][ idx + 1 ] = maximum[ axis + 4 ];
+            }
+         }
+
+         if ( idx < count )
+         {
+            float* const tail[ 6 ] = { result[ 0 ] + idx, result[ 1 ] + idx, result[ 2 ] + idx, result[ 3 ] + idx, result[ 4 ] + idx, result[ 5 ] + idx };
+            SSE::TransformBounds( models + idx, count - idx, localMins + idx, localMaxs + idx, tail );
+         }
+      }
+
+      BATCH_MATH_AVX void BuildNormalMatrices( const glm::mat4* models, glm::mat4* result, size_t count )
+      {
+         const __m256 xyzMask = _mm256_castsi256_ps( _mm256_setr_epi32( -1, -1, -1, 0, -1, -1, -1, 0 ) );
+         const __m256 lastColumn = _mm256_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f );
+
+         size_t idx = 0;
+         for ( ; idx + 2 <= count; idx += 2 )
+         {
+            __m256 c0 = _mm256_and_ps( LoadColumnPair( models[ idx ], models[ idx + 1 ], 0 ), xyzMask );
+            __m256 c1 = _mm256_and_ps( LoadColumnPair( models[ idx ], models[ idx + 1 ], 1 ), xyzMask );
+            __m256 c2 = _mm256_and_ps( LoadColumnPair( models[ idx ], models[ idx + 1 ], 2 ), xyzMask );
+
+            __m256 r0 = Cross( c1, c2 );
+            __m256 r1 = Cross( c2, c0 );
+            __m256 r2 = Cross( c0, c1 );
+
+            __m256 products = _mm256_mul_ps( c0, r0 );
+            __m256 det = _mm256_add_ps( _mm256_add_ps( _mm256_permute_ps( products, _MM_SHUFFLE( 0, 0, 0, 0 ) ),
+                                                       _mm256_permute_ps( products, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ),
+                                        _mm256_permute_ps( products, _MM_SHUFFLE( 2, 2, 2, 2 ) ) );
+            __m256 invDet = _mm256_div_ps( _mm256_set1_ps( 1.0f ), det );
+
+            StoreColumnPair( result[ idx ], result[ idx + 1 ], 0, _mm256_mul_ps( r0, invDet ) );
+            StoreColumnPair( result[ idx ], result[ idx + 1 ], 1, _mm256_mul_ps( r1, invDet ) );
+            StoreColumnPair( result[ idx ], result[ idx + 1 ], 2, _mm256_mul_ps( r2, invDet ) );
+            StoreColumnPair( result[ idx ], result[ idx + 1 ], 3, lastColumn );
+         }
+
+         SSE::BuildNormalMatrices( models + idx, result + idx, count - idx );
+      }
+
+      BATCH_MATH_AVX size_t CullSpheres( const glm::vec4 planes[ 6 ], const float* x, const float* y, const float* z, const float* radius,
+                                         size_t count, uint32_t* visible )
+      {
+         __m256 p[ 6 ][ 4 ];
+         for ( int plane = 0; plane < 6; ++plane )
+         {
+            for ( int component = 0; component < 4; ++component )
+            {
+               p[ plane ][ component ] = _mm256_set1_ps( planes[ plane ][ component ] );
+            }
+         }
+
+         const __m256 zero = _mm256_setzero_ps( );
+         size_t written = 0;
+         size_t idx = 0;
+         for ( ; idx + 8 <= count; idx += 8 )
+         {
+            __m256 sx = _mm256_loadu_ps( x + idx );
+            __m256 sy = _mm256_loadu_ps( y + idx );
+            __m256 sz = _mm256_loadu_ps( z + idx );
+            __m256 sr = _mm256_loadu_ps( radius + idx );
+
+            __m256 inside = _mm256_castsi256_ps( _mm256_set1_epi32( -1 ) );
+            for ( int plane = 0; plane < 6; ++plane )
+            {
+               __m256 distance = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( p[ plane ][ 0 ], sx ), _mm256_mul_ps( p[ plane ][ 1 ], sy ) ),
+                                                _mm256_add_ps( _mm256_mul_ps( p[ plane ][ 2 ], sz ), _mm256_add_ps( p[ plane ][ 3 ], sr ) ) );
+               inside = _mm256_and_ps( inside, _mm256_cmp_ps( distance, zero, _CMP_GE_OQ ) );
+            }
+
+            written += CompactVisible( _mm256_movemask_ps( inside ), idx, visible + written );
+         }
+
+         size_t tail = SSE::CullSpheres( planes, x + idx, y + idx, z + idx, radius + idx, count - idx, visible + written );
+         for ( size_t entry = written; entry < written + tail; ++entry )
+         {
+            visible[ entry ] += static_cast<uint32_t>( idx );
+         }
+
+         return written + tail;
+      }
+   }
+
+   const BatchMathTable Tables[ static_cast<int>( BatchMathIsa::EnumMax ) ] =
+   {
+      { Scalar::MultiplyMatrices, Scalar::TransformPoints, Scalar::TransformBounds, Scalar::BuildNormalMatrices, Scalar::CullSpheres },
+      { SSE::MultiplyMatrices, SSE::TransformPoints, SSE::TransformBounds, SSE::BuildNormalMatrices, SSE::CullSpheres },
+      { AVX::MultiplyMatrices, AVX::TransformPoints, AVX::TransformBounds, AVX::BuildNormalMatrices, AVX::CullSpheres }
+   };
+
+   const BatchMathTable& GetTable( )
+   {
+      return Tables[ static_cast<int>( GetCurrentIsa( ) ) ];
+   }
+}
+
+const char* ToString( BatchMathIsa isa )
+{
+   switch ( isa )
+   {
+   case BatchMathIsa::Scalar:
+      return "Scalar";
+   case BatchMathIsa::SSE:
+      return "SSE";
+   case BatchMathIsa::AVX:
+      return "AVX";
+   default:
+      break;
+   }
+
+   return "Unknown";
+}
+
+BatchMathIsa GetBatchMathIsa( )
+{
+   return GetCurrentIsa( );
+}
+
+BatchMathIsa SetBatchMathIsa( BatchMathIsa isa )
+{
+   GetCurrentIsa( ) = std::min( isa, GetSupportedIsa( ) );
+   return GetCurrentIsa( );
+}
+
+void BoundsArray::Resize( size_t count )
+{
+   MinX.resize( count );
+   MinY.resize( count );
+   MinZ.resize( count );
+   MaxX.resize( count );
+   MaxY.resize( count );
+   MaxZ.resize( count );
+}
+
+void ExtractFrustumPlanes( const glm::mat4& viewProjection, glm::vec4 planes[ 6 ] )
+{
+   glm::vec4 row[ 4 ];
+   for ( int idx = 0; idx < 4; ++idx )
+   {
+      row[ idx ] = glm::vec4( viewProjection[ 0 ][ idx ], viewProjection[ 1 ][ idx ], viewProjection[ 2 ][ idx ], viewProjection[ 3 ][ idx ] );
+   }
+
+   planes[ 0 ] = row[ 3 ] + row[ 0 ];
+   planes[ 1 ] = row[ 3 ] - row[ 0 ];
+   planes[ 2 ] = row[ 3 ] + row[ 1 ];
+   planes[ 3 ] = row[ 3 ] - row[ 1 ];
+   planes[ 4 ] = row[ 3 ] + row[ 2 ];
+   planes[ 5 ] = row[ 3 ] - row[ 2 ];
+   for ( int idx = 0; idx < 6; ++idx )
+   {
+      planes[ idx ] /= glm::length( glm::vec3( planes[ idx ] ) );
+   }
+}
+
+void MultiplyMatrices( const glm::mat4& lhs, const glm::mat4* matrices, glm::mat4* result, size_t count )
+{
+   GetTable( ).MultiplyMatrices( lhs, matrices, result, count );
+}
+
+void TransformPoints( const glm::mat4& matrix, const glm::vec3* points, size_t count, PointArray& result )
+{
+   result.Resize( count );
+   if ( count > 0 )
+   {
+      GetTable( ).TransformPoints( matrix, points, count, result.X.data( ), result.Y.data( ), result.Z.data( ) );
+   }
+}
+
+void TransformBounds( const glm::mat4* models, const glm::vec3* localMins, const glm::vec3* localMaxs, size_t count,
+                      float* minX, float* minY, float* minZ, float* maxX, float* maxY, float* maxZ )
+{
+   if ( count > 0 )
+   {
+      float* const outputs[ 6 ] = { minX, minY, minZ, maxX, maxY, maxZ };
+      GetTable( ).TransformBounds( models, count, localMins, localMaxs, outputs );
+   }
+}
+
+void BuildNormalMatrices( const glm::mat4* models, glm::mat4* result, size_t count )
+{
+   GetTable( ).BuildNormalMatrices( models, result, count );
+}
+
+size_t CullSpheres( const glm::vec4 planes[ 6 ], const float* x, const float* y, const float* z, const float* radius,
+                    size_t count, uint32_t* visible )
+{
+   return GetTable( ).CullSpheres( planes, x, y, z, radius, count, visible );
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Batch transforms and culling over whole arrays instead of one glm call per object.
+// Every entry point runs through a table picked once from cpuid( AVX only when the OS saves the YMM state ),
+// points and bounds are stored as structure of arrays so one register holds the same component of 4 / 8 elements.
+// Matrices stay column major glm::mat4 arrays, they are uploaded as is.
+
+enum class BatchMathIsa
+{
+   Scalar = 0,   // Plain glm, reference for the other tiers
+   SSE,          // 4 lanes, baseline of every x86 CPU the demo runs on
+   AVX,          // 8 lanes
+   EnumMax
+};
+
+const char* ToString( BatchMathIsa isa );
+
+BatchMathIsa GetBatchMathIsa( );
+
+// Forces a tier( ex. to compare timings ), clamped to what the CPU supports. Returns the tier in use.
+BatchMathIsa SetBatchMathIsa( BatchMathIsa isa );
+
+struct PointArray
+{
+   std::vector<float> X;
+   std::vector<float> Y;
+   std::vector<float> Z;
+
+   void Resize( size_t count ) { X.resize( count ); Y.resize( count ); Z.resize( count ); }
+   size_t GetCount( ) const { return X.size( ); }
+};
+
+struct BoundsArray
+{
+   std::vector<float> MinX;
+   std::vector<float> MinY;
+   std::vector<float> MinZ;
+   std::vector<float> MaxX;
+   std::vector<float> MaxY;
+   std::vector<float> MaxZ;
+
+   void Resize( size_t count );
+   size_t GetCount( ) const { return MinX.size( ); }
+};
+
+// Normalized planes( xyz = inward normal, w = distance ) of a view projection, Gribb / Hartmann:
+// left, right, bottom, top, near, far. With a projection alone the planes are in view space.
+void ExtractFrustumPlanes( const glm::mat4& viewProjection, glm::vec4 planes[ 6 ] );
+
+// result[ idx ] = lhs * matrices[ idx ]. 'result' may alias 'matrices'.
+void MultiplyMatrices( const glm::mat4& lhs, const glm::mat4* matrices, glm::mat4* result, size_t count );
+
+// matrix * ( point, 1 ). Points are read as glm::vec3 arrays( LightManager ), result is resized to 'count'.
+void TransformPoints( const glm::mat4& matrix, const glm::vec3* points, size_t count, PointArray& result );
+
+// World AABB of each model's local box( center / extent form ), written into per axis arrays with room for 'count'
+// ( ex. a slice of a BoundsArray ).
+void TransformBounds( const glm::mat4* models, const glm::vec3* localMins, const glm::vec3* localMaxs, size_t count,
+                      float* minX, float* minY, float* minZ, float* maxX, float* maxY, float* maxZ );
+
+// Inverse transpose of the upper 3x3 of each model, stored in the upper 3x3 of a mat4( rest identity ).
+void BuildNormalMatrices( const glm::mat4* models, glm::mat4* result, size_t count );
+
+// Writes the indices of spheres which are not completely behind any of the 6 planes into 'visible'( room for 'count' ),
+// returns how many were written. Indices are ascending.
+size_t CullSpheres( const glm::vec4 planes[ 6 ], const float* x, const float* y, const float* z, const float* radius,
+                    size_t count, uint32_t* visible );
\ No newline at end of file
@@ -21,6 +21,20 @@ const float SPEED = 2.5f;
 const float SENSITIVITY = 0.1f;
 const float ZOOM = 45.0f;
 
+// Radical inverse of index in given base, low discrepancy sequence for sub pixel jitter
+inline float Halton( unsigned int index, unsigned int base )
+{
+   float result = 0.0f;
+   float fraction = 1.0f;
+   while ( index > 0 )
+   {
+      fraction /= base;
+      result += fraction * ( index % base );
+      index /= base;
+   }
+   return result;
+}
+
 
 // An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
 class Camera
@@ -39,6 +53,9 @@ public:
    float MovementSpeed;
    float MouseSensitivity;
    float Zoom;
+   // Sub pixel projection offset in pixels( [-0.5, 0.5] ), used by temporal anti aliasing
+   glm::vec2 Jitter = glm::vec2( 0.0f, 0.0f );
+   unsigned int JitterIndex = 0;
 
    // Constructor with vectors
    Camera( glm::vec3 position = glm::vec3( 0.0f, 0.0f, 0.0f ), glm::vec3 up = glm::vec3( 0.0f, 1.0f, 0.0f ), float yaw = YAW, float pitch = PITCH ) : Front( glm::vec3( 0.0f, 0.0f, -1.0f ) ), MovementSpeed( SPEED ), MouseSensitivity( SENSITIVITY ), Zoom( ZOOM )
@@ -65,6 +82,31 @@ public:
       return glm::lookAt( Position, Position + Front, Up );
    }
 
+   glm::mat4 GetProjectionMatrix( float aspect, float nearPlane, float farPlane ) const
+   {
+      return glm::perspective( glm::radians( Zoom ), aspect, nearPlane, farPlane );
+   }
+
+   // Projection shifted by Jitter for a width x height viewport, the image moves by Jitter pixels
+   glm::mat4 GetJitteredProjectionMatrix( float width, float height, float nearPlane, float farPlane ) const
+   {
+      glm::vec3 offset( 2.0f * Jitter.x / width, 2.0f * Jitter.y / height, 0.0f );
+      return glm::translate( glm::mat4( ), offset ) * GetProjectionMatrix( width / height, nearPlane, farPlane );
+   }
+
+   // Moves Jitter to the next point of a Halton( 2, 3 ) sequence of given length
+   void AdvanceJitter( unsigned int sequenceLength = 8 )
+   {
+      JitterIndex = ( JitterIndex + 1 ) % sequenceLength;
+      Jitter = glm::vec2( Halton( JitterIndex + 1, 2 ) - 0.5f, Halton( JitterIndex + 1, 3 ) - 0.5f );
+   }
+
+   void ResetJitter( )
+   {
+      JitterIndex = 0;
+      Jitter = glm::vec2( 0.0f, 0.0f );
+   }
+
    // Processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
    void ProcessKeyboard( Camera_Movement direction, float deltaTime )
    {
@@ -0,0 +1,358 @@
+#include "CascadedShadowMap.h"
+#include "Primitives.h"
+
+#include <algorithm>
+#include <cmath>
+
+CascadedShadowMap::CascadedShadowMap( ) :
+   m_depthShader( "../Resources/Shaders/ShadowMappingDepth.vs", "../Resources/Shaders/ShadowMappingDepth.fs" ),
+   m_momentsShader( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/EVSMMoments.fs" ),
+   m_momentsBlurShader( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/EVSMBlur.fs" ),
+   m_texture( 0 ),
+   m_momentsTexture( 0 ),
+   m_momentsBlurTexture( 0 ),
+   m_momentsFramebuffer( 0 ),
+   m_depthSampler( 0 ),
+   m_lightDirection( 0.0f ),
+   m_lightColor( 0.0f ),
+   m_renderedCascadeCount( 0 )
+{
+   std::fill( m_splits, m_splits + CascadeCount, 0.0f );
+   glGenFramebuffers( CascadeCount, m_framebuffers );
+   CreateStorage( );
+}
+
+CascadedShadowMap::~CascadedShadowMap( )
+{
+   DestroyMomentsStorage( );
+   glDeleteFramebuffers( CascadeCount, m_framebuffers );
+   glDeleteTextures( 1, &m_texture );
+}
+
+void CascadedShadowMap::CreateStorage( )
+{
+   glDeleteTextures( 1, &m_texture );
+   glGenTextures( 1, &m_texture );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, m_texture );
+   glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, m_settings.Resolution, m_settings.Resolution, CascadeCount,
+                 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   // Linear filter + compare mode => 2x2 PCF in hardware
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+
+   for ( unsigned int idx = 0; idx < CascadeCount; ++idx )
+   {
+      glBindFramebuffer( GL_FRAMEBUFFER, m_framebuffers[ idx ] );
+      glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_texture, 0, idx );
+      glDrawBuffer( GL_NONE );
+      glReadBuffer( GL_NONE );
+      if ( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+      {
+         std::cout << "Cascade framebuffer not complete!" << std::endl;
+      }
+   }
+   glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+
+   if ( m_settings.Filter == ShadowFilter::EVSM )
+   {
+      CreateMomentsStorage( );
+   }
+   InvalidateCache( );
+}
+
+void CascadedShadowMap::CreateMomentsStorage( )
+{
+   DestroyMomentsStorage( );
+
+   // 2x2 depth texels per moments texel, the blur widens the footprint further anyway
+   unsigned int resolution = m_settings.Resolution / 2;
+   glGenTextures( 1, &m_momentsTexture );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, m_momentsTexture );
+   glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_RGBA32F, resolution, resolution, CascadeCount, 0, GL_RGBA, GL_FLOAT, nullptr );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+
+   glGenTextures( 1, &m_momentsBlurTexture );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, m_momentsBlurTexture );
+   glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_RGBA32F, resolution, resolution, 1, 0, GL_RGBA, GL_FLOAT, nullptr );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+
+   glGenFramebuffers( 1, &m_momentsFramebuffer );
+   glBindFramebuffer( GL_FRAMEBUFFER, m_momentsFramebuffer );
+   glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_momentsTexture, 0, 0 );
+   if ( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+   {
+      std::cout << "EVSM moments framebuffer not complete!" << std::endl;
+   }
+   glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+
+   glGenSamplers( 1, &m_depthSampler );
+   glSamplerParameteri( m_depthSampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+   glSamplerParameteri( m_depthSampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+   glSamplerParameteri( m_depthSampler, GL_TEXTURE_COMPARE_MODE, GL_NONE );
+
+   m_momentsKernel = BuildLinearSampledKernel( m_settings.EVSMBlurSigma, GaussianRadius( m_settings.EVSMBlurSigma ) );
+}
+
+void CascadedShadowMap::DestroyMomentsStorage( )
+{
+   glDeleteTextures( 1, &m_momentsTexture );
+   glDeleteTextures( 1, &m_momentsBlurTexture );
+   glDeleteFramebuffers( 1, &m_momentsFramebuffer );
+   glDeleteSamplers( 1, &m_depthSampler );
+   m_momentsTexture = 0;
+   m_momentsBlurTexture = 0;
+   m_momentsFramebuffer = 0;
+   m_depthSampler = 0;
+}
+
+void CascadedShadowMap::SetSettings( const CascadedShadowSettings& settings )
+{
+   bool resize = settings.Resolution != m_settings.Resolution;
+   bool filterChanged = settings.Filter != m_settings.Filter || settings.EVSMBlurSigma != m_settings.EVSMBlurSigma;
+   m_settings = settings;
+   if ( resize )
+   {
+      CreateStorage( );
+   }
+   else if ( filterChanged )
+   {
+      if ( m_settings.Filter == ShadowFilter::EVSM )
+      {
+         CreateMomentsStorage( );
+      }
+      else
+      {
+         DestroyMomentsStorage( );
+      }
+   }
+   InvalidateCache( );
+}
+
+void CascadedShadowMap::SetFilter( ShadowFilter filter )
+{
+   if ( filter != m_settings.Filter )
+   {
+      CascadedShadowSettings settings = m_settings;
+      settings.Filter = filter;
+      SetSettings( settings );
+   }
+}
+
+void CascadedShadowMap::InvalidateCache( )
+{
+   for ( auto& cascade : m_cascades )
+   {
+      cascade.Dirty = true;
+   }
+}
+
+void CascadedShadowMap::FitCascade( Cascade& cascade, const glm::vec3& center, float radius ) const
+{
+   // Snap the light space origin to whole texels, the rasterized depth only changes when the cascade moves by a texel
+   float texelSize = 2.0f * radius / m_settings.Resolution;
+   glm::vec3 lightCenter = glm::vec3( m_lightView * glm::vec4( center, 1.0f ) );
+   lightCenter.x = std::floor( lightCenter.x / texelSize ) * texelSize;
+   lightCenter.y = std::floor( lightCenter.y / texelSize ) * texelSize;
+
+   // Casters in front of the near plane are kept by depth clamp while rendering
+   glm::mat4 projection = glm::ortho( lightCenter.x - radius, lightCenter.x + radius,
+                                      lightCenter.y - radius, lightCenter.y + radius,
+                                      -lightCenter.z - radius, -lightCenter.z + radius );
+
+   cascade.ViewProjection = projection * m_lightView;
+   cascade.Center = center;
+   cascade.Radius = radius;
+   cascade.TexelSize = texelSize;
+   cascade.Dirty = true;
+}
+
+void CascadedShadowMap::Update( const glm::mat4& view, float fovY, float aspect, float nearPlane, const DirectionalLight& light )
+{
+   m_lightColor = light.Color;
+   glm::vec3 direction = glm::normalize( light.Direction );
+   if ( direction != m_lightDirection )
+   {
+      glm::vec3 up = ( std::abs( direction.y ) > 0.99f ) ? glm::vec3( 0.0f, 0.0f, 1.0f ) : glm::vec3( 0.0f, 1.0f, 0.0f );
+      m_lightView = glm::lookAt( glm::vec3( 0.0f ), direction, up );
+      m_lightDirection = direction;
+      InvalidateCache( );
+   }
+
+   float farPlane = m_settings.ShadowDistance;
+   float tanHalfY = std::tan( fovY * 0.5f );
+   float tanHalfX = tanHalfY * aspect;
+   float cornerScale = tanHalfX * tanHalfX + tanHalfY * tanHalfY;
+   glm::mat4 inverseView = glm::inverse( view );
+
+   float sliceNear = nearPlane;
+   for ( unsigned int idx = 0; idx < CascadeCount; ++idx )
+   {
+      // Practical split scheme
+      float ratio = static_cast<float>( idx + 1 ) / CascadeCount;
+      float logSplit = nearPlane * std::pow( farPlane / nearPlane, ratio );
+      float uniformSplit = nearPlane + ( farPlane - nearPlane ) * ratio;
+      float sliceFar = m_settings.SplitLambda * logSplit + ( 1.0f - m_settings.SplitLambda ) * uniformSplit;
+      m_splits[ idx ] = sliceFar;
+
+      // Smallest sphere around the slice, centered on the view axis where near and far corners are equidistant.
+      // Depends only on the projection, so rotating the camera never changes its size.
+      float nearSq = sliceNear * sliceNear * cornerScale;
+      float farSq = sliceFar * sliceFar * cornerScale;
+      float centerDepth = ( sliceFar * sliceFar - sliceNear * sliceNear + farSq - nearSq ) / ( 2.0f * ( sliceFar - sliceNear ) );
+      // Wide slices put that point past the far plane, the center is clamped there and the far corners bound the sphere
+      centerDepth = std::min( centerDepth, sliceFar );
+      float nearCornerDistance = std::sqrt( ( centerDepth - sliceNear ) * ( centerDepth - sliceNear ) + nearSq );
+      float farCornerDistance = std::sqrt( ( sliceFar - centerDepth ) * ( sliceFar - centerDepth ) + farSq );
+      float radius = std::max( nearCornerDistance, farCornerDistance );
+      radius = std::ceil( radius * 16.0f ) / 16.0f;
+      glm::vec3 center = glm::vec3( inverseView * glm::vec4( 0.0f, 0.0f, -centerDepth, 1.0f ) );
+      sliceNear = sliceFar;
+
+      Cascade& cascade = m_cascades[ idx ];
+      if ( idx < m_settings.FirstCachedCascade )
+      {
+         FitCascade( cascade, center, radius );
+         continue;
+      }
+
+      // Cached: kept while the slice sphere stays inside the covered one
+      bool covered = !cascade.Dirty && glm::length( center - cascade.Center ) + radius <= cascade.Radius &&
+                     radius * m_settings.CacheMargin <= cascade.Radius * 1.001f;
+      if ( !covered )
+      {
+         FitCascade( cascade, center, radius * m_settings.CacheMargin );
+      }
+   }
+}
+
+FrameGraphResource CascadedShadowMap::AddPass( FrameGraph& frameGraph, const DrawCallback& drawCasters )
+{
+   FrameGraphResource shadowMap = frameGraph.Import( "Cascaded Shadow Map", m_texture, m_settings.Resolution, m_settings.Resolution );
+
+   frameGraph.AddPass( "Cascaded Shadows",
+                       [ & ]( FrameGraphBuilder& builder )
+   {
+      builder.Write( shadowMap );
+   },
+                       [ this, drawCasters ]( const FrameGraphPassContext& )
+   {
+      m_renderedCascadeCount = 0;
+      bool rendered[ CascadeCount ] = { };
+      glViewport( 0, 0, m_settings.Resolution, m_settings.Resolution );
+      glEnable( GL_DEPTH_CLAMP );
+      m_depthShader.Use( );
+      for ( unsigned int idx = 0; idx < CascadeCount; ++idx )
+      {
+         Cascade& cascade = m_cascades[ idx ];
+         if ( !cascade.Dirty )
+         {
+            continue;
+         }
+
+         glBindFramebuffer( GL_FRAMEBUFFER, m_framebuffers[ idx ] );
+         glClear( GL_DEPTH_BUFFER_BIT );
+         m_depthShader.SetMat4f( "lightSpaceMatrix", cascade.ViewProjection );
+         drawCasters( m_depthShader, idx >= m_settings.FirstCachedCascade );
+
+         cascade.Dirty = false;
+         rendered[ idx ] = true;
+         ++m_renderedCascadeCount;
+      }
+      glDisable( GL_DEPTH_CLAMP );
+
+      if ( m_settings.Filter == ShadowFilter::EVSM )
+      {
+         for ( unsigned int idx = 0; idx < CascadeCount; ++idx )
+         {
+            if ( rendered[ idx ] )
+            {
+               UpdateMoments( idx );
+            }
+         }
+      }
+   } );
+
+   return shadowMap;
+}
+
+void CascadedShadowMap::UpdateMoments( unsigned int cascade )
+{
+   unsigned int resolution = m_settings.Resolution / 2;
+   glViewport( 0, 0, resolution, resolution );
+   glDisable( GL_DEPTH_TEST );
+   glBindFramebuffer( GL_FRAMEBUFFER, m_momentsFramebuffer );
+
+   // Warp + 2x2 downsample into the cascade layer
+   glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_momentsTexture, 0, cascade );
+   m_momentsShader.Use( );
+   m_momentsShader.SetInt( "depthMap", 0 );
+   m_momentsShader.SetInt( "layer", cascade );
+   m_momentsShader.SetVec2f( "exponents", m_settings.EVSMExponents );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, m_texture );
+   glBindSampler( 0, m_depthSampler );
+   renderQuad( );
+   glBindSampler( 0, 0 );
+
+   // Separable gaussian, layer => blur texture => layer
+   m_momentsBlurShader.Use( );
+   m_momentsBlurShader.SetInt( "image", 0 );
+   m_momentsBlurShader.SetInt( "tapCount", m_momentsKernel.GetTapCount( ) );
+   m_momentsBlurShader.SetFloatArray( "weights", m_momentsKernel.Weights.data( ), m_momentsKernel.GetTapCount( ) );
+   m_momentsBlurShader.SetFloatArray( "offsets", m_momentsKernel.Offsets.data( ), m_momentsKernel.GetTapCount( ) );
+
+   glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_momentsBlurTexture, 0, 0 );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, m_momentsTexture );
+   m_momentsBlurShader.SetInt( "layer", cascade );
+   m_momentsBlurShader.SetVec2f( "direction", 1.0f / resolution, 0.0f );
+   renderQuad( );
+
+   glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_momentsTexture, 0, cascade );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, m_momentsBlurTexture );
+   m_momentsBlurShader.SetInt( "layer", 0 );
+   m_momentsBlurShader.SetVec2f( "direction", 0.0f, 1.0f / resolution );
+   renderQuad( );
+
+   glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+   glEnable( GL_DEPTH_TEST );
+}
+
+void CascadedShadowMap::Bind( const Shader& shader, unsigned int textureUnit ) const
+{
+   glActiveTexture( GL_TEXTURE0 + textureUnit );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, m_texture );
+   shader.SetInt( "cascadeShadowMap", textureUnit );
+   glActiveTexture( GL_TEXTURE0 + textureUnit + 1 );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, m_momentsTexture );
+   shader.SetInt( "cascadeMoments", textureUnit + 1 );
+   glActiveTexture( GL_TEXTURE0 );
+
+   glm::mat4 matrices[ CascadeCount ];
+   float texelSizes[ CascadeCount ];
+   for ( unsigned int idx = 0; idx < CascadeCount; ++idx )
+   {
+      matrices[ idx ] = m_cascades[ idx ].ViewProjection;
+      texelSizes[ idx ] = m_cascades[ idx ].TexelSize;
+   }
+   shader.SetMat4fArray( "cascadeMatrices", matrices, CascadeCount );
+   shader.SetFloatArray( "cascadeSplits", m_splits, CascadeCount );
+   shader.SetFloatArray( "cascadeTexelSizes", texelSizes, CascadeCount );
+   shader.SetFloat( "cascadeBlendBand", m_settings.BlendBand );
+   shader.SetFloat( "shadowFilterRadius", m_settings.PoissonRadius );
+   shader.SetVec2f( "evsmExponents", m_settings.EVSMExponents );
+   shader.SetFloat( "evsmBleedReduction", m_settings.EVSMBleedReduction );
+   shader.SetVec3f( "sunDirection", m_lightDirection );
+   shader.SetVec3f( "sunColor", m_lightColor );
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include "Shader.h"
+#include "FrameGraph.h"
+#include "GaussianKernel.h"
+#include "ShadowFilter.h"
+
+#include <functional>
+
+struct CascadedShadowSettings
+{
+   unsigned int Resolution = 2048;        // Per cascade
+   float ShadowDistance = 40.0f;          // View depth covered by the last cascade
+   float SplitLambda = 0.75f;             // 0 = uniform splits, 1 = logarithmic
+   float BlendBand = 0.15f;               // Last fraction of a cascade cross faded into the next one
+   unsigned int FirstCachedCascade = 2;   // Cascades from here on are cached
+   float CacheMargin = 1.25f;             // Cached cascades cover this much more than their slice needs
+
+   ShadowFilter Filter = ShadowFilter::Hardware;
+   float PoissonRadius = 2.0f;                           // In shadow texels
+   glm::vec2 EVSMExponents = glm::vec2( 40.0f, 5.0f );   // Positive / negative warp, 40 is the 32 bit float limit
+   float EVSMBleedReduction = 0.3f;                      // Cuts this much off the Chebyshev tail
+   float EVSMBlurSigma = 1.0f;                           // In moments texels
+};
+
+struct DirectionalLight
+{
+   glm::vec3 Direction;  // Direction light travels in
+   glm::vec3 Color;
+};
+
+// Cascaded shadow maps for a directional light.
+// The view frustum is split with the practical scheme( blend of uniform and logarithmic splits ), every slice
+// is bounded by a sphere so the cascade size never changes with camera rotation, and the cascade origin is
+// snapped to whole shadow texels so edges do not shimmer while the camera moves.
+// Cascades live in one depth texture array sampled with hardware comparison( sampler2DArrayShadow ).
+// With ShadowFilter::EVSM every redrawn cascade is also converted into warped moments at half resolution and
+// blurred once, shading then filters with a single bilinear tap instead of a PCF kernel.
+// Far cascades are cached: rendered with some margin, they are only redrawn when the light direction changes,
+// the static casters are invalidated or the camera leaves the covered area.
+class CascadedShadowMap
+{
+public:
+   static constexpr unsigned int CascadeCount = 4;  // Bloom.fs / DeferredLighting.fs CascadeCount
+
+   // 'staticOnly' is set for cached cascades, dynamic casters would leave stale shadows in them
+   using DrawCallback = std::function<void( const Shader&, bool staticOnly )>;
+
+public:
+   CascadedShadowMap( );
+   ~CascadedShadowMap( );
+
+   CascadedShadowMap( const CascadedShadowMap& ) = delete;
+   CascadedShadowMap& operator=( const CascadedShadowMap& ) = delete;
+
+   void SetSettings( const CascadedShadowSettings& settings );
+   const CascadedShadowSettings& GetSettings( ) const { return m_settings; }
+
+   // Switches the filter tier, EVSM storage only exists while it is selected.
+   void SetFilter( ShadowFilter filter );
+
+   // Static casters changed, cached cascades are redrawn next frame.
+   void InvalidateCache( );
+
+   // Fits the cascades to the camera frustum.
+   void Update( const glm::mat4& view, float fovY, float aspect, float nearPlane, const DirectionalLight& light );
+
+   // Adds the depth pass for the cascades which need it, 'drawCasters' sets 'model' and draws.
+   // Returned resource is the imported texture array, read it from every pass that samples shadows.
+   FrameGraphResource AddPass( FrameGraph& frameGraph, const DrawCallback& drawCasters );
+
+   // Binds the cascades to 'textureUnit', EVSM moments to 'textureUnit' + 1 and sets cascade, filter and sun uniforms.
+   // The tier itself is compiled in( GetShaderDefine ), point shadows follow the same filter uniforms. Shader must be in use.
+   void Bind( const Shader& shader, unsigned int textureUnit ) const;
+
+   // Cascades drawn by the last executed pass
+   unsigned int GetRenderedCascadeCount( ) const { return m_renderedCascadeCount; }
+
+private:
+   struct Cascade
+   {
+      glm::mat4 ViewProjection;
+      glm::vec3 Center;          // World space center of the covered sphere
+      float Radius = 0.0f;       // Covered radius, > slice radius for cached cascades
+      float TexelSize = 0.0f;    // World size of one shadow texel
+      bool Dirty = true;
+   };
+
+   void CreateStorage( );
+   void CreateMomentsStorage( );
+   void DestroyMomentsStorage( );
+   void FitCascade( Cascade& cascade, const glm::vec3& center, float radius ) const;
+   void UpdateMoments( unsigned int cascade );
+
+private:
+   CascadedShadowSettings m_settings;
+   Shader m_depthShader;
+   Shader m_momentsShader;
+   Shader m_momentsBlurShader;
+   GaussianKernel m_momentsKernel;
+
+   unsigned int m_texture;
+   unsigned int m_framebuffers[ CascadeCount ];
+
+   // EVSM, 0 unless selected
+   unsigned int m_momentsTexture;       // RGBA32F array, half resolution
+   unsigned int m_momentsBlurTexture;   // One layer, horizontal blur result
+   unsigned int m_momentsFramebuffer;   // Layers attached per draw
+   unsigned int m_depthSampler;         // Raw depth reads, overrides the compare mode of m_texture
+
+   Cascade m_cascades[ CascadeCount ];
+   float m_splits[ CascadeCount ];   // Far view depth of each cascade
+   glm::mat4 m_lightView;
+   glm::vec3 m_lightDirection;
+   glm::vec3 m_lightColor;
+   unsigned int m_renderedCascadeCount;
+
+};
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "ClusteredLighting.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+   enum ClusterBuffer
+   {
+      ClusterData = 0,
+      LightIndices
+   };
+
+   // Orphans the old storage so the driver does not wait for draws still reading it
+   void UploadBuffer( unsigned int buffer, const void* data, size_t bytes )
+   {
+      glBindBuffer( GL_TEXTURE_BUFFER, buffer );
+      glBufferData( GL_TEXTURE_BUFFER, std::max( bytes, size_t( 16 ) ), nullptr, GL_STREAM_DRAW );
+      if ( bytes > 0 )
+      {
+         glBufferSubData( GL_TEXTURE_BUFFER, 0, bytes, data );
+      }
+   }
+}
+
+ClusteredLighting::ClusteredLighting( ) :
+   m_fovY( 0.0f ),
+   m_aspect( 0.0f ),
+   m_nearPlane( 0.0f ),
+   m_farPlane( 0.0f ),
+   m_clusterLights( ClusterCount ),
+   m_clusterData( ClusterCount * 2, 0 ),
+   m_lights( nullptr ),
+   m_maxLightsPerCluster( 0 ),
+   m_totalAssignments( 0 ),
+   m_assignmentMs( 0.0f )
+{
+   const GLenum formats[ 2 ] = { GL_RG32UI, GL_R32UI };
+
+   glGenBuffers( 2, m_buffers );
+   glGenTextures( 2, m_textures );
+   for ( unsigned int idx = 0; idx < 2; ++idx )
+   {
+      UploadBuffer( m_buffers[ idx ], nullptr, 0 );
+      glBindTexture( GL_TEXTURE_BUFFER, m_textures[ idx ] );
+      glTexBuffer( GL_TEXTURE_BUFFER, formats[ idx ], m_buffers[ idx ] );
+   }
+   glBindTexture( GL_TEXTURE_BUFFER, 0 );
+   glBindBuffer( GL_TEXTURE_BUFFER, 0 );
+}
+
+ClusteredLighting::~ClusteredLighting( )
+{
+   glDeleteTextures( 2, m_textures );
+   glDeleteBuffers( 2, m_buffers );
+}
+
+float ClusteredLighting::SliceDepth( unsigned int slice ) const
+{
+   return m_nearPlane * std::pow( m_farPlane / m_nearPlane, static_cast<float>( slice ) / GridZ );
+}
+
+unsigned int ClusteredLighting::DepthToSlice( float depth ) const
+{
+   if ( depth <= m_nearPlane )
+   {
+      return 0;
+   }
+
+   float slice = std::log( depth / m_nearPlane ) / std::log( m_farPlane / m_nearPlane ) * GridZ;
+   return std::min( static_cast<unsigned int>( slice ), GridZ - 1 );
+}
+
+void ClusteredLighting::BuildClusterBounds( float fovY, float aspect, float nearPlane, float farPlane )
+{
+   m_fovY = fovY;
+   m_aspect = aspect;
+   m_nearPlane = nearPlane;
+   m_farPlane = farPlane;
+
+   float tanHalfY = std::tan( fovY * 0.5f );
+   float tanHalfX = tanHalfY * aspect;
+
+   m_bounds.resize( ClusterCount );
+   for ( unsigned int z = 0; z < GridZ; ++z )
+   {
+      float depths[ 2 ] = { SliceDepth( z ), SliceDepth( z + 1 ) };
+      for ( unsigned int y = 0; y < GridY; ++y )
+      {
+         for ( unsigned int x = 0; x < GridX; ++x )
+         {
+            float ndcX[ 2 ] = { -1.0f + 2.0f * x / GridX, -1.0f + 2.0f * ( x + 1 ) / GridX };
+            float ndcY[ 2 ] = { -1.0f + 2.0f * y / GridY, -1.0f + 2.0f * ( y + 1 ) / GridY };
+
+            // 8 corners of the froxel in view space( camera looks down -z )
+            ClusterBounds bounds{ glm::vec3( FLT_MAX ), glm::vec3( -FLT_MAX ) };
+            for ( float depth : depths )
+            {
+               for ( float nx : ndcX )
+               {
+                  for ( float ny : ndcY )
+                  {
+                     glm::vec3 corner( nx * depth * tanHalfX, ny * depth * tanHalfY, -depth );
+                     bounds.Min = glm::min( bounds.Min, corner );
+                     bounds.Max = glm::max( bounds.Max, corner );
+                  }
+               }
+            }
+
+            m_bounds[ ( z * GridY + y ) * GridX + x ] = bounds;
+         }
+      }
+   }
+}
+
+void ClusteredLighting::Update( const LightManager& lights, const glm::mat4& view,
+                                float fovY, float aspect, float nearPlane, float farPlane )
+{
+   auto begin = std::chrono::high_resolution_clock::now( );
+
+   if ( fovY != m_fovY || aspect != m_aspect || nearPlane != m_nearPlane || farPlane != m_farPlane )
+   {
+      BuildClusterBounds( fovY, aspect, nearPlane, farPlane );
+   }
+
+   for ( auto& clusterLights : m_clusterLights )
+   {
+      clusterLights.clear( );
+   }
+
+   float tanHalfY = std::tan( fovY * 0.5f );
+   float tanHalfX = tanHalfY * aspect;
+
+   // Every light to view space and against the view frustum in one batch, only survivors are assigned
+   m_lights = &lights;
+   const std::vector<float>& radii = lights.GetRadii( );
+   TransformPoints( view, lights.GetPositions( ).data( ), lights.GetCount( ), m_viewCenters );
+
+   glm::vec4 frustumPlanes[ 6 ];
+   ExtractFrustumPlanes( glm::perspective( fovY, aspect, nearPlane, farPlane ), frustumPlanes );
+   m_visibleLights.resize( lights.GetCount( ) );
+   size_t visibleCount = CullSpheres( frustumPlanes, m_viewCenters.X.data( ), m_viewCenters.Y.data( ), m_viewCenters.Z.data( ),
+                                      radii.data( ), lights.GetCount( ), m_visibleLights.data( ) );
+
+   // Tile / slice range of every visible light first, then froxels are filled one depth slice per job so no two jobs
+   // touch the same cluster list. Lights keep their visible order inside every list.
+   m_lightRanges.resize( visibleCount );
+   ParallelFor( visibleCount, 64, [ & ]( size_t begin, size_t end )
+   {
+      for ( size_t visibleIdx = begin; visibleIdx < end; ++visibleIdx )
+      {
+         unsigned int lightIdx = m_visibleLights[ visibleIdx ];
+         glm::vec3 center( m_viewCenters.X[ lightIdx ], m_viewCenters.Y[ lightIdx ], m_viewCenters.Z[ lightIdx ] );
+         float radius = radii[ lightIdx ];
+         float minDepth = -center.z - radius;
+         float maxDepth = -center.z + radius;
+
+         // Conservative tile range: x / depth is monotonic in depth, so extremes lie at the nearest or farthest depth
+         LightRange& range = m_lightRanges[ visibleIdx ];
+         range.TileMin[ 0 ] = 0;
+         range.TileMin[ 1 ] = 0;
+         range.TileMax[ 0 ] = GridX - 1;
+         range.TileMax[ 1 ] = GridY - 1;
+         if ( minDepth > nearPlane )
+         {
+            const float tanHalf[ 2 ] = { tanHalfX, tanHalfY };
+            const unsigned int grid[ 2 ] = { GridX, GridY };
+            for ( unsigned int axis = 0; axis < 2; ++axis )
+            {
+               float lo = FLT_MAX;
+               float hi = -FLT_MAX;
+               for ( float depth : { minDepth, maxDepth } )
+               {
+                  lo = std::min( lo, ( center[ axis ] - radius ) / ( depth * tanHalf[ axis ] ) );
+                  hi = std::max( hi, ( center[ axis ] + radius ) / ( depth * tanHalf[ axis ] ) );
+               }
+
+               if ( hi < -1.0f || lo > 1.0f )
+               {
+                  range.TileMin[ axis ] = 1;
+                  range.TileMax[ axis ] = 0;
+                  break;
+               }
+
+               range.TileMin[ axis ] = static_cast<unsigned int>( std::max( 0.0f, ( lo + 1.0f ) * 0.5f * grid[ axis ] ) );
+               range.TileMax[ axis ] = std::min( static_cast<unsigned int>( std::max( 0.0f, ( hi + 1.0f ) * 0.5f * grid[ axis ] ) ), grid[ axis ] - 1 );
+            }
+         }
+
+         range.SliceMin = DepthToSlice( minDepth );
+         range.SliceMax = DepthToSlice( maxDepth );
+      }
+   } );
+
+   ParallelFor( GridZ, 1, [ & ]( size_t begin, size_t end )
+   {
+      for ( unsigned int z = static_cast<unsigned int>( begin ); z < end; ++z )
+      {
+         for ( size_t visibleIdx = 0; visibleIdx < visibleCount; ++visibleIdx )
+         {
+            const LightRange& range = m_lightRanges[ visibleIdx ];
+            if ( z < range.SliceMin || z > range.SliceMax )
+            {
+               continue;
+            }
+
+            unsigned int lightIdx = m_visibleLights[ visibleIdx ];
+            glm::vec3 center( m_viewCenters.X[ lightIdx ], m_viewCenters.Y[ lightIdx ], m_viewCenters.Z[ lightIdx ] );
+            float radius = radii[ lightIdx ];
+            for ( unsigned int y = range.TileMin[ 1 ]; y <= range.TileMax[ 1 ]; ++y )
+            {
+               for ( unsigned int x = range.TileMin[ 0 ]; x <= range.TileMax[ 0 ]; ++x )
+               {
+                  unsigned int clusterIdx = ( z * GridY + y ) * GridX + x;
+                  const ClusterBounds& bounds = m_bounds[ clusterIdx ];
+
+                  // Sphere vs froxel AABB
+                  glm::vec3 closest = glm::clamp( center, bounds.Min, bounds.Max );
+                  glm::vec3 delta = closest - center;
+                  if ( glm::dot( delta, delta ) <= radius * radius )
+                  {
+                     m_clusterLights[ clusterIdx ].push_back( lightIdx );
+                  }
+               }
+            }
+         }
+      }
+   } );
+
+   // Flatten into offset / count pairs
+   m_lightIndices.clear( );
+   m_maxLightsPerCluster = 0;
+   for ( unsigned int clusterIdx = 0; clusterIdx < ClusterCount; ++clusterIdx )
+   {
+      const auto& clusterLights = m_clusterLights[ clusterIdx ];
+      m_clusterData[ clusterIdx * 2 ] = static_cast<unsigned int>( m_lightIndices.size( ) );
+      m_clusterData[ clusterIdx * 2 + 1 ] = static_cast<unsigned int>( clusterLights.size( ) );
+      m_lightIndices.insert( m_lightIndices.end( ), clusterLights.begin( ), clusterLights.end( ) );
+      m_maxLightsPerCluster = std::max( m_maxLightsPerCluster, static_cast<unsigned int>( clusterLights.size( ) ) );
+   }
+   m_totalAssignments = static_cast<unsigned int>( m_lightIndices.size( ) );
+
+   UploadBuffer( m_buffers[ ClusterData ], m_clusterData.data( ), m_clusterData.size( ) * sizeof( unsigned int ) );
+   UploadBuffer( m_buffers[ LightIndices ], m_lightIndices.data( ), m_lightIndices.size( ) * sizeof( unsigned int ) );
+   glBindBuffer( GL_TEXTURE_BUFFER, 0 );
+
+   auto end = std::chrono::high_resolution_clock::now( );
+   m_assignmentMs = std::chrono::duration<float, std::milli>( end - begin ).count( );
+}
+
+void ClusteredLighting::Bind( const Shader& shader, unsigned int textureUnit, const glm::vec2& screenSize ) const
+{
+   m_lights->Bind( shader, textureUnit );
+
+   const char* samplerNames[ 2 ] = { "clusterData", "lightIndices" };
+   for ( unsigned int idx = 0; idx < 2; ++idx )
+   {
+      glActiveTexture( GL_TEXTURE0 + textureUnit + 1 + idx );
+      glBindTexture( GL_TEXTURE_BUFFER, m_textures[ idx ] );
+      shader.SetInt( samplerNames[ idx ], textureUnit + 1 + idx );
+   }
+   glActiveTexture( GL_TEXTURE0 );
+
+   // slice = log( depth ) * scale + bias
+   float logRatio = std::log( m_farPlane / m_nearPlane );
+   shader.SetVec3f( "clusterGrid", static_cast<float>( GridX ), static_cast<float>( GridY ), static_cast<float>( GridZ ) );
+   shader.SetVec2f( "clusterScreenSize", screenSize );
+   shader.SetFloat( "clusterDepthScale", GridZ / logRatio );
+   shader.SetFloat( "clusterDepthBias", -GridZ * std::log( m_nearPlane ) / logRatio );
+}
+
+float ClusteredLighting::GetAverageLightsPerCluster( ) const
+{
+   return static_cast<float>( m_totalAssignments ) / ClusterCount;
+}
\ No newline at end of file
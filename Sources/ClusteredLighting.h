@@ -0,0 +1,89 @@
+#pragma once
+#include "LightManager.h"
+#include "BatchMath.h"
+#include "Shader.h"
+
+#include <vector>
+
+// Clustered forward light culling.
+// The view frustum is split into GridX x GridY screen tiles and GridZ exponential depth slices( froxels ).
+// Lights are assigned to every froxel their sphere touches on the CPU( one job per depth slice ), then two texture buffers are uploaded
+// next to the packed light buffer of the LightManager( lightData ):
+//  clusterData  : offset and count into lightIndices per froxel
+//  lightIndices : concatenated light lists
+// Fragments locate their froxel from gl_FragCoord and view depth and only loop over its list.
+class ClusteredLighting
+{
+public:
+   ClusteredLighting( );
+   ~ClusteredLighting( );
+
+   ClusteredLighting( const ClusteredLighting& ) = delete;
+   ClusteredLighting& operator=( const ClusteredLighting& ) = delete;
+
+   // Rebuilds froxel lists for the given camera and uploads them.
+   // 'lights' must outlive the following Bind calls, its Upload( ) is left to the caller.
+   void Update( const LightManager& lights, const glm::mat4& view,
+                float fovY, float aspect, float nearPlane, float farPlane );
+
+   // Binds lightData, clusterData and lightIndices to textureUnit..textureUnit+2 and sets cluster uniforms. Shader must be in use.
+   // 'screenSize' is the size of the target the shader renders into.
+   void Bind( const Shader& shader, unsigned int textureUnit, const glm::vec2& screenSize ) const;
+
+   // Stats of the last update
+   unsigned int GetMaxLightsPerCluster( ) const { return m_maxLightsPerCluster; }
+   float GetAverageLightsPerCluster( ) const;
+   float GetAssignmentMs( ) const { return m_assignmentMs; }
+
+   static constexpr unsigned int GridX = 16;
+   static constexpr unsigned int GridY = 9;
+   static constexpr unsigned int GridZ = 24;
+   static constexpr unsigned int ClusterCount = GridX * GridY * GridZ;
+
+private:
+   struct ClusterBounds
+   {
+      glm::vec3 Min;
+      glm::vec3 Max;
+   };
+
+   // Froxel range a visible light may touch, tile ranges can be empty( min > max )
+   struct LightRange
+   {
+      unsigned int TileMin[ 2 ];
+      unsigned int TileMax[ 2 ];
+      unsigned int SliceMin;
+      unsigned int SliceMax;
+   };
+
+   void BuildClusterBounds( float fovY, float aspect, float nearPlane, float farPlane );
+   float SliceDepth( unsigned int slice ) const;
+   unsigned int DepthToSlice( float depth ) const;
+
+private:
+   // View space AABB of every froxel, rebuilt only when the projection changes
+   std::vector<ClusterBounds> m_bounds;
+   float m_fovY;
+   float m_aspect;
+   float m_nearPlane;
+   float m_farPlane;
+
+   // Reused every frame, no allocation once capacity is reached
+   std::vector<std::vector<unsigned int>> m_clusterLights;
+   std::vector<unsigned int> m_clusterData;
+   std::vector<unsigned int> m_lightIndices;
+
+   // View space light centers and the lights inside the view frustum( BatchMath )
+   PointArray m_viewCenters;
+   std::vector<uint32_t> m_visibleLights;
+   std::vector<LightRange> m_lightRanges;
+
+   const LightManager* m_lights;
+   unsigned int m_buffers[ 2 ];
+   unsigned int m_textures[ 2 ];
+
+   unsigned int m_maxLightsPerCluster;
+   unsigned int m_totalAssignments;
+   float m_assignmentMs;
+
+};
\ No newline at end of file
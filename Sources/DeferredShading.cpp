@@ -0,0 +1,84 @@
+#include "DeferredShading.h"
+#include "Primitives.h"
+
+const char* ToString( RenderPath path )
+{
+   switch ( path )
+   {
+   case RenderPath::Forward:
+      return "Forward";
+   case RenderPath::Deferred:
+      return "Deferred";
+   default:
+      break;
+   }
+
+   return "Unknown";
+}
+
+std::vector<ShaderPermutations::Defines> GetShadowPermutations( )
+{
+   std::vector<ShaderPermutations::Defines> defineSets;
+   for ( int filter = 0; filter < static_cast<int>( ShadowFilter::EnumMax ); ++filter )
+   {
+      for ( int mode = 0; mode < static_cast<int>( PointShadowMode::EnumMax ); ++mode )
+      {
+         defineSets.push_back( { GetShaderDefine( static_cast<ShadowFilter>( filter ) ),
+                                 GetShaderDefine( static_cast<PointShadowMode>( mode ) ) } );
+      }
+   }
+
+   return defineSets;
+}
+
+DeferredShading::DeferredShading( ) :
+   m_geometryShader( "../Resources/Shaders/Bloom.vs", "../Resources/Shaders/GBuffer.fs" ),
+   m_lightingShaders( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/DeferredLighting.fs", [ ]( Shader& shader )
+   {
+      shader.SetInt( "gAlbedo", 0 );
+      shader.SetInt( "gNormal", 1 );
+      shader.SetInt( "gDepth", 2 );
+   } ),
+   m_lightingShader( nullptr ),
+   m_lightingFilter( ShadowFilter::Hardware ),
+   m_lightingMode( PointShadowMode::CubeMap )
+{
+   m_geometryShader.Use( );
+   m_geometryShader.SetInt( "diffuseMap", 0 );
+}
+
+void DeferredShading::Light( const ClusteredLighting& clusters, const CascadedShadowMap& shadows, const PointShadowRenderer& pointShadows,
+                             const IrradianceSH& ambient, const PrefilteredEnvironment& environment, float ambientIntensity,
+                             unsigned int albedo, unsigned int normal, unsigned int depth, const glm::mat4& view, const glm::mat4& projection, const glm::vec2& screenSize, const glm::vec3& backgroundColor )
+{
+   ShadowFilter filter = shadows.GetSettings( ).Filter;
+   if ( m_lightingShader == nullptr || filter != m_lightingFilter || pointShadows.GetMode( ) != m_lightingMode )
+   {
+      m_lightingShader = &m_lightingShaders.Get( { GetShaderDefine( filter ), GetShaderDefine( pointShadows.GetMode( ) ) } );
+      m_lightingFilter = filter;
+      m_lightingMode = pointShadows.GetMode( );
+   }
+   Shader& lightingShader = *m_lightingShader;
+   lightingShader.Use( );
+   lightingShader.SetMat4f( "inverseViewProjection", glm::inverse( projection * view ) );
+   lightingShader.SetMat4f( "view", view );
+   lightingShader.SetVec3f( "viewPos", glm::vec3( glm::inverse( view )[ 3 ] ) );
+   lightingShader.SetVec3f( "backgroundColor", backgroundColor );
+   clusters.Bind( lightingShader, 4, screenSize );
+   shadows.Bind( lightingShader, 7 );
+   pointShadows.Bind( lightingShader, 9 );
+   ambient.Bind( lightingShader, ambientIntensity );
+   environment.Bind( lightingShader, 10, ambientIntensity );
+
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D, albedo );
+   glActiveTexture( GL_TEXTURE1 );
+   glBindTexture( GL_TEXTURE_2D, normal );
+   glActiveTexture( GL_TEXTURE2 );
+   glBindTexture( GL_TEXTURE_2D, depth );
+
+   glDisable( GL_DEPTH_TEST );
+   renderQuad( );
+   glEnable( GL_DEPTH_TEST );
+   glActiveTexture( GL_TEXTURE0 );
+}
\ No newline at end of file
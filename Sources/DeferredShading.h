@@ -0,0 +1,54 @@
+#pragma once
+#include "Shader.h"
+#include "ShaderPermutations.h"
+#include "ClusteredLighting.h"
+#include "CascadedShadowMap.h"
+#include "PointShadowRenderer.h"
+#include "IrradianceSH.h"
+#include "PrefilteredEnvironment.h"
+
+enum class RenderPath
+{
+   Forward = 0,   // Bloom.fs shades while rasterizing
+   Deferred,      // GBuffer.fs + DeferredLighting.fs
+   EnumMax
+};
+
+const char* ToString( RenderPath path );
+
+// Every SHADOW_FILTER x POINT_SHADOW_MODE define set the scene and lighting shaders can be asked for.
+std::vector<ShaderPermutations::Defines> GetShadowPermutations( );
+
+// Deferred shading path. Geometry is rasterized once into a compact G-buffer, then a single full screen
+// pass shades every visible pixel with its cluster's lights( ClusteredLighting lists are shared with forward )
+// and the shadowed sun.
+class DeferredShading
+{
+public:
+   static constexpr GLenum AlbedoFormat = GL_RGBA8;
+   static constexpr GLenum NormalFormat = GL_RG16;  // Octahedral encoding
+
+public:
+   DeferredShading( );
+
+   // Vertex stage is Bloom.vs, takes the same uniforms.
+   Shader& GetGeometryShader( ) { return m_geometryShader; }
+
+   // Submits the lighting pass for every shadow filter / point shadow mode, see ShaderPermutations.
+   void Prewarm( ) { m_lightingShaders.Prewarm( GetShadowPermutations( ) ); }
+   void FinishPrewarm( ) { m_lightingShaders.FinishPrewarm( ); }
+
+   // Writes HDR color( location 0 ) and bright color( location 1 ) into currently bound framebuffer.
+   // 'projection' must be the one the G-buffer was rendered with( jittered under TAA ).
+   void Light( const ClusteredLighting& clusters, const CascadedShadowMap& shadows, const PointShadowRenderer& pointShadows,
+               const IrradianceSH& ambient, const PrefilteredEnvironment& environment, float ambientIntensity,
+               unsigned int albedo, unsigned int normal, unsigned int depth, const glm::mat4& view, const glm::mat4& projection, const glm::vec2& screenSize, const glm::vec3& backgroundColor );
+
+private:
+   Shader m_geometryShader;
+   ShaderPermutations m_lightingShaders;
+   Shader* m_lightingShader;   // Permutation of the current shadow settings
+   ShadowFilter m_lightingFilter;
+   PointShadowMode m_lightingMode;
+
+};
\ No newline at end of file
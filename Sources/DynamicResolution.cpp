@@ -0,0 +1,75 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+DynamicResolution::DynamicResolution( const DynamicResolutionSettings& settings ) :
+   m_settings( settings ),
+   m_enabled( true ),
+   m_scale( settings.MaxScale ),
+   m_smoothedMs( 0.0f ),
+   m_settleFrames( SettleFrames )
+{
+}
+
+void DynamicResolution::SetSettings( const DynamicResolutionSettings& settings )
+{
+   m_settings = settings;
+   m_scale = Quantize( m_scale );
+}
+
+void DynamicResolution::SetEnabled( bool enabled )
+{
+   m_enabled = enabled;
+   m_scale = m_settings.MaxScale;
+   m_settleFrames = SettleFrames;
+}
+
+float DynamicResolution::Update( )
+{
+   // Keep measuring while disabled, frame time is still reported
+   float frameMs = m_timer.ConsumeAverageMs( );
+   m_smoothedMs = ( m_smoothedMs > 0.0f ) ? m_smoothedMs + ( frameMs - m_smoothedMs ) * SmoothingFactor : frameMs;
+   if ( !m_enabled )
+   {
+      return m_scale;
+   }
+
+   if ( m_settleFrames > 0 )
+   {
+      --m_settleFrames;
+      return m_scale;
+   }
+
+   float newScale = m_scale;
+   if ( m_smoothedMs > m_settings.TargetFrameMs )
+   {
+      // Cost is roughly proportional to pixel count( scale^2 ), jump straight to the estimated scale
+      float estimated = m_scale * std::sqrt( m_settings.TargetFrameMs / m_smoothedMs );
+      newScale = std::min( Quantize( estimated ), m_scale - m_settings.ScaleStep );
+   }
+   else if ( m_smoothedMs < m_settings.TargetFrameMs * m_settings.IncreaseHeadroom )
+   {
+      newScale = m_scale + m_settings.ScaleStep;
+   }
+
+   newScale = std::min( std::max( newScale, m_settings.MinScale ), m_settings.MaxScale );
+   if ( std::abs( newScale - m_scale ) > 0.001f )
+   {
+      m_scale = newScale;
+      m_settleFrames = SettleFrames;
+
+      // Measurements taken at the old scale are meaningless now
+      m_smoothedMs = 0.0f;
+   }
+
+   return m_scale;
+}
+
+float DynamicResolution::Quantize( float scale ) const
+{
+   // Small bias keeps exact multiples from rounding one step down
+   float steps = std::floor( ( scale - m_settings.MinScale ) / m_settings.ScaleStep + 0.001f );
+   float quantized = m_settings.MinScale + std::max( steps, 0.0f ) * m_settings.ScaleStep;
+   return std::min( quantized, m_settings.MaxScale );
+}
\ No newline at end of file
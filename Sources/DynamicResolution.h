@@ -0,0 +1,52 @@
+#pragma once
+#include "GPUTimer.h"
+
+struct DynamicResolutionSettings
+{
+   float TargetFrameMs = 16.0f;
+   float MinScale = 0.5f;
+   float MaxScale = 1.0f;
+   float ScaleStep = 0.05f;      // Scale is quantized so render targets are not reallocated every frame
+   float IncreaseHeadroom = 0.8f;// Scale up only when GPU time is below TargetFrameMs * IncreaseHeadroom
+};
+
+// Adjusts internal render scale to hold a GPU frame time target.
+// GPU time of everything between BeginFrame( ) and EndFrame( ) is measured with timestamp queries( read back
+// a few frames late, never stalls ). Scale drops as soon as the smoothed time exceeds the target and rises
+// one step at a time once there is enough headroom, the gap between both thresholds avoids oscillation.
+class DynamicResolution
+{
+public:
+   explicit DynamicResolution( const DynamicResolutionSettings& settings = DynamicResolutionSettings( ) );
+
+   void SetSettings( const DynamicResolutionSettings& settings );
+   const DynamicResolutionSettings& GetSettings( ) const { return m_settings; }
+
+   void SetEnabled( bool enabled );
+   bool IsEnabled( ) const { return m_enabled; }
+
+   void BeginFrame( ) { m_timer.Begin( ); }
+   void EndFrame( ) { m_timer.End( ); }
+
+   // Call once per frame before building render targets. Returns scale for this frame.
+   float Update( );
+
+   float GetScale( ) const { return m_scale; }
+   float GetSmoothedFrameMs( ) const { return m_smoothedMs; }
+
+private:
+   float Quantize( float scale ) const;
+
+private:
+   // Frames to wait after a change, resolved timings still belong to the old scale until then
+   static constexpr unsigned int SettleFrames = 8;
+   static constexpr float SmoothingFactor = 0.1f;
+
+   DynamicResolutionSettings m_settings;
+   GPUTimer m_timer;
+   bool m_enabled;
+   float m_scale;
+   float m_smoothedMs;
+   unsigned int m_settleFrames;
+
+};
\ No newline at end of file
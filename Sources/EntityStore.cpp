@@ -0,0 +1,308 @@
+#include "EntityStore.h"
+#include "BatchMath.h"
+#include "JobSystem.h"
+
+#include <cfloat>
+
+namespace
+{
+   template<typename T>
+   void MoveRow( std::vector<T>& values, uint32_t from, uint32_t to )
+   {
+      if ( !values.empty( ) )
+      {
+         values[ to ] = values[ from ];
+      }
+   }
+
+   void AllocateChunk( EntityChunk& chunk, ComponentMask mask )
+   {
+      const uint32_t capacity = EntityChunk::Capacity;
+      chunk.Mask = mask;
+      chunk.Entities.resize( capacity );
+      if ( mask & TransformComponent )
+      {
+         chunk.Transforms.resize( capacity, glm::mat4( ) );
+      }
+      if ( mask & BoundsComponent )
+      {
+         chunk.LocalBoundsMin.resize( capacity, glm::vec3( FLT_MAX ) );
+         chunk.LocalBoundsMax.resize( capacity, glm::vec3( -FLT_MAX ) );
+         chunk.WorldMinX.resize( capacity, FLT_MAX );
+         chunk.WorldMinY.resize( capacity, FLT_MAX );
+         chunk.WorldMinZ.resize( capacity, FLT_MAX );
+         chunk.WorldMaxX.resize( capacity, -FLT_MAX );
+         chunk.WorldMaxY.resize( capacity, -FLT_MAX );
+         chunk.WorldMaxZ.resize( capacity, -FLT_MAX );
+      }
+      if ( mask & RenderableComponent )
+      {
+         chunk.Meshes.resize( capacity, 0 );
+         chunk.Materials.resize( capacity, 0 );
+      }
+      if ( mask & InstanceComponent )
+      {
+         chunk.Instances.resize( capacity, glm::vec4( 0.0f ) );
+      }
+   }
+
+   void SetEmptyBounds( EntityChunk& chunk, uint32_t row )
+   {
+      chunk.WorldMinX[ row ] = chunk.WorldMinY[ row ] = chunk.WorldMinZ[ row ] = FLT_MAX;
+      chunk.WorldMaxX[ row ] = chunk.WorldMaxY[ row ] = chunk.WorldMaxZ[ row ] = -FLT_MAX;
+   }
+}
+
+EntityStore::EntityStore( ) :
+   m_aliveCount( 0 )
+{
+}
+
+Entity EntityStore::Create( ComponentMask mask )
+{
+   EntityChunk& chunk = AcquireChunk( mask );
+
+   Entity entity;
+   if ( !m_freeIndices.empty( ) )
+   {
+      entity.Index = m_freeIndices.back( );
+      m_freeIndices.pop_back( );
+   }
+   else
+   {
+      entity.Index = static_cast<uint32_t>( m_locations.size( ) );
+      m_locations.emplace_back( );
+   }
+
+   EntityLocation& location = m_locations[ entity.Index ];
+   entity.Generation = location.Generation;
+   location.Chunk = &chunk;
+   location.Row = chunk.Count;
+
+   // Rows are reused, reset what a previous entity left behind
+   uint32_t row = chunk.Count++;
+   chunk.Entities[ row ] = entity;
+   if ( mask & TransformComponent )
+   {
+      chunk.Transforms[ row ] = glm::mat4( );
+   }
+   if ( mask & BoundsComponent )
+   {
+      chunk.LocalBoundsMin[ row ] = glm::vec3( FLT_MAX );
+      chunk.LocalBoundsMax[ row ] = glm::vec3( -FLT_MAX );
+      chunk.BoundsDirty = true;
+   }
+   if ( mask & RenderableComponent )
+   {
+      chunk.Meshes[ row ] = 0;
+      chunk.Materials[ row ] = 0;
+   }
+   if ( mask & InstanceComponent )
+   {
+      chunk.Instances[ row ] = glm::vec4( 0.0f );
+   }
+
+   ++m_aliveCount;
+   return entity;
+}
+
+void EntityStore::Destroy( Entity entity )
+{
+   const EntityLocation* found = Find( entity );
+   if ( found == nullptr )
+   {
+      return;
+   }
+
+   // Last row fills the hole so the chunk stays packed
+   EntityChunk& chunk = *found->Chunk;
+   uint32_t row = found->Row;
+   uint32_t last = --chunk.Count;
+   if ( row != last )
+   {
+      MoveRow( chunk.Entities, last, row );
+      MoveRow( chunk.Transforms, last, row );
+      MoveRow( chunk.LocalBoundsMin, last, row );
+      MoveRow( chunk.LocalBoundsMax, last, row );
+      MoveRow( chunk.WorldMinX, last, row );
+      MoveRow( chunk.WorldMinY, last, row );
+      MoveRow( chunk.WorldMinZ, last, row );
+      MoveRow( chunk.WorldMaxX, last, row );
+      MoveRow( chunk.WorldMaxY, last, row );
+      MoveRow( chunk.WorldMaxZ, last, row );
+      MoveRow( chunk.Meshes, last, row );
+      MoveRow( chunk.Materials, last, row );
+      MoveRow( chunk.Instances, last, row );
+      m_locations[ chunk.Entities[ row ].Index ].Row = row;
+   }
+
+   EntityLocation& location = m_locations[ entity.Index ];
+   location.Chunk = nullptr;
+   ++location.Generation;
+   m_freeIndices.push_back( entity.Index );
+   --m_aliveCount;
+}
+
+void EntityStore::Clear( )
+{
+   // Locations stay so handles from before the clear fail the generation check
+   m_freeIndices.clear( );
+   for ( uint32_t index = static_cast<uint32_t>( m_locations.size( ) ); index > 0; --index )
+   {
+      EntityLocation& location = m_locations[ index - 1 ];
+      if ( location.Chunk != nullptr )
+      {
+         location.Chunk = nullptr;
+         ++location.Generation;
+      }
+      m_freeIndices.push_back( index - 1 );
+   }
+
+   m_archetypes.clear( );
+   m_aliveCount = 0;
+}
+
+bool EntityStore::IsAlive( Entity entity ) const
+{
+   return Find( entity ) != nullptr;
+}
+
+void EntityStore::SetTransform( Entity entity, const glm::mat4& transform )
+{
+   const EntityLocation* found = Find( entity );
+   if ( found != nullptr && found->Chunk->Has( TransformComponent ) )
+   {
+      found->Chunk->Transforms[ found->Row ] = transform;
+      found->Chunk->BoundsDirty |= found->Chunk->Has( BoundsComponent );
+   }
+}
+
+void EntityStore::SetLocalBounds( Entity entity, const glm::vec3& boundsMin, const glm::vec3& boundsMax )
+{
+   const EntityLocation* found = Find( entity );
+   if ( found != nullptr && found->Chunk->Has( BoundsComponent ) )
+   {
+      found->Chunk->LocalBoundsMin[ found->Row ] = boundsMin;
+      found->Chunk->LocalBoundsMax[ found->Row ] = boundsMax;
+      found->Chunk->BoundsDirty = true;
+   }
+}
+
+void EntityStore::SetRenderable( Entity entity, uint32_t mesh, uint32_t material )
+{
+   const EntityLocation* found = Find( entity );
+   if ( found != nullptr && found->Chunk->Has( RenderableComponent ) )
+   {
+      found->Chunk->Meshes[ found->Row ] = mesh;
+      found->Chunk->Materials[ found->Row ] = material;
+   }
+}
+
+void EntityStore::SetInstanceData( Entity entity, const glm::vec4& data )
+{
+   const EntityLocation* found = Find( entity );
+   if ( found != nullptr && found->Chunk->Has( InstanceComponent ) )
+   {
+      found->Chunk->Instances[ found->Row ] = data;
+   }
+}
+
+const glm::mat4& EntityStore::GetTransform( Entity entity ) const
+{
+   static const glm::mat4 Identity;
+
+   const EntityLocation* found = Find( entity );
+   if ( found == nullptr || !found->Chunk->Has( TransformComponent ) )
+   {
+      return Identity;
+   }
+
+   return found->Chunk->Transforms[ found->Row ];
+}
+
+void EntityStore::UpdateBounds( )
+{
+   m_dirtyChunks.clear( );
+   for ( auto& archetype : m_archetypes )
+   {
+      if ( ( archetype.Mask & ( TransformComponent | BoundsComponent ) ) != ( TransformComponent | BoundsComponent ) )
+      {
+         continue;
+      }
+
+      for ( auto& chunk : archetype.Chunks )
+      {
+         if ( chunk->BoundsDirty )
+         {
+            m_dirtyChunks.push_back( chunk.get( ) );
+         }
+      }
+   }
+
+   // Chunks are independent, one job each
+   ParallelFor( m_dirtyChunks.size( ), 1, [ this ]( size_t begin, size_t end )
+   {
+      for ( size_t chunkIdx = begin; chunkIdx < end; ++chunkIdx )
+      {
+         EntityChunk& chunk = *m_dirtyChunks[ chunkIdx ];
+
+         // Center / extent form over the whole chunk( BatchMath )
+         TransformBounds( chunk.Transforms.data( ), chunk.LocalBoundsMin.data( ), chunk.LocalBoundsMax.data( ), chunk.Count,
+                          chunk.WorldMinX.data( ), chunk.WorldMinY.data( ), chunk.WorldMinZ.data( ),
+                          chunk.WorldMaxX.data( ), chunk.WorldMaxY.data( ), chunk.WorldMaxZ.data( ) );
+
+         // Rows whose box was never set keep an empty box instead of one at the origin
+         for ( uint32_t row = 0; row < chunk.Count; ++row )
+         {
+            if ( chunk.LocalBoundsMin[ row ].x > chunk.LocalBoundsMax[ row ].x )
+            {
+               SetEmptyBounds( chunk, row );
+            }
+         }
+         chunk.BoundsDirty = false;
+      }
+   } );
+}
+
+EntityChunk& EntityStore::AcquireChunk( ComponentMask mask )
+{
+   Archetype* archetype = nullptr;
+   for ( auto& candidate : m_archetypes )
+   {
+      if ( candidate.Mask == mask )
+      {
+         archetype = &candidate;
+         break;
+      }
+   }
+
+   if ( archetype == nullptr )
+   {
+      m_archetypes.push_back( Archetype{ mask, { } } );
+      archetype = &m_archetypes.back( );
+   }
+
+   // Fill the first chunk with room, keeps entities packed into as few chunks as possible
+   for ( auto& chunk : archetype->Chunks )
+   {
+      if ( chunk->Count < EntityChunk::Capacity )
+      {
+         return *chunk;
+      }
+   }
+
+   archetype->Chunks.emplace_back( new EntityChunk( ) );
+   AllocateChunk( *archetype->Chunks.back( ), mask );
+   return *archetype->Chunks.back( );
+}
+
+const EntityStore::EntityLocation* EntityStore::Find( Entity entity ) const
+{
+   if ( entity.Index >= m_locations.size( ) )
+   {
+      return nullptr;
+   }
+
+   const EntityLocation& location = m_locations[ entity.Index ];
+   return ( location.Chunk != nullptr && location.Generation == entity.Generation ) ? &location : nullptr;
+}
\ No newline at end of file
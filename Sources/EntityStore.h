@@ -0,0 +1,130 @@
+#pragma once
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Components an entity can carry, combined into the archetype mask given to EntityStore::Create.
+using ComponentMask = uint32_t;
+const ComponentMask TransformComponent  = 1 << 0;   // World matrix
+const ComponentMask BoundsComponent     = 1 << 1;   // Local box, world AABB derived from the transform
+const ComponentMask RenderableComponent = 1 << 2;   // Mesh and material handles
+const ComponentMask InstanceComponent   = 1 << 3;   // Free per instance vec4 streamed next to the world matrix
+const ComponentMask DynamicComponent    = 1 << 4;   // Tag, moves every frame( ex. excluded from cached shadows )
+
+struct Entity
+{
+   static constexpr uint32_t InvalidIndex = 0xffffffff;
+
+   uint32_t Index = InvalidIndex;
+   uint32_t Generation = 0;
+};
+
+// Fixed size block of entities sharing one archetype. Every component is its own array( SoA ) and rows are
+// kept packed, so passes over a component walk contiguous memory. World bounds are split per axis so culling
+// loads the same component of neighbouring boxes together.
+struct EntityChunk
+{
+   static constexpr uint32_t Capacity = 128;
+
+   ComponentMask Mask = 0;
+   uint32_t Count = 0;
+   bool BoundsDirty = false;
+
+   std::vector<Entity> Entities;
+
+   std::vector<glm::mat4> Transforms;
+
+   std::vector<glm::vec3> LocalBoundsMin;
+   std::vector<glm::vec3> LocalBoundsMax;
+   std::vector<float> WorldMinX;
+   std::vector<float> WorldMinY;
+   std::vector<float> WorldMinZ;
+   std::vector<float> WorldMaxX;
+   std::vector<float> WorldMaxY;
+   std::vector<float> WorldMaxZ;
+
+   std::vector<uint32_t> Meshes;
+   std::vector<uint32_t> Materials;
+
+   std::vector<glm::vec4> Instances;
+
+   bool Has( ComponentMask components ) const { return ( Mask & components ) == components; }
+};
+
+// Entity / component store grouped by archetype( exact component mask ). Each archetype owns a list of chunks,
+// entities are addressed through generation checked handles so rows can move when others are destroyed.
+// Chunks are visited in creation order, which stays stable while no entity is destroyed.
+class EntityStore
+{
+public:
+   EntityStore( );
+
+   EntityStore( const EntityStore& ) = delete;
+   EntityStore& operator=( const EntityStore& ) = delete;
+
+   Entity Create( ComponentMask mask );
+   void Destroy( Entity entity );
+   void Clear( );
+
+   bool IsAlive( Entity entity ) const;
+   uint32_t GetCount( ) const { return m_aliveCount; }
+
+   // Setters ignore components the entity does not have
+   void SetTransform( Entity entity, const glm::mat4& transform );
+   void SetLocalBounds( Entity entity, const glm::vec3& boundsMin, const glm::vec3& boundsMax );
+   void SetRenderable( Entity entity, uint32_t mesh, uint32_t material );
+   void SetInstanceData( Entity entity, const glm::vec4& data );
+
+   const glm::mat4& GetTransform( Entity entity ) const;
+
+   // Recomputes world AABBs of chunks whose transforms or local bounds changed( one job per chunk ). Untouched chunks cost nothing.
+   void UpdateBounds( );
+
+   // Calls 'function( const EntityChunk& )' for every non empty chunk having all of 'required' and none of 'excluded'.
+   template<typename Function>
+   void ForEachChunk( ComponentMask required, ComponentMask excluded, Function function ) const
+   {
+      for ( const auto& archetype : m_archetypes )
+      {
+         if ( ( archetype.Mask & required ) != required || ( archetype.Mask & excluded ) != 0 )
+         {
+            continue;
+         }
+
+         for ( const auto& chunk : archetype.Chunks )
+         {
+            if ( chunk->Count > 0 )
+            {
+               function( *chunk );
+            }
+         }
+      }
+   }
+
+private:
+   struct Archetype
+   {
+      ComponentMask Mask;
+      std::vector<std::unique_ptr<EntityChunk>> Chunks;
+   };
+
+   struct EntityLocation
+   {
+      EntityChunk* Chunk = nullptr;
+      uint32_t Row = 0;
+      uint32_t Generation = 0;
+   };
+
+   EntityChunk& AcquireChunk( ComponentMask mask );
+   const EntityLocation* Find( Entity entity ) const;
+
+private:
+   std::vector<Archetype> m_archetypes;
+   std::vector<EntityLocation> m_locations;
+   std::vector<uint32_t> m_freeIndices;
+   std::vector<EntityChunk*> m_dirtyChunks;
+   uint32_t m_aliveCount;
+
+};
\ No newline at end of file
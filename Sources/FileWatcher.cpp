@@ -0,0 +1,154 @@
+#include "FileWatcher.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <iostream>
+
+namespace
+{
+   // Shutdown latency of the watcher thread
+   constexpr int PollIntervalMs = 100;
+}
+
+FileWatcher::FileWatcher( const std::string& directory ) :
+   m_directory( directory ),
+   m_running( true )
+{
+#ifdef _WIN32
+   m_thread = std::thread( &FileWatcher::Run, this );
+#else
+   m_inotify = inotify_init1( IN_NONBLOCK );
+   if ( m_inotify < 0 || inotify_add_watch( m_inotify, directory.c_str( ), IN_CLOSE_WRITE | IN_MOVED_TO ) < 0 )
+   {
+      std::cout << "Failed to watch directory : " << directory << std::endl;
+      return;
+   }
+
+   m_thread = std::thread( &FileWatcher::Run, this );
+#endif
+}
+
+FileWatcher::~FileWatcher( )
+{
+   m_running = false;
+   if ( m_thread.joinable( ) )
+   {
+      m_thread.join( );
+   }
+
+#ifndef _WIN32
+   if ( m_inotify >= 0 )
+   {
+      close( m_inotify );
+   }
+#endif
+}
+
+std::vector<std::string> FileWatcher::ConsumeChanges( )
+{
+   std::lock_guard<std::mutex> lock( m_mutex );
+   std::vector<std::string> changes( m_changes.begin( ), m_changes.end( ) );
+   m_changes.clear( );
+   return changes;
+}
+
+void FileWatcher::AddChange( const std::string& fileName )
+{
+   std::lock_guard<std::mutex> lock( m_mutex );
+   m_changes.insert( fileName );
+}
+
+#ifdef _WIN32
+void FileWatcher::Run( )
+{
+   HANDLE directory = CreateFileA( m_directory.c_str( ), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                   nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr );
+   if ( directory == INVALID_HANDLE_VALUE )
+   {
+      std::cout << "Failed to watch directory : " << m_directory << std::endl;
+      return;
+   }
+
+   OVERLAPPED overlapped = { };
+   overlapped.hEvent = CreateEvent( nullptr, TRUE, FALSE, nullptr );
+
+   alignas( DWORD ) char buffer[ 16 * 1024 ];
+   const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME;
+   bool pending = ReadDirectoryChangesW( directory, buffer, sizeof( buffer ), FALSE, filter, nullptr, &overlapped, nullptr ) != 0;
+   while ( m_running && pending )
+   {
+      if ( WaitForSingleObject( overlapped.hEvent, PollIntervalMs ) != WAIT_OBJECT_0 )
+      {
+         continue;
+      }
+
+      DWORD bytes = 0;
+      if ( GetOverlappedResult( directory, &overlapped, &bytes, FALSE ) && bytes > 0 )
+      {
+         const char* cursor = buffer;
+         for ( ;; )
+         {
+            const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>( cursor );
+            if ( info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME )
+            {
+               int wideLength = static_cast<int>( info->FileNameLength / sizeof( WCHAR ) );
+               int length = WideCharToMultiByte( CP_UTF8, 0, info->FileName, wideLength, nullptr, 0, nullptr, nullptr );
+               std::string fileName( length, '\0' );
+               WideCharToMultiByte( CP_UTF8, 0, info->FileName, wideLength, &fileName[ 0 ], length, nullptr, nullptr );
+               AddChange( fileName );
+            }
+
+            if ( info->NextEntryOffset == 0 )
+            {
+               break;
+            }
+            cursor += info->NextEntryOffset;
+         }
+      }
+
+      ResetEvent( overlapped.hEvent );
+      pending = ReadDirectoryChangesW( directory, buffer, sizeof( buffer ), FALSE, filter, nullptr, &overlapped, nullptr ) != 0;
+   }
+
+   if ( pending )
+   {
+      CancelIoEx( directory, &overlapped );
+      DWORD bytes = 0;
+      GetOverlappedResult( directory, &overlapped, &bytes, TRUE );
+   }
+   CloseHandle( overlapped.hEvent );
+   CloseHandle( directory );
+}
+#else
+void FileWatcher::Run( )
+{
+   alignas( inotify_event ) char buffer[ 16 * 1024 ];
+   while ( m_running )
+   {
+      pollfd descriptor = { m_inotify, POLLIN, 0 };
+      if ( poll( &descriptor, 1, PollIntervalMs ) <= 0 )
+      {
+         continue;
+      }
+
+      ssize_t bytes = read( m_inotify, buffer, sizeof( buffer ) );
+      for ( ssize_t offset = 0; offset < bytes; )
+      {
+         const auto* event = reinterpret_cast<const inotify_event*>( buffer + offset );
+         if ( event->len > 0 )
+         {
+            AddChange( event->name );
+         }
+         offset += sizeof( inotify_event ) + event->len;
+      }
+   }
+}
+#endif
\ No newline at end of file
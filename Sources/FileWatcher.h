@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Watches one directory( not recursive ) on a background thread.
+// ReadDirectoryChangesW on Windows, inotify elsewhere. Editors saving through a temporary file and a rename
+// are reported under the final name.
+class FileWatcher
+{
+public:
+   explicit FileWatcher( const std::string& directory );
+   ~FileWatcher( );
+
+   FileWatcher( const FileWatcher& ) = delete;
+   FileWatcher& operator=( const FileWatcher& ) = delete;
+
+   bool IsWatching( ) const { return m_thread.joinable( ); }
+
+   // File names modified since the last call, each reported once.
+   std::vector<std::string> ConsumeChanges( );
+
+private:
+   void Run( );
+   void AddChange( const std::string& fileName );
+
+private:
+   std::string m_directory;
+   std::atomic<bool> m_running;
+   std::thread m_thread;
+
+   std::mutex m_mutex;
+   std::set<std::string> m_changes;
+
+#ifndef _WIN32
+   int m_inotify;
+#endif
+
+};
\ No newline at end of file
@@ -0,0 +1,691 @@
+#include "FrameGraph.h"
+
+#include <algorithm>
+#include <iostream>
+
+static void GetUploadFormat( GLenum internalFormat, GLenum& format, GLenum& type )
+{
+   switch ( internalFormat )
+   {
+   case GL_R8:
+      format = GL_RED;
+      type = GL_UNSIGNED_BYTE;
+      break;
+   case GL_RG8:
+      format = GL_RG;
+      type = GL_UNSIGNED_BYTE;
+      break;
+   case GL_RGBA8:
+   case GL_SRGB8_ALPHA8:
+   case GL_RGB10_A2:
+      format = GL_RGBA;
+      type = GL_UNSIGNED_BYTE;
+      break;
+   case GL_RG16:
+      format = GL_RG;
+      type = GL_UNSIGNED_SHORT;
+      break;
+   case GL_R16F:
+   case GL_R32F:
+      format = GL_RED;
+      type = GL_FLOAT;
+      break;
+   case GL_RG16F:
+   case GL_RG32F:
+      format = GL_RG;
+      type = GL_FLOAT;
+      break;
+   case GL_RGB16F:
+   case GL_R11F_G11F_B10F:
+      format = GL_RGB;
+      type = GL_FLOAT;
+      break;
+   case GL_DEPTH_COMPONENT16:
+   case GL_DEPTH_COMPONENT24:
+   case GL_DEPTH_COMPONENT32F:
+      format = GL_DEPTH_COMPONENT;
+      type = GL_FLOAT;
+      break;
+   case GL_DEPTH24_STENCIL8:
+      format = GL_DEPTH_STENCIL;
+      type = GL_UNSIGNED_INT_24_8;
+      break;
+   default:
+      format = GL_RGBA;
+      type = GL_FLOAT;
+      break;
+   }
+}
+
+static size_t GetBytesPerTexel( GLenum internalFormat )
+{
+   switch ( internalFormat )
+   {
+   case GL_R8:
+      return 1;
+   case GL_RG8:
+   case GL_R16F:
+   case GL_DEPTH_COMPONENT16:
+      return 2;
+   case GL_RGBA8:
+   case GL_SRGB8_ALPHA8:
+   case GL_RGB10_A2:
+   case GL_RG16:
+   case GL_RG16F:
+   case GL_R32F:
+   case GL_R11F_G11F_B10F:
+   case GL_DEPTH_COMPONENT24:
+   case GL_DEPTH_COMPONENT32F:
+   case GL_DEPTH24_STENCIL8:
+      return 4;
+   case GL_RGB16F:
+      return 6;
+   case GL_RG32F:
+   case GL_RGBA16F:
+      return 8;
+   default:
+      return 16;
+   }
+}
+
+FrameGraphResource FrameGraphBuilder::Create( const std::string& name, const FrameGraphTextureDesc& desc )
+{
+   FrameGraph::VirtualResource resource;
+   resource.Name = name;
+   resource.Desc = desc;
+   if ( desc.SizeMode == FrameGraphSizeMode::Absolute )
+   {
+      resource.Width = desc.Width;
+      resource.Height = desc.Height;
+   }
+   else
+   {
+      resource.Width = std::max( 1u, static_cast<unsigned int>( m_graph.m_outputWidth * desc.Scale ) );
+      resource.Height = std::max( 1u, static_cast<unsigned int>( m_graph.m_outputHeight * desc.Scale ) );
+   }
+
+   m_graph.m_resources.push_back( resource );
+   return static_cast<FrameGraphResource>( m_graph.m_resources.size( ) - 1 );
+}
+
+FrameGraphResource FrameGraphBuilder::Read( FrameGraphResource resource )
+{
+   m_graph.m_passes[ m_passIndex ].Reads.push_back( resource );
+   return resource;
+}
+
+FrameGraphResource FrameGraphBuilder::Write( FrameGraphResource resource )
+{
+   m_graph.AddWrite( m_passIndex, resource );
+   return resource;
+}
+
+FrameGraphResource FrameGraphBuilder::WriteColor( FrameGraphResource resource, unsigned int slot )
+{
+   m_graph.m_passes[ m_passIndex ].ColorWrites.push_back( std::make_pair( slot, resource ) );
+   m_graph.AddWrite( m_passIndex, resource );
+   return resource;
+}
+
+FrameGraphResource FrameGraphBuilder::WriteDepth( FrameGraphResource resource )
+{
+   m_graph.m_passes[ m_passIndex ].DepthWrite = resource;
+   m_graph.AddWrite( m_passIndex, resource );
+   return resource;
+}
+
+void FrameGraphBuilder::WriteBackbuffer( )
+{
+   m_graph.m_passes[ m_passIndex ].Backbuffer = true;
+}
+
+void FrameGraphBuilder::SetSideEffect( )
+{
+   m_graph.m_passes[ m_passIndex ].SideEffect = true;
+}
+
+unsigned int FrameGraphPassContext::GetTexture( FrameGraphResource resource ) const
+{
+   return m_graph.ResolveTexture( resource );
+}
+
+unsigned int FrameGraphPassContext::GetWidth( FrameGraphResource resource ) const
+{
+   return m_graph.m_resources[ resource ].Width;
+}
+
+unsigned int FrameGraphPassContext::GetHeight( FrameGraphResource resource ) const
+{
+   return m_graph.m_resources[ resource ].Height;
+}
+
+unsigned int FrameGraphPassContext::GetFramebuffer( std::initializer_list<FrameGraphResource> colors, FrameGraphResource depth ) const
+{
+   std::vector<unsigned int> colorTextures;
+   for ( FrameGraphResource color : colors )
+   {
+      colorTextures.push_back( m_graph.ResolveTexture( color ) );
+   }
+
+   unsigned int depthTexture = ( depth != InvalidFrameGraphResource ) ? m_graph.ResolveTexture( depth ) : 0;
+   return m_graph.GetFramebuffer( colorTextures, depthTexture );
+}
+
+FrameGraph::FrameGraph( ) :
+   m_outputWidth( 1 ),
+   m_outputHeight( 1 ),
+   m_frameIndex( 0 ),
+   m_compiled( false ),
+   m_culledPassCount( 0 ),
+   m_transientCount( 0 )
+{
+}
+
+FrameGraph::~FrameGraph( )
+{
+   for ( auto& framebuffer : m_framebuffers )
+   {
+      glDeleteFramebuffers( 1, &framebuffer.second );
+   }
+
+   for ( auto& texture : m_pool )
+   {
+      glDeleteTextures( 1, &texture.Id );
+   }
+}
+
+void FrameGraph::Reset( unsigned int outputWidth, unsigned int outputHeight )
+{
+   m_outputWidth = std::max( 1u, outputWidth );
+   m_outputHeight = std::max( 1u, outputHeight );
+   ++m_frameIndex;
+   m_compiled = false;
+
+   m_passes.clear( );
+   m_resources.clear( );
+}
+
+FrameGraphResource FrameGraph::Import( const std::string& name, unsigned int texture, unsigned int width, unsigned int height )
+{
+   VirtualResource resource;
+   resource.Name = name;
+   resource.Imported = true;
+   resource.ImportedTexture = texture;
+   resource.Width = width;
+   resource.Height = height;
+   resource.Desc.SizeMode = FrameGraphSizeMode::Absolute;
+   resource.Desc.Width = width;
+   resource.Desc.Height = height;
+
+   m_resources.push_back( resource );
+   return static_cast<FrameGraphResource>( m_resources.size( ) - 1 );
+}
+
+void FrameGraph::AddPass( const std::string& name, const SetupCallback& setup, const ExecuteCallback& execute )
+{
+   Pass pass;
+   pass.Name = name;
+   pass.Execute = execute;
+   m_passes.push_back( pass );
+
+   FrameGraphBuilder builder{ *this, static_cast<int>( m_passes.size( ) - 1 ) };
+   setup( builder );
+}
+
+void FrameGraph::AddWrite( int passIndex, FrameGraphResource resource )
+{
+   Pass& pass = m_passes[ passIndex ];
+   if ( std::find( pass.Writes.begin( ), pass.Writes.end( ), resource ) == pass.Writes.end( ) )
+   {
+      pass.Writes.push_back( resource );
+      m_resources[ resource ].Producers.push_back( passIndex );
+   }
+
+   // Imported resources outlive the frame, writing them is observable
+   if ( m_resources[ resource ].Imported )
+   {
+      pass.SideEffect = true;
+   }
+}
+
+void FrameGraph::Compile( )
+{
+   CullPasses( );
+   ComputeLifetimes( );
+   AllocateResources( );
+   ReleaseUnusedPhysical( );
+   m_compiled = true;
+}
+
+void FrameGraph::CullPasses( )
+{
+   for ( auto& pass : m_passes )
+   {
+      pass.RefCount = static_cast<int>( pass.Writes.size( ) );
+      pass.Culled = false;
+   }
+
+   for ( auto& resource : m_resources )
+   {
+      resource.RefCount = 0;
+   }
+
+   for ( auto& pass : m_passes )
+   {
+      for ( FrameGraphResource read : pass.Reads )
+      {
+         ++m_resources[ read ].RefCount;
+      }
+   }
+
+   // Flood from resources nobody reads: their producers lose a reference, producers without references are dead
+   std::vector<FrameGraphResource> unreferenced;
+   for ( size_t idx = 0; idx < m_resources.size( ); ++idx )
+   {
+      if ( m_resources[ idx ].RefCount == 0 )
+      {
+         unreferenced.push_back( static_cast<FrameGraphResource>( idx ) );
+      }
+   }
+
+   while ( !unreferenced.empty( ) )
+   {
+      FrameGraphResource resource = unreferenced.back( );
+      unreferenced.pop_back( );
+
+      for ( int producerIdx : m_resources[ resource ].Producers )
+      {
+         Pass& producer = m_passes[ producerIdx ];
+         if ( producer.Backbuffer || producer.SideEffect )
+         {
+            continue;
+         }
+
+         if ( --producer.RefCount == 0 )
+         {
+            producer.Culled = true;
+            for ( FrameGraphResource read : producer.Reads )
+            {
+               if ( --m_resources[ read ].RefCount == 0 )
+               {
+                  unreferenced.push_back( read );
+               }
+            }
+         }
+      }
+   }
+
+   m_culledPassCount = 0;
+   for ( const auto& pass : m_passes )
+   {
+      if ( pass.Culled )
+      {
+         ++m_culledPassCount;
+      }
+   }
+}
+
+void FrameGraph::ComputeLifetimes( )
+{
+   for ( auto& resource : m_resources )
+   {
+      resource.FirstPass = -1;
+      resource.LastPass = -1;
+      resource.Physical = -1;
+   }
+
+   for ( int passIdx = 0; passIdx < static_cast<int>( m_passes.size( ) ); ++passIdx )
+   {
+      const Pass& pass = m_passes[ passIdx ];
+      if ( pass.Culled )
+      {
+         continue;
+      }
+
+      auto touch = [ this, passIdx ]( FrameGraphResource resource )
+      {
+         VirtualResource& virtualResource = m_resources[ resource ];
+         if ( virtualResource.FirstPass < 0 )
+         {
+            virtualResource.FirstPass = passIdx;
+         }
+         virtualResource.LastPass = passIdx;
+      };
+
+      for ( FrameGraphResource read : pass.Reads )
+      {
+         touch( read );
+      }
+      for ( FrameGraphResource write : pass.Writes )
+      {
+         touch( write );
+      }
+   }
+}
+
+void FrameGraph::AllocateResources( )
+{
+   for ( auto& texture : m_pool )
+   {
+      texture.InUse = false;
+   }
+
+   m_transientCount = 0;
+   for ( int passIdx = 0; passIdx < static_cast<int>( m_passes.size( ) ); ++passIdx )
+   {
+      // Acquire everything that starts living at this pass
+      for ( auto& resource : m_resources )
+      {
+         if ( !resource.Imported && resource.FirstPass == passIdx )
+         {
+            resource.Physical = AcquirePhysical( resource );
+            ++m_transientCount;
+         }
+      }
+
+      // Everything that dies here can back later resources
+      for ( auto& resource : m_resources )
+      {
+         if ( !resource.Imported && resource.LastPass == passIdx && resource.Physical >= 0 )
+         {
+            m_pool[ resource.Physical ].InUse = false;
+         }
+      }
+   }
+}
+
+int FrameGraph::AcquirePhysical( const VirtualResource& resource )
+{
+   // 0 and 1 both mean single sampled, compared the way pooled textures store it
+   unsigned int samples = std::max( 1u, resource.Desc.Samples );
+   for ( size_t idx = 0; idx < m_pool.size( ); ++idx )
+   {
+      PhysicalTexture& texture = m_pool[ idx ];
+      if ( !texture.InUse &&
+           texture.Id != 0 &&
+           texture.InternalFormat == resource.Desc.InternalFormat &&
+           texture.Width == resource.Width &&
+           texture.Height == resource.Height &&
+           texture.Filter == resource.Desc.Filter &&
+           texture.Samples == samples )
+      {
+         texture.InUse = true;
+         texture.LastUsedFrame = m_frameIndex;
+         return static_cast<int>( idx );
+      }
+   }
+
+   PhysicalTexture texture;
+   texture.InternalFormat = resource.Desc.InternalFormat;
+   texture.Width = resource.Width;
+   texture.Height = resource.Height;
+   texture.Filter = resource.Desc.Filter;
+   texture.Samples = samples;
+   texture.InUse = true;
+   texture.LastUsedFrame = m_frameIndex;
+
+   GLenum format;
+   GLenum type;
+   GetUploadFormat( texture.InternalFormat, format, type );
+
+   glGenTextures( 1, &texture.Id );
+   if ( texture.Samples > 1 )
+   {
+      // Multisample textures have no sampler state, every sample is fetched explicitly
+      glBindTexture( GL_TEXTURE_2D_MULTISAMPLE, texture.Id );
+      glTexImage2DMultisample( GL_TEXTURE_2D_MULTISAMPLE, texture.Samples, texture.InternalFormat, texture.Width, texture.Height, GL_TRUE );
+      glBindTexture( GL_TEXTURE_2D_MULTISAMPLE, 0 );
+   }
+   else
+   {
+      glBindTexture( GL_TEXTURE_2D, texture.Id );
+      glTexImage2D( GL_TEXTURE_2D, 0, texture.InternalFormat, texture.Width, texture.Height, 0, format, type, nullptr );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.Filter );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture.Filter );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+      glBindTexture( GL_TEXTURE_2D, 0 );
+   }
+
+   // Reuse a destroyed slot so indices of live entries stay stable
+   for ( size_t idx = 0; idx < m_pool.size( ); ++idx )
+   {
+      if ( m_pool[ idx ].Id == 0 )
+      {
+         m_pool[ idx ] = texture;
+         return static_cast<int>( idx );
+      }
+   }
+
+   m_pool.push_back( texture );
+   return static_cast<int>( m_pool.size( ) - 1 );
+}
+
+void FrameGraph::ReleaseUnusedPhysical( )
+{
+   for ( auto& texture : m_pool )
+   {
+      if ( texture.Id != 0 && m_frameIndex - texture.LastUsedFrame > PoolRetainFrames )
+      {
+         DestroyPhysical( texture );
+      }
+   }
+}
+
+void FrameGraph::DestroyPhysical( PhysicalTexture& texture )
+{
+   // Framebuffers referencing the texture must go too, GL may hand the same name out again
+   for ( auto itr = m_framebuffers.begin( ); itr != m_framebuffers.end( ); )
+   {
+      const auto& attachments = itr->first;
+      if ( std::find( attachments.begin( ), attachments.end( ), texture.Id ) != attachments.end( ) )
+      {
+         glDeleteFramebuffers( 1, &itr->second );
+         itr = m_framebuffers.erase( itr );
+      }
+      else
+      {
+         ++itr;
+      }
+   }
+
+   glDeleteTextures( 1, &texture.Id );
+   texture = PhysicalTexture( );
+}
+
+unsigned int FrameGraph::GetPhysicalTextureCount( ) const
+{
+   unsigned int count = 0;
+   for ( const auto& texture : m_pool )
+   {
+      if ( texture.Id != 0 )
+      {
+         ++count;
+      }
+   }
+
+   return count;
+}
+
+size_t FrameGraph::GetPoolMemoryBytes( ) const
+{
+   size_t bytes = 0;
+   for ( const auto& texture : m_pool )
+   {
+      if ( texture.Id != 0 )
+      {
+         bytes += static_cast<size_t>( texture.Width ) * texture.Height * texture.Samples * GetBytesPerTexel( texture.InternalFormat );
+      }
+   }
+
+   return bytes;
+}
+
+unsigned int FrameGraph::ResolveTexture( FrameGraphResource resource ) const
+{
+   const VirtualResource& virtualResource = m_resources[ resource ];
+   if ( virtualResource.Imported )
+   {
+      return virtualResource.ImportedTexture;
+   }
+
+   return ( virtualResource.Physical >= 0 ) ? m_pool[ virtualResource.Physical ].Id : 0;
+}
+
+const FrameGraph::PhysicalTexture* FrameGraph::FindPhysical( unsigned int texture ) const
+{
+   for ( const auto& physical : m_pool )
+   {
+      if ( physical.Id == texture )
+      {
+         return &physical;
+      }
+   }
+
+   return nullptr;
+}
+
+unsigned int FrameGraph::GetFramebuffer( const std::vector<unsigned int>& colors, unsigned int depth )
+{
+   std::vector<unsigned int> key = colors;
+   key.push_back( depth );
+
+   auto found = m_framebuffers.find( key );
+   if ( found != m_framebuffers.end( ) )
+   {
+      return found->second;
+   }
+
+   unsigned int framebuffer;
+   glGenFramebuffers( 1, &framebuffer );
+   glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
+
+   std::vector<GLenum> drawBuffers;
+   // Imported textures are never multisampled
+   auto getTarget = [ this ]( unsigned int texture )
+   {
+      const PhysicalTexture* physical = FindPhysical( texture );
+      return ( physical != nullptr && physical->Samples > 1 ) ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+   };
+
+   for ( unsigned int idx = 0; idx < colors.size( ); ++idx )
+   {
+      glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + idx, getTarget( colors[ idx ] ), colors[ idx ], 0 );
+      drawBuffers.push_back( GL_COLOR_ATTACHMENT0 + idx );
+   }
+
+   if ( depth != 0 )
+   {
+      const PhysicalTexture* physical = FindPhysical( depth );
+      GLint depthFormat = 0;
+      if ( physical != nullptr )
+      {
+         depthFormat = physical->InternalFormat;
+      }
+      else
+      {
+         glBindTexture( GL_TEXTURE_2D, depth );
+         glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &depthFormat );
+         glBindTexture( GL_TEXTURE_2D, 0 );
+      }
+
+      GLenum attachment = ( depthFormat == GL_DEPTH24_STENCIL8 ) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+      glFramebufferTexture2D( GL_FRAMEBUFFER, attachment, getTarget( depth ), depth, 0 );
+   }
+
+   if ( drawBuffers.empty( ) )
+   {
+      glDrawBuffer( GL_NONE );
+      glReadBuffer( GL_NONE );
+   }
+   else
+   {
+      glDrawBuffers( static_cast<GLsizei>( drawBuffers.size( ) ), drawBuffers.data( ) );
+   }
+
+   if ( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+   {
+      std::cout << "Frame graph framebuffer not complete!" << std::endl;
+   }
+
+   m_framebuffers.emplace( key, framebuffer );
+   return framebuffer;
+}
+
+void FrameGraph::BindPassTargets( const Pass& pass )
+{
+   if ( pass.Backbuffer )
+   {
+      glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+      glViewport( 0, 0, m_outputWidth, m_outputHeight );
+      return;
+   }
+
+   if ( pass.ColorWrites.empty( ) && pass.DepthWrite == InvalidFrameGraphResource )
+   {
+      return;
+   }
+
+   unsigned int colorCount = 0;
+   for ( const auto& colorWrite : pass.ColorWrites )
+   {
+      colorCount = std::max( colorCount, colorWrite.first + 1 );
+   }
+
+   std::vector<unsigned int> colors( colorCount, 0 );
+   for ( const auto& colorWrite : pass.ColorWrites )
+   {
+      colors[ colorWrite.first ] = ResolveTexture( colorWrite.second );
+   }
+
+   unsigned int depth = ( pass.DepthWrite != InvalidFrameGraphResource ) ? ResolveTexture( pass.DepthWrite ) : 0;
+   glBindFramebuffer( GL_FRAMEBUFFER, GetFramebuffer( colors, depth ) );
+
+   FrameGraphResource sizeSource = pass.ColorWrites.empty( ) ? pass.DepthWrite : pass.ColorWrites.front( ).second;
+   glViewport( 0, 0, m_resources[ sizeSource ].Width, m_resources[ sizeSource ].Height );
+}
+
+void FrameGraph::Execute( )
+{
+   if ( !m_compiled )
+   {
+      Compile( );
+   }
+
+   FrameGraphPassContext context{ *this };
+   for ( const auto& pass : m_passes )
+   {
+      if ( pass.Culled )
+      {
+         continue;
+      }
+
+      auto& timer = m_timers[ pass.Name ];
+      if ( timer == nullptr )
+      {
+         timer = std::make_unique<GPUTimer>( );
+      }
+
+      timer->Begin( );
+      BindPassTargets( pass );
+      pass.Execute( context );
+      timer->End( );
+   }
+
+   glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+}
+
+std::vector<std::pair<std::string, float>> FrameGraph::ConsumePassTimings( )
+{
+   std::vector<std::pair<std::string, float>> timings;
+   for ( const auto& pass : m_passes )
+   {
+      auto found = m_timers.find( pass.Name );
+      if ( !pass.Culled && found != m_timers.end( ) )
+      {
+         timings.push_back( std::make_pair( pass.Name, found->second->ConsumeAverageMs( ) ) );
+      }
+   }
+
+   return timings;
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#pragma once
+#include "glad/glad.h"
+#include "GPUTimer.h"
+
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Frame graph
+// Passes are declared every frame with the resources they read and write. Compile( ) culls passes whose
+// results never reach the backbuffer( or a side effect ), computes resource lifetimes and maps transient
+// textures onto a persistent pool. Transients with the same description and non-overlapping lifetimes share
+// one physical texture, so a ping-pong chain of N passes only costs two textures.
+// Output size changes( window resize ) simply stop matching old pool entries, which are released after a
+// few frames, so every target follows the framebuffer size without any manual re-creation.
+
+using FrameGraphResource = int;
+const FrameGraphResource InvalidFrameGraphResource = -1;
+
+enum class FrameGraphSizeMode
+{
+   OutputRelative = 0,  // Scale * framebuffer size
+   Absolute             // Width x Height
+};
+
+struct FrameGraphTextureDesc
+{
+   GLenum InternalFormat = GL_RGBA16F;
+   FrameGraphSizeMode SizeMode = FrameGraphSizeMode::OutputRelative;
+   float Scale = 1.0f;
+   unsigned int Width = 0;
+   unsigned int Height = 0;
+   GLenum Filter = GL_LINEAR;
+   unsigned int Samples = 1;  // > 1 => GL_TEXTURE_2D_MULTISAMPLE, read with texelFetch on sampler2DMS
+};
+
+class FrameGraph;
+
+// Declares resource usage of a pass, only valid inside setup callback.
+class FrameGraphBuilder
+{
+public:
+   FrameGraphResource Create( const std::string& name, const FrameGraphTextureDesc& desc );
+
+   FrameGraphResource Read( FrameGraphResource resource );
+
+   // Written by the pass itself( image store, framebuffers from FrameGraphPassContext::GetFramebuffer ).
+   FrameGraphResource Write( FrameGraphResource resource );
+
+   // Bound to the pass framebuffer before execute.
+   FrameGraphResource WriteColor( FrameGraphResource resource, unsigned int slot );
+   FrameGraphResource WriteDepth( FrameGraphResource resource );
+
+   // Pass renders into default framebuffer. Never culled.
+   void WriteBackbuffer( );
+
+   // Pass has effects outside of the graph. Never culled.
+   void SetSideEffect( );
+
+private:
+   friend class FrameGraph;
+   FrameGraphBuilder( FrameGraph& graph, int passIndex ) : m_graph( graph ), m_passIndex( passIndex ) { }
+
+private:
+   FrameGraph& m_graph;
+   int         m_passIndex;
+
+};
+
+// Resolves virtual resources into GL objects, only valid inside execute callback.
+class FrameGraphPassContext
+{
+public:
+   unsigned int GetTexture( FrameGraphResource resource ) const;
+   unsigned int GetWidth( FrameGraphResource resource ) const;
+   unsigned int GetHeight( FrameGraphResource resource ) const;
+
+   // Cached framebuffer with given attachments( color attachment N = Nth element ).
+   unsigned int GetFramebuffer( std::initializer_list<FrameGraphResource> colors,
+                                FrameGraphResource depth = InvalidFrameGraphResource ) const;
+
+private:
+   friend class FrameGraph;
+   explicit FrameGraphPassContext( FrameGraph& graph ) : m_graph( graph ) { }
+
+private:
+   FrameGraph& m_graph;
+
+};
+
+class FrameGraph
+{
+public:
+   using SetupCallback = std::function<void( FrameGraphBuilder& )>;
+   using ExecuteCallback = std::function<void( const FrameGraphPassContext& )>;
+
+public:
+   FrameGraph( );
+   ~FrameGraph( );
+
+   FrameGraph( const FrameGraph& ) = delete;
+   FrameGraph& operator=( const FrameGraph& ) = delete;
+
+   // Starts a new frame, previous passes and virtual resources are dropped. Pool is kept.
+   void Reset( unsigned int outputWidth, unsigned int outputHeight );
+
+   // Externally owned texture( ex. LUT, history buffer ). Passes writing it are never culled.
+   FrameGraphResource Import( const std::string& name, unsigned int texture, unsigned int width, unsigned int height );
+
+   // Setup is invoked immediately, execute is deferred to Execute( ).
+   void AddPass( const std::string& name, const SetupCallback& setup, const ExecuteCallback& execute );
+
+   void Compile( );
+   void Execute( );
+
+   unsigned int GetOutputWidth( ) const { return m_outputWidth; }
+   unsigned int GetOutputHeight( ) const { return m_outputHeight; }
+
+   // Stats for the last compiled frame
+   unsigned int GetCulledPassCount( ) const { return m_culledPassCount; }
+   unsigned int GetTransientCount( ) const { return m_transientCount; }
+   unsigned int GetPhysicalTextureCount( ) const;
+   size_t GetPoolMemoryBytes( ) const;
+
+   // Average GPU time of each pass since the last call, in declaration order.
+   std::vector<std::pair<std::string, float>> ConsumePassTimings( );
+
+private:
+   friend class FrameGraphBuilder;
+   friend class FrameGraphPassContext;
+
+   struct VirtualResource
+   {
+      std::string Name;
+      FrameGraphTextureDesc Desc;
+      unsigned int Width = 0;
+      unsigned int Height = 0;
+      bool Imported = false;
+      unsigned int ImportedTexture = 0;
+
+      std::vector<int> Producers;
+      int RefCount = 0;
+      int FirstPass = -1;
+      int LastPass = -1;
+      int Physical = -1;
+   };
+
+   struct Pass
+   {
+      std::string Name;
+      ExecuteCallback Execute;
+      std::vector<FrameGraphResource> Reads;
+      std::vector<FrameGraphResource> Writes;
+      std::vector<std::pair<unsigned int, FrameGraphResource>> ColorWrites;
+      FrameGraphResource DepthWrite = InvalidFrameGraphResource;
+      bool Backbuffer = false;
+      bool SideEffect = false;
+
+      int RefCount = 0;
+      bool Culled = false;
+   };
+
+   struct PhysicalTexture
+   {
+      unsigned int Id = 0;
+      GLenum InternalFormat = GL_NONE;
+      unsigned int Width = 0;
+      unsigned int Height = 0;
+      GLenum Filter = GL_LINEAR;
+      unsigned int Samples = 1;
+      bool InUse = false;
+      unsigned int LastUsedFrame = 0;
+   };
+
+private:
+   void AddWrite( int passIndex, FrameGraphResource resource );
+   void CullPasses( );
+   void ComputeLifetimes( );
+   void AllocateResources( );
+   int AcquirePhysical( const VirtualResource& resource );
+   void ReleaseUnusedPhysical( );
+   void DestroyPhysical( PhysicalTexture& texture );
+
+   unsigned int ResolveTexture( FrameGraphResource resource ) const;
+   const PhysicalTexture* FindPhysical( unsigned int texture ) const;
+   unsigned int GetFramebuffer( const std::vector<unsigned int>& colors, unsigned int depth );
+   void BindPassTargets( const Pass& pass );
+
+private:
+   // Pool entries not used for this many frames are destroyed
+   static constexpr unsigned int PoolRetainFrames = 3;
+
+   unsigned int m_outputWidth;
+   unsigned int m_outputHeight;
+   unsigned int m_frameIndex;
+   bool m_compiled;
+
+   std::vector<Pass> m_passes;
+   std::vector<VirtualResource> m_resources;
+   std::vector<PhysicalTexture> m_pool;
+
+   // Attachment list( colors..., depth ) => FBO
+   std::map<std::vector<unsigned int>, unsigned int> m_framebuffers;
+
+   std::map<std::string, std::unique_ptr<GPUTimer>> m_timers;
+
+   unsigned int m_culledPassCount;
+   unsigned int m_transientCount;
+
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "GPUTimer.h"
+
+GPUTimer::GPUTimer( ) :
+   m_current( 0 ),
+   m_elapsedMs( 0.0f ),
+   m_accumulatedMs( 0.0f ),
+   m_sampleCount( 0 )
+{
+   glGenQueries( QueryLatency * 2, &m_queries[ 0 ][ 0 ] );
+   for ( unsigned int idx = 0; idx < QueryLatency; ++idx )
+   {
+      m_pending[ idx ] = false;
+   }
+}
+
+GPUTimer::~GPUTimer( )
+{
+   glDeleteQueries( QueryLatency * 2, &m_queries[ 0 ][ 0 ] );
+}
+
+void GPUTimer::Begin( )
+{
+   // Slot about to be reused was issued QueryLatency frames ago, result should be ready by now
+   if ( m_pending[ m_current ] )
+   {
+      Resolve( m_current );
+   }
+
+   glQueryCounter( m_queries[ m_current ][ 0 ], GL_TIMESTAMP );
+}
+
+void GPUTimer::End( )
+{
+   glQueryCounter( m_queries[ m_current ][ 1 ], GL_TIMESTAMP );
+   m_pending[ m_current ] = true;
+   m_current = ( m_current + 1 ) % QueryLatency;
+}
+
+float GPUTimer::ConsumeAverageMs( )
+{
+   float average = ( m_sampleCount > 0 ) ? ( m_accumulatedMs / m_sampleCount ) : m_elapsedMs;
+   m_accumulatedMs = 0.0f;
+   m_sampleCount = 0;
+   return average;
+}
+
+void GPUTimer::Resolve( unsigned int slot )
+{
+   GLint available = 0;
+   glGetQueryObjectiv( m_queries[ slot ][ 1 ], GL_QUERY_RESULT_AVAILABLE, &available );
+   if ( available )
+   {
+      GLuint64 begin = 0;
+      GLuint64 end = 0;
+      glGetQueryObjectui64v( m_queries[ slot ][ 0 ], GL_QUERY_RESULT, &begin );
+      glGetQueryObjectui64v( m_queries[ slot ][ 1 ], GL_QUERY_RESULT, &end );
+
+      m_elapsedMs = static_cast<float>( end - begin ) / 1000000.0f;
+      m_accumulatedMs += m_elapsedMs;
+      ++m_sampleCount;
+   }
+
+   // Not available means the GPU is more than QueryLatency frames behind, drop the sample instead of stalling
+   m_pending[ slot ] = false;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include "glad/glad.h"
+
+// Measures GPU time between Begin( ) and End( ) with timestamp queries.
+// Results are read back QueryLatency frames later so the CPU never waits on the GPU,
+// timestamps( unlike GL_TIME_ELAPSED ) can be freely nested and overlapped.
+class GPUTimer
+{
+public:
+   GPUTimer( );
+   ~GPUTimer( );
+
+   GPUTimer( const GPUTimer& ) = delete;
+   GPUTimer& operator=( const GPUTimer& ) = delete;
+
+   // Begin( ) / End( ) pairs issued before a measurement shows up in GetElapsedMs( )
+   static constexpr unsigned int QueryLatency = 4;
+
+public:
+   void Begin( );
+   void End( );
+
+   // Most recently resolved measurement in milliseconds.
+   float GetElapsedMs( ) const { return m_elapsedMs; }
+
+   // Average over every measurement resolved since the last call.
+   float ConsumeAverageMs( );
+
+private:
+   void Resolve( unsigned int slot );
+
+private:
+   unsigned int m_queries[ QueryLatency ][ 2 ];
+   bool         m_pending[ QueryLatency ];
+   unsigned int m_current;
+
+   float        m_elapsedMs;
+   float        m_accumulatedMs;
+   unsigned int m_sampleCount;
+
+};
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "GaussianBlur.h"
+#include "Primitives.h"
+
+#include <algorithm>
+
+const char* ToString( BlurMode mode )
+{
+   switch ( mode )
+   {
+   case BlurMode::Reference:
+      return "Reference";
+   case BlurMode::LinearSampled:
+      return "LinearSampled";
+   case BlurMode::Compute:
+      return "Compute";
+   default:
+      break;
+   }
+
+   return "Unknown";
+}
+
+GaussianBlur::GaussianBlur( float sigma ) :
+   m_referenceShaders( "../Resources/Shaders/Blur.vs", "../Resources/Shaders/Blur.fs", [ ]( Shader& shader ) { shader.SetInt( "image", 0 ); } ),
+   m_linearShaders( "../Resources/Shaders/Blur.vs", "../Resources/Shaders/BlurLinear.fs", [ ]( Shader& shader ) { shader.SetInt( "image", 0 ); } ),
+   m_linearShader( nullptr )
+{
+   if ( IsComputeSupported( ) )
+   {
+      m_computeShader = std::make_unique<Shader>( "../Resources/Shaders/BlurCompute.cs" );
+   }
+
+   for ( auto& timer : m_timers )
+   {
+      timer = std::make_unique<GPUTimer>( );
+   }
+
+   m_referencePasses[ 0 ] = &m_referenceShaders.Get( { } );
+   m_referencePasses[ 1 ] = &m_referenceShaders.Get( { "HORIZONTAL" } );
+
+   SetSigma( sigma );
+}
+
+void GaussianBlur::SetSigma( float sigma )
+{
+   m_sigma = sigma;
+
+   // Clamp radius to what the fixed size shader arrays can hold
+   unsigned int radius = std::min( GaussianRadius( sigma ), std::min( MaxComputeRadius, ( MaxLinearTaps - 1 ) * 2 ) );
+   m_discreteKernel = BuildGaussianKernel( sigma, radius );
+   m_linearKernel = BuildLinearSampledKernel( sigma, radius );
+
+   m_linearShader = &m_linearShaders.Get( { "TAP_COUNT " + std::to_string( m_linearKernel.GetTapCount( ) ) } );
+   m_linearShader->Use( );
+   m_linearShader->SetFloatArray( "weights", m_linearKernel.Weights.data( ), m_linearKernel.GetTapCount( ) );
+   m_linearShader->SetFloatArray( "offsets", m_linearKernel.Offsets.data( ), m_linearKernel.GetTapCount( ) );
+
+   if ( m_computeShader != nullptr )
+   {
+      m_computeShader->Use( );
+      m_computeShader->SetInt( "image", 0 );
+      m_computeShader->SetInt( "radius", radius );
+      m_computeShader->SetFloatArray( "weights", m_discreteKernel.Weights.data( ), m_discreteKernel.GetTapCount( ) );
+   }
+}
+
+bool GaussianBlur::IsComputeSupported( )
+{
+   return GLAD_GL_VERSION_4_3 != 0;
+}
+
+unsigned int GaussianBlur::Apply( BlurMode mode, unsigned int source,
+                                  const unsigned int pingpongFBO[ 2 ], const unsigned int pingpongBuffer[ 2 ],
+                                  unsigned int width, unsigned int height, unsigned int iterations )
+{
+   if ( mode == BlurMode::Compute && m_computeShader == nullptr )
+   {
+      mode = BlurMode::LinearSampled;
+   }
+
+   GPUTimer& timer = GetTimer( mode );
+   timer.Begin( );
+   switch ( mode )
+   {
+   case BlurMode::Reference:
+      ApplyFragment( false, source, pingpongFBO, pingpongBuffer, width, height, iterations );
+      break;
+
+   case BlurMode::LinearSampled:
+      ApplyFragment( true, source, pingpongFBO, pingpongBuffer, width, height, iterations );
+      break;
+
+   case BlurMode::Compute:
+      ApplyCompute( source, pingpongBuffer, width, height, iterations );
+      break;
+
+   default:
+      break;
+   }
+   timer.End( );
+
+   // Last pass wrote into pingpongBuffer[ horizontal ] of the final iteration
+   bool lastHorizontal = ( iterations % 2 ) == 1;
+   return ( iterations > 0 ) ? pingpongBuffer[ lastHorizontal ] : source;
+}
+
+void GaussianBlur::ApplyFragment( bool linearSampled, unsigned int source,
+                                  const unsigned int pingpongFBO[ 2 ], const unsigned int pingpongBuffer[ 2 ],
+                                  unsigned int width, unsigned int height, unsigned int iterations )
+{
+   glViewport( 0, 0, width, height );
+
+   bool horizontal = true;
+   bool firstItr = true;
+   for ( unsigned int idx = 0; idx < iterations; ++idx )
+   {
+      glBindFramebuffer( GL_FRAMEBUFFER, pingpongFBO[ horizontal ] );
+      if ( linearSampled )
+      {
+         m_linearShader->Use( );
+         m_linearShader->SetVec2f( "direction", horizontal ? glm::vec2( 1.0f / width, 0.0f ) : glm::vec2( 0.0f, 1.0f / height ) );
+      }
+      else
+      {
+         // Direction is baked into the permutation
+         m_referencePasses[ horizontal ]->Use( );
+      }
+      glActiveTexture( GL_TEXTURE0 );
+      glBindTexture( GL_TEXTURE_2D, firstItr ? source : pingpongBuffer[ !horizontal ] );
+      renderQuad( );
+      horizontal = !horizontal;
+      firstItr = false;
+   }
+   glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+}
+
+void GaussianBlur::ApplyCompute( unsigned int source, const unsigned int pingpongBuffer[ 2 ],
+                                 unsigned int width, unsigned int height, unsigned int iterations )
+{
+   m_computeShader->Use( );
+
+   bool horizontal = true;
+   bool firstItr = true;
+   for ( unsigned int idx = 0; idx < iterations; ++idx )
+   {
+      m_computeShader->SetInt( "horizontal", horizontal );
+      glActiveTexture( GL_TEXTURE0 );
+      glBindTexture( GL_TEXTURE_2D, firstItr ? source : pingpongBuffer[ !horizontal ] );
+      glBindImageTexture( 0, pingpongBuffer[ horizontal ], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F );
+
+      unsigned int length = horizontal ? width : height;
+      unsigned int lines = horizontal ? height : width;
+      glDispatchCompute( ( length + ComputeTileSize - 1 ) / ComputeTileSize, lines, 1 );
+
+      // Next pass samples what this pass just stored
+      glMemoryBarrier( GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT );
+
+      horizontal = !horizontal;
+      firstItr = false;
+   }
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+#include "Shader.h"
+#include "GPUTimer.h"
+#include "GaussianKernel.h"
+#include "ShaderPermutations.h"
+
+#include <memory>
+
+enum class BlurMode
+{
+   Reference = 0,    // Blur.fs, 9 point samples per direction
+   LinearSampled,    // BlurLinear.fs, bilinear fetches between texel pairs
+   Compute,          // BlurCompute.cs, shared memory tile( 4.3+ )
+   EnumMax
+};
+
+const char* ToString( BlurMode mode );
+
+// Separable gaussian blur over a pair of ping-pong targets.
+// Every path is timed separately so they can be compared at runtime.
+class GaussianBlur
+{
+public:
+   explicit GaussianBlur( float sigma );
+
+   void SetSigma( float sigma );
+   float GetSigma( ) const { return m_sigma; }
+
+   // Compute path needs a 4.3 context and RGBA16F ping-pong textures.
+   static bool IsComputeSupported( );
+
+   // Runs 'iterations' blur passes( alternating horizontal/vertical ) starting from 'source'.
+   // Returns the ping-pong texture which holds the final result.
+   unsigned int Apply( BlurMode mode, unsigned int source,
+                       const unsigned int pingpongFBO[ 2 ], const unsigned int pingpongBuffer[ 2 ],
+                       unsigned int width, unsigned int height, unsigned int iterations );
+
+   GPUTimer& GetTimer( BlurMode mode ) { return *m_timers[ static_cast<int>( mode ) ]; }
+
+private:
+   void ApplyFragment( bool linearSampled, unsigned int source,
+                       const unsigned int pingpongFBO[ 2 ], const unsigned int pingpongBuffer[ 2 ],
+                       unsigned int width, unsigned int height, unsigned int iterations );
+   void ApplyCompute( unsigned int source, const unsigned int pingpongBuffer[ 2 ],
+                      unsigned int width, unsigned int height, unsigned int iterations );
+
+private:
+   static constexpr unsigned int MaxLinearTaps = 16;    // Bounds BlurLinear.fs TAP_COUNT permutations
+   static constexpr unsigned int MaxComputeRadius = 32; // BlurCompute.cs MAX_RADIUS
+   static constexpr unsigned int ComputeTileSize = 128; // BlurCompute.cs TILE_SIZE
+
+   float m_sigma;
+   GaussianKernel m_discreteKernel;
+   GaussianKernel m_linearKernel;
+
+   ShaderPermutations m_referenceShaders;  // Blur.fs, HORIZONTAL
+   ShaderPermutations m_linearShaders;     // BlurLinear.fs, TAP_COUNT
+   Shader* m_referencePasses[ 2 ];         // Vertical, horizontal
+   Shader* m_linearShader;                 // Permutation of the current kernel
+   std::unique_ptr<Shader> m_computeShader;
+
+   std::unique_ptr<GPUTimer> m_timers[ static_cast<int>( BlurMode::EnumMax ) ];
+
+};
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "GaussianKernel.h"
+
+#include <cmath>
+
+unsigned int GaussianRadius( float sigma )
+{
+   return static_cast<unsigned int>( std::ceil( 3.0f * sigma ) );
+}
+
+GaussianKernel BuildGaussianKernel( float sigma, unsigned int radius )
+{
+   GaussianKernel kernel;
+   kernel.Weights.resize( radius + 1 );
+   kernel.Offsets.resize( radius + 1 );
+
+   const float twoSigmaSq = 2.0f * sigma * sigma;
+   float sum = 0.0f;
+   for ( unsigned int idx = 0; idx <= radius; ++idx )
+   {
+      float weight = std::exp( -static_cast<float>( idx * idx ) / twoSigmaSq );
+      kernel.Weights[ idx ] = weight;
+      kernel.Offsets[ idx ] = static_cast<float>( idx );
+
+      // Every tap except center sampled at both sides
+      sum += ( idx == 0 ) ? weight : 2.0f * weight;
+   }
+
+   for ( float& weight : kernel.Weights )
+   {
+      weight /= sum;
+   }
+
+   return kernel;
+}
+
+GaussianKernel BuildLinearSampledKernel( float sigma, unsigned int radius )
+{
+   GaussianKernel discrete = BuildGaussianKernel( sigma, radius );
+
+   GaussianKernel kernel;
+   kernel.Weights.push_back( discrete.Weights[ 0 ] );
+   kernel.Offsets.push_back( 0.0f );
+
+   for ( unsigned int idx = 1; idx <= radius; idx += 2 )
+   {
+      float weight1 = discrete.Weights[ idx ];
+      float weight2 = ( idx + 1 <= radius ) ? discrete.Weights[ idx + 1 ] : 0.0f;
+      float weight = weight1 + weight2;
+
+      // offset between two texel centers, pulled towards the heavier one
+      float offset = ( discrete.Offsets[ idx ] * weight1 + ( discrete.Offsets[ idx ] + 1.0f ) * weight2 ) / weight;
+
+      kernel.Weights.push_back( weight );
+      kernel.Offsets.push_back( offset );
+   }
+
+   return kernel;
+}
\ No newline at end of file
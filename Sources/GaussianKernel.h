@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+
+// One side of a symmetric separable blur kernel. Weights[0]/Offsets[0] is the center tap,
+// every other tap is sampled at +Offsets[idx] and -Offsets[idx] (in texels).
+struct GaussianKernel
+{
+   std::vector<float> Weights;
+   std::vector<float> Offsets;
+
+   unsigned int GetTapCount( ) const { return static_cast<unsigned int>( Weights.size( ) ); }
+};
+
+// Radius which keeps ~99.7% of the gaussian energy (3 sigma).
+unsigned int GaussianRadius( float sigma );
+
+// Discrete kernel, one tap per texel: radius + 1 taps per side.
+GaussianKernel BuildGaussianKernel( float sigma, unsigned int radius );
+
+// Linear sampling kernel: pairs of neighbouring texels are merged into a single bilinear fetch placed
+// between them, weighted so that the hardware filter reproduces both discrete taps.
+// 9 discrete taps( radius 4 ) => 5 fetches.
+GaussianKernel BuildLinearSampledKernel( float sigma, unsigned int radius );
\ No newline at end of file
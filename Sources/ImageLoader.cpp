@@ -0,0 +1,28 @@
+#include "ImageLoader.h"
+
+#include <stb_image.h>
+
+#include <mutex>
+
+namespace
+{
+   std::mutex& GetDecodeMutex( )
+   {
+      static std::mutex mutex;
+      return mutex;
+   }
+}
+
+unsigned char* DecodeImage( const std::string& path, int& width, int& height, int& channels, int desiredChannels, bool flipVertically )
+{
+   std::lock_guard<std::mutex> lock( GetDecodeMutex( ) );
+   stbi_set_flip_vertically_on_load( flipVertically );
+   return stbi_load( path.c_str( ), &width, &height, &channels, desiredChannels );
+}
+
+float* DecodeImageLinear( const std::string& path, int& width, int& height, int& channels, int desiredChannels, bool flipVertically )
+{
+   std::lock_guard<std::mutex> lock( GetDecodeMutex( ) );
+   stbi_set_flip_vertically_on_load( flipVertically );
+   return stbi_loadf( path.c_str( ), &width, &height, &channels, desiredChannels );
+}
\ No newline at end of file
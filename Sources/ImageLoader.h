@@ -0,0 +1,10 @@
+#pragma once
+#include <string>
+
+// stb_image( v2.19 ) keeps the vertical flip flag and the failure reason in process globals. Every decode goes through
+// these so the flag is set and used under one lock, decodes running in jobs can not pick up another thread's setting.
+// Results are released with stbi_image_free.
+unsigned char* DecodeImage( const std::string& path, int& width, int& height, int& channels, int desiredChannels, bool flipVertically );
+
+// Float pixels, LDR sources are linearized with gamma 2.2( stbi_loadf ).
+float* DecodeImageLinear( const std::string& path, int& width, int& height, int& channels, int desiredChannels, bool flipVertically );
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "IrradianceSH.h"
+#include "AssetCache.h"
+#include "ImageLoader.h"
+#include "JobSystem.h"
+
+#include <stb_image.h>
+#include <emmintrin.h>
+
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+   constexpr float Pi = 3.14159265f;
+
+   // Per face direction = Major + s * SAxis + t * TAxis, s and t in [-1, 1]( OpenGL cube map table )
+   struct FaceBasis
+   {
+      glm::vec3 Major;
+      glm::vec3 SAxis;
+      glm::vec3 TAxis;
+   };
+
+   const FaceBasis FaceBases[ 6 ] =
+   {
+      { glm::vec3(  1.0f, 0.0f, 0.0f ), glm::vec3(  0.0f, 0.0f, -1.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ) },
+      { glm::vec3( -1.0f, 0.0f, 0.0f ), glm::vec3(  0.0f, 0.0f,  1.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ) },
+      { glm::vec3( 0.0f,  1.0f, 0.0f ), glm::vec3(  1.0f, 0.0f,  0.0f ), glm::vec3( 0.0f, 0.0f,  1.0f ) },
+      { glm::vec3( 0.0f, -1.0f, 0.0f ), glm::vec3(  1.0f, 0.0f,  0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ) },
+      { glm::vec3( 0.0f, 0.0f,  1.0f ), glm::vec3(  1.0f, 0.0f,  0.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ) },
+      { glm::vec3( 0.0f, 0.0f, -1.0f ), glm::vec3( -1.0f, 0.0f,  0.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ) }
+   };
+
+   // Real SH basis up to band 2, 4 directions at a time
+   void EvaluateBasis( __m128 x, __m128 y, __m128 z, __m128 basis[ IrradianceSH::CoefficientCount ] )
+   {
+      basis[ 0 ] = _mm_set1_ps( 0.282095f );
+      basis[ 1 ] = _mm_mul_ps( _mm_set1_ps( 0.488603f ), y );
+      basis[ 2 ] = _mm_mul_ps( _mm_set1_ps( 0.488603f ), z );
+      basis[ 3 ] = _mm_mul_ps( _mm_set1_ps( 0.488603f ), x );
+      basis[ 4 ] = _mm_mul_ps( _mm_set1_ps( 1.092548f ), _mm_mul_ps( x, y ) );
+      basis[ 5 ] = _mm_mul_ps( _mm_set1_ps( 1.092548f ), _mm_mul_ps( y, z ) );
+      basis[ 6 ] = _mm_mul_ps( _mm_set1_ps( 0.315392f ), _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( 3.0f ), _mm_mul_ps( z, z ) ), _mm_set1_ps( 1.0f ) ) );
+      basis[ 7 ] = _mm_mul_ps( _mm_set1_ps( 1.092548f ), _mm_mul_ps( x, z ) );
+      basis[ 8 ] = _mm_mul_ps( _mm_set1_ps( 0.546274f ), _mm_sub_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ) );
+   }
+
+   float HorizontalSum( __m128 value )
+   {
+      float lanes[ 4 ];
+      _mm_storeu_ps( lanes, value );
+      return lanes[ 0 ] + lanes[ 1 ] + lanes[ 2 ] + lanes[ 3 ];
+   }
+
+   // Radiance * basis * solid angle summed over one face, channels interleaved per coefficient( r, g, b ).
+   // Row sums are accumulated in double, float lanes alone lose the small texels of large faces.
+   void ProjectFace( const float* pixels, int size, const FaceBasis& face, double sums[ IrradianceSH::CoefficientCount * 3 ], double& weightSum )
+   {
+      const float texelScale = 2.0f / size;
+      const __m128 laneOffsets = _mm_setr_ps( 0.5f, 1.5f, 2.5f, 3.5f );
+
+      for ( int row = 0; row < size; ++row )
+      {
+         // Image row 0 is t = -1
+         float t = ( row + 0.5f ) * texelScale - 1.0f;
+         __m128 accum[ IrradianceSH::CoefficientCount * 3 ];
+         for ( auto& value : accum )
+         {
+            value = _mm_setzero_ps( );
+         }
+         __m128 weightAccum = _mm_setzero_ps( );
+
+         // Texels past the row end get zero weight
+         for ( int column = 0; column < size; column += 4 )
+         {
+            __m128 s = _mm_sub_ps( _mm_mul_ps( _mm_add_ps( _mm_set1_ps( static_cast<float>( column ) ), laneOffsets ), _mm_set1_ps( texelScale ) ),
+                                   _mm_set1_ps( 1.0f ) );
+            __m128 x = _mm_add_ps( _mm_set1_ps( face.Major.x + t * face.TAxis.x ), _mm_mul_ps( s, _mm_set1_ps( face.SAxis.x ) ) );
+            __m128 y = _mm_add_ps( _mm_set1_ps( face.Major.y + t * face.TAxis.y ), _mm_mul_ps( s, _mm_set1_ps( face.SAxis.y ) ) );
+            __m128 z = _mm_add_ps( _mm_set1_ps( face.Major.z + t * face.TAxis.z ), _mm_mul_ps( s, _mm_set1_ps( face.SAxis.z ) ) );
+
+            // Solid angle of a texel: texel area / ( 1 + s^2 + t^2 )^( 3 / 2 )
+            __m128 lengthSq = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+            __m128 invLength = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( lengthSq ) );
+            __m128 weight = _mm_mul_ps( _mm_set1_ps( texelScale * texelScale ), _mm_mul_ps( invLength, _mm_mul_ps( invLength, invLength ) ) );
+            x = _mm_mul_ps( x, invLength );
+            y = _mm_mul_ps( y, invLength );
+            z = _mm_mul_ps( z, invLength );
+
+            float channels[ 3 ][ 4 ] = { };
+            float weights[ 4 ];
+            _mm_storeu_ps( weights, weight );
+            for ( int lane = 0; lane < 4; ++lane )
+            {
+               if ( column + lane >= size )
+               {
+                  weights[ lane ] = 0.0f;
+                  continue;
+               }
+               const float* texel = pixels + ( static_cast<size_t>( row ) * size + column + lane ) * 3;
+               channels[ 0 ][ lane ] = texel[ 0 ];
+               channels[ 1 ][ lane ] = texel[ 1 ];
+               channels[ 2 ][ lane ] = texel[ 2 ];
+            }
+            weight = _mm_loadu_ps( weights );
+            weightAccum = _mm_add_ps( weightAccum, weight );
+
+            __m128 basis[ IrradianceSH::CoefficientCount ];
+            EvaluateBasis( x, y, z, basis );
+            for ( int channel = 0; channel < 3; ++channel )
+            {
+               __m128 radiance = _mm_mul_ps( _mm_loadu_ps( channels[ channel ] ), weight );
+               for ( unsigned int idx = 0; idx < IrradianceSH::CoefficientCount; ++idx )
+               {
+                  accum[ idx * 3 + channel ] = _mm_add_ps( accum[ idx * 3 + channel ], _mm_mul_ps( radiance, basis[ idx ] ) );
+               }
+            }
+         }
+
+         for ( unsigned int idx = 0; idx < IrradianceSH::CoefficientCount * 3; ++idx )
+         {
+            sums[ idx ] += HorizontalSum( accum[ idx ] );
+         }
+         weightSum += HorizontalSum( weightAccum );
+      }
+   }
+
+   bool ReadCache( const std::vector<std::string>& faces, const std::string& cachePath, IrradianceSH& result )
+   {
+      if ( !IsCacheFresh( cachePath, faces ) )
+      {
+         return false;
+      }
+
+      std::ifstream file( cachePath );
+      for ( auto& coefficient : result.Coefficients )
+      {
+         file >> coefficient.r >> coefficient.g >> coefficient.b;
+      }
+      return static_cast<bool>( file );
+   }
+}
+
+void IrradianceSH::Bind( const Shader& shader, float intensity ) const
+{
+   glm::vec3 scaled[ CoefficientCount ];
+   for ( unsigned int idx = 0; idx < CoefficientCount; ++idx )
+   {
+      scaled[ idx ] = Coefficients[ idx ] * intensity;
+   }
+   shader.SetVec3fArray( "ambientSH", scaled, CoefficientCount );
+}
+
+bool BakeIrradianceSH( const std::vector<std::string>& faces, IrradianceSH& result )
+{
+   if ( faces.size( ) != 6 )
+   {
+      std::cout << "Irradiance bake needs 6 cube map faces" << std::endl;
+      return false;
+   }
+
+   // Decodes are serialized by DecodeImageLinear( stb_image globals ), only the projection below runs in parallel
+   std::vector<float*> pixels( 6, nullptr );
+   int widths[ 6 ] = { };
+   int heights[ 6 ] = { };
+   for ( unsigned int idx = 0; idx < 6; ++idx )
+   {
+      int channels = 0;
+      pixels[ idx ] = DecodeImageLinear( faces[ idx ], widths[ idx ], heights[ idx ], channels, 3, false );
+   }
+
+   int size = widths[ 0 ];
+   bool loaded = true;
+   for ( unsigned int idx = 0; idx < 6; ++idx )
+   {
+      if ( pixels[ idx ] == nullptr || widths[ idx ] != heights[ idx ] || widths[ idx ] != size )
+      {
+         std::cout << "Failed to load cubemap face for irradiance : " << faces[ idx ] << std::endl;
+         loaded = false;
+      }
+   }
+
+   if ( loaded )
+   {
+      const unsigned int SumCount = IrradianceSH::CoefficientCount * 3;
+      double sums[ 6 ][ SumCount ] = { };
+      double weightSums[ 6 ] = { };
+      ParallelFor( 6, 1, [ & ]( size_t begin, size_t end )
+      {
+         for ( size_t idx = begin; idx < end; ++idx )
+         {
+            ProjectFace( pixels[ idx ], size, FaceBases[ idx ], sums[ idx ], weightSums[ idx ] );
+         }
+      } );
+
+      // Cosine lobe convolution per band( pi, 2pi / 3, pi / 4 ) divided by pi, the discrete solid angles are
+      // renormalized to the full sphere
+      const float BandScales[ 3 ] = { 1.0f, 2.0f / 3.0f, 0.25f };
+      double weightSum = 0.0;
+      for ( double faceWeight : weightSums )
+      {
+         weightSum += faceWeight;
+      }
+      double normalization = 4.0 * Pi / weightSum;
+
+      for ( unsigned int idx = 0; idx < IrradianceSH::CoefficientCount; ++idx )
+      {
+         float bandScale = BandScales[ ( idx == 0 ) ? 0 : ( idx < 4 ) ? 1 : 2 ];
+         for ( int channel = 0; channel < 3; ++channel )
+         {
+            double sum = 0.0;
+            for ( unsigned int face = 0; face < 6; ++face )
+            {
+               sum += sums[ face ][ idx * 3 + channel ];
+            }
+            result.Coefficients[ idx ][ channel ] = static_cast<float>( sum * normalization ) * bandScale;
+         }
+      }
+   }
+
+   for ( float* facePixels : pixels )
+   {
+      stbi_image_free( facePixels );
+   }
+
+   return loaded;
+}
+
+IrradianceSH LoadIrradianceSH( const std::vector<std::string>& faces, const std::string& cachePath )
+{
+   IrradianceSH result;
+   if ( ReadCache( faces, cachePath, result ) )
+   {
+      return result;
+   }
+
+   if ( !BakeIrradianceSH( faces, result ) )
+   {
+      return IrradianceSH( );
+   }
+
+   std::ofstream file( cachePath );
+   for ( const auto& coefficient : result.Coefficients )
+   {
+      file << coefficient.r << " " << coefficient.g << " " << coefficient.b << "\n";
+   }
+   if ( !file )
+   {
+      std::cout << "Failed to write irradiance cache : " << cachePath << std::endl;
+   }
+
+   return result;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include "Shader.h"
+
+#include <string>
+#include <vector>
+
+// Diffuse ambient light of an environment as L2 spherical harmonics( 9 RGB coefficients ).
+// Coefficients are already convolved with the clamped cosine lobe and divided by pi, so evaluating them at a
+// normal gives the factor to multiply albedo with( Bloom.fs / DeferredLighting.fs AmbientIrradiance ).
+struct IrradianceSH
+{
+   static constexpr unsigned int CoefficientCount = 9;
+
+   glm::vec3 Coefficients[ CoefficientCount ] = { };
+
+   // Sets 'ambientSH', scaled by 'intensity'. Shader must be in use.
+   void Bind( const Shader& shader, float intensity ) const;
+};
+
+// Projects a cube map( faces in LoadCubeMap order: +X, -X, +Y, -Y, +Z, -Z ) onto the SH basis.
+// LDR faces are linearized, every texel is weighted by its solid angle. One job per face, 4 texels per SSE step.
+bool BakeIrradianceSH( const std::vector<std::string>& faces, IrradianceSH& result );
+
+// Reads 'cachePath' when it is newer than every face, otherwise bakes and rewrites it.
+IrradianceSH LoadIrradianceSH( const std::vector<std::string>& faces, const std::string& cachePath );
\ No newline at end of file
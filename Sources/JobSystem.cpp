@@ -0,0 +1,278 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+   JobSystem* s_current = nullptr;
+
+   // Queue owned by the calling thread, -1 for threads outside the job system( ex. FileWatcher )
+   thread_local int t_queueIndex = -1;
+}
+
+JobSystem::JobSystem( unsigned int workerCount ) :
+   m_mainThread( std::this_thread::get_id( ) ),
+   m_running( true ),
+   m_queuedJobs( 0 )
+{
+   if ( workerCount == 0 )
+   {
+      unsigned int hardwareThreads = std::thread::hardware_concurrency( );
+      workerCount = std::max( hardwareThreads, 2u ) - 1;
+   }
+
+   for ( unsigned int idx = 0; idx <= workerCount; ++idx )
+   {
+      m_queues.emplace_back( new WorkerQueue( ) );
+   }
+
+   t_queueIndex = 0;
+   s_current = this;
+
+   for ( unsigned int idx = 1; idx <= workerCount; ++idx )
+   {
+      m_threads.emplace_back( &JobSystem::WorkerLoop, this, idx );
+   }
+}
+
+JobSystem::~JobSystem( )
+{
+   // Jobs still queued are dropped, callers wait on their counters before shutting down
+   {
+      std::lock_guard<std::mutex> lock( m_sleepMutex );
+      m_running = false;
+   }
+   m_wake.notify_all( );
+
+   for ( auto& thread : m_threads )
+   {
+      thread.join( );
+   }
+
+   t_queueIndex = -1;
+   s_current = nullptr;
+}
+
+JobSystem* JobSystem::GetCurrent( )
+{
+   return s_current;
+}
+
+void JobSystem::Run( std::function<void( )> function, JobCounter* counter, JobCounter* dependency )
+{
+   if ( counter != nullptr )
+   {
+      ++counter->m_value;
+   }
+
+   Job job{ std::move( function ), counter };
+   if ( dependency != nullptr )
+   {
+      // Checked under the lock Finish( ) takes before releasing continuations, so the job is either parked or pushed here
+      std::lock_guard<std::mutex> lock( dependency->m_mutex );
+      if ( dependency->m_value.load( ) != 0 )
+      {
+         dependency->m_continuations.push_back( std::move( job ) );
+         return;
+      }
+   }
+
+   Push( std::move( job ) );
+}
+
+void JobSystem::RunOnMainThread( std::function<void( )> function, JobCounter* counter )
+{
+   if ( counter != nullptr )
+   {
+      ++counter->m_value;
+   }
+
+   std::lock_guard<std::mutex> lock( m_mainThreadMutex );
+   m_mainThreadJobs.push_back( Job{ std::move( function ), counter } );
+}
+
+void JobSystem::Wait( JobCounter& counter )
+{
+   bool mainThread = IsMainThread( );
+   while ( !counter.IsDone( ) )
+   {
+      if ( mainThread )
+      {
+         ProcessMainThreadJobs( );
+      }
+
+      if ( !TryRunJob( ) )
+      {
+         std::this_thread::yield( );
+      }
+   }
+
+   std::lock_guard<std::mutex> lock( counter.m_mutex );
+}
+
+void JobSystem::ProcessMainThreadJobs( )
+{
+   if ( !IsMainThread( ) )
+   {
+      return;
+   }
+
+   std::vector<Job> jobs;
+   {
+      std::lock_guard<std::mutex> lock( m_mainThreadMutex );
+      jobs.swap( m_mainThreadJobs );
+   }
+
+   for ( auto& job : jobs )
+   {
+      job.Function( );
+      Finish( job.Counter );
+   }
+}
+
+void JobSystem::ParallelFor( size_t count, size_t batchSize, const std::function<void( size_t, size_t )>& function )
+{
+   batchSize = std::max( batchSize, size_t( 1 ) );
+   if ( count <= batchSize )
+   {
+      function( 0, count );
+      return;
+   }
+
+   // Last range runs on the calling thread instead of idling in Wait( )
+   JobCounter counter;
+   size_t lastBegin = ( ( count - 1 ) / batchSize ) * batchSize;
+   for ( size_t begin = 0; begin < lastBegin; begin += batchSize )
+   {
+      size_t end = begin + batchSize;
+      Run( [ &function, begin, end ]( )
+      {
+         function( begin, end );
+      }, &counter );
+   }
+
+   function( lastBegin, count );
+   Wait( counter );
+}
+
+void JobSystem::WorkerLoop( unsigned int queueIndex )
+{
+   t_queueIndex = static_cast<int>( queueIndex );
+   while ( m_running )
+   {
+      if ( TryRunJob( ) )
+      {
+         continue;
+      }
+
+      std::unique_lock<std::mutex> lock( m_sleepMutex );
+      m_wake.wait( lock, [ this ]( )
+      {
+         return !m_running || m_queuedJobs.load( ) > 0;
+      } );
+   }
+}
+
+void JobSystem::Push( Job job )
+{
+   // Threads outside the system hand their jobs to the main thread queue, workers steal from there as well
+   unsigned int queueIndex = ( t_queueIndex >= 0 ) ? static_cast<unsigned int>( t_queueIndex ) : 0;
+   {
+      std::lock_guard<std::mutex> lock( m_queues[ queueIndex ]->Mutex );
+      m_queues[ queueIndex ]->Jobs.push_back( std::move( job ) );
+   }
+
+   // Empty critical section orders the increment against a worker between its predicate check and sleeping
+   ++m_queuedJobs;
+   {
+      std::lock_guard<std::mutex> lock( m_sleepMutex );
+   }
+   m_wake.notify_one( );
+}
+
+bool JobSystem::TryRunJob( )
+{
+   Job job;
+   bool found = false;
+
+   int ownIndex = t_queueIndex;
+   if ( ownIndex >= 0 )
+   {
+      WorkerQueue& own = *m_queues[ ownIndex ];
+      std::lock_guard<std::mutex> lock( own.Mutex );
+      if ( !own.Jobs.empty( ) )
+      {
+         job = std::move( own.Jobs.back( ) );
+         own.Jobs.pop_back( );
+         found = true;
+      }
+   }
+
+   // Victims in order starting after our own queue so thieves spread over different queues
+   unsigned int queueCount = static_cast<unsigned int>( m_queues.size( ) );
+   unsigned int start = static_cast<unsigned int>( std::max( ownIndex, 0 ) ) + 1;
+   for ( unsigned int offset = 0; offset < queueCount && !found; ++offset )
+   {
+      unsigned int victimIndex = ( start + offset ) % queueCount;
+      if ( static_cast<int>( victimIndex ) == ownIndex )
+      {
+         continue;
+      }
+
+      WorkerQueue& victim = *m_queues[ victimIndex ];
+      std::lock_guard<std::mutex> lock( victim.Mutex );
+      if ( !victim.Jobs.empty( ) )
+      {
+         job = std::move( victim.Jobs.front( ) );
+         victim.Jobs.pop_front( );
+         found = true;
+      }
+   }
+
+   if ( !found )
+   {
+      return false;
+   }
+
+   --m_queuedJobs;
+   job.Function( );
+   Finish( job.Counter );
+   return true;
+}
+
+void JobSystem::Finish( JobCounter* counter )
+{
+   if ( counter == nullptr )
+   {
+      return;
+   }
+
+   // Decrement under the lock: Wait( ) takes it once more before returning, so the counter can not be destroyed
+   // while this thread still touches it
+   std::vector<Job> continuations;
+   {
+      std::lock_guard<std::mutex> lock( counter->m_mutex );
+      if ( --counter->m_value == 0 )
+      {
+         continuations.swap( counter->m_continuations );
+      }
+   }
+
+   for ( auto& job : continuations )
+   {
+      Push( std::move( job ) );
+   }
+}
+
+void ParallelFor( size_t count, size_t batchSize, const std::function<void( size_t, size_t )>& function )
+{
+   JobSystem* jobs = JobSystem::GetCurrent( );
+   if ( jobs != nullptr )
+   {
+      jobs->ParallelFor( count, batchSize, function );
+   }
+   else if ( count > 0 )
+   {
+      function( 0, count );
+   }
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobCounter;
+
+struct Job
+{
+   std::function<void( )> Function;
+   JobCounter* Counter = nullptr;   // Decremented once Function returned
+};
+
+// Number of unfinished jobs submitted with it. Also a dependency: jobs submitted behind a counter are held
+// until it drops to zero. Must outlive the jobs referencing it.
+class JobCounter
+{
+public:
+   JobCounter( ) : m_value( 0 ) { }
+
+   JobCounter( const JobCounter& ) = delete;
+   JobCounter& operator=( const JobCounter& ) = delete;
+
+   bool IsDone( ) const { return m_value.load( ) == 0; }
+
+private:
+   friend class JobSystem;
+
+   std::atomic<uint32_t> m_value;
+   std::mutex m_mutex;
+   std::vector<Job> m_continuations;
+
+};
+
+// Work stealing scheduler. Every thread owns a deque: the owner pushes and pops at the back( newest first, cache warm ),
+// idle threads steal from the front of the others( oldest, usually the biggest piece of work ).
+// The creating thread is the main thread and takes part while it waits. GL calls must stay on it, jobs hand them over
+// through RunOnMainThread( ) which only runs from ProcessMainThreadJobs( ) / Wait( ) on the main thread.
+class JobSystem
+{
+public:
+   // 0 = one worker per hardware thread besides the main thread
+   explicit JobSystem( unsigned int workerCount = 0 );
+   ~JobSystem( );
+
+   JobSystem( const JobSystem& ) = delete;
+   JobSystem& operator=( const JobSystem& ) = delete;
+
+   // Instance owned by main( ), nullptr outside its lifetime
+   static JobSystem* GetCurrent( );
+
+   unsigned int GetWorkerCount( ) const { return static_cast<unsigned int>( m_threads.size( ) ); }
+   bool IsMainThread( ) const { return std::this_thread::get_id( ) == m_mainThread; }
+
+   // 'dependency' holds the job back until that counter is done.
+   void Run( std::function<void( )> function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr );
+   void RunOnMainThread( std::function<void( )> function, JobCounter* counter = nullptr );
+
+   // Runs other jobs( on the main thread main thread jobs too ) until 'counter' is done.
+   void Wait( JobCounter& counter );
+
+   // Main thread only, once per frame. Runs every main thread job queued so far.
+   void ProcessMainThreadJobs( );
+
+   // function( begin, end ) over [ 0, count ) in ranges of 'batchSize', returns when all ranges finished.
+   void ParallelFor( size_t count, size_t batchSize, const std::function<void( size_t, size_t )>& function );
+
+private:
+   struct WorkerQueue
+   {
+      std::mutex Mutex;
+      std::deque<Job> Jobs;
+   };
+
+   void WorkerLoop( unsigned int queueIndex );
+   void Push( Job job );
+   bool TryRunJob( );
+   void Finish( JobCounter* counter );
+
+private:
+   // [ 0 ] belongs to the main thread
+   std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+   std::vector<std::thread> m_threads;
+   std::thread::id m_mainThread;
+
+   std::atomic<bool> m_running;
+   std::atomic<uint32_t> m_queuedJobs;
+   std::mutex m_sleepMutex;
+   std::condition_variable m_wake;
+
+   std::mutex m_mainThreadMutex;
+   std::vector<Job> m_mainThreadJobs;
+
+};
+
+// JobSystem::ParallelFor on the current job system, inline on the calling thread when there is none.
+void ParallelFor( size_t count, size_t batchSize, const std::function<void( size_t, size_t )>& function );
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "LightManager.h"
+
+#include <algorithm>
+#include <cmath>
+
+float ComputeLightRadius( const glm::vec3& color, float threshold )
+{
+   float maxComponent = std::max( color.r, std::max( color.g, color.b ) );
+   return std::sqrt( std::max( maxComponent, 0.0f ) / threshold );
+}
+
+LightManager::LightManager( ) :
+   m_capacityBytes( 0 ),
+   m_dirty( true )
+{
+   glGenBuffers( 1, &m_buffer );
+   glGenTextures( 1, &m_texture );
+   glBindBuffer( GL_TEXTURE_BUFFER, m_buffer );
+   glBufferData( GL_TEXTURE_BUFFER, 16, nullptr, GL_DYNAMIC_DRAW );
+   glBindTexture( GL_TEXTURE_BUFFER, m_texture );
+   glTexBuffer( GL_TEXTURE_BUFFER, GL_RGBA32F, m_buffer );
+   glBindTexture( GL_TEXTURE_BUFFER, 0 );
+   glBindBuffer( GL_TEXTURE_BUFFER, 0 );
+}
+
+LightManager::~LightManager( )
+{
+   glDeleteTextures( 1, &m_texture );
+   glDeleteBuffers( 1, &m_buffer );
+}
+
+unsigned int LightManager::Add( const glm::vec3& position, const glm::vec3& color, float radius )
+{
+   m_positions.push_back( position );
+   m_colors.push_back( color );
+   m_radii.push_back( ( radius > 0.0f ) ? radius : ComputeLightRadius( color ) );
+   m_shadowSlots.push_back( -1 );
+   m_dirty = true;
+   return GetCount( ) - 1;
+}
+
+void LightManager::Clear( )
+{
+   m_positions.clear( );
+   m_colors.clear( );
+   m_radii.clear( );
+   m_shadowSlots.clear( );
+   m_dirty = true;
+}
+
+void LightManager::SetPosition( unsigned int light, const glm::vec3& position )
+{
+   m_positions[ light ] = position;
+   m_dirty = true;
+}
+
+void LightManager::SetColor( unsigned int light, const glm::vec3& color, float radius )
+{
+   m_colors[ light ] = color;
+   m_radii[ light ] = ( radius > 0.0f ) ? radius : ComputeLightRadius( color );
+   m_dirty = true;
+}
+
+void LightManager::SetShadowSlot( unsigned int light, int slot )
+{
+   if ( m_shadowSlots[ light ] != slot )
+   {
+      m_shadowSlots[ light ] = slot;
+      m_dirty = true;
+   }
+}
+
+void LightManager::Upload( )
+{
+   if ( !m_dirty )
+   {
+      return;
+   }
+
+   unsigned int count = GetCount( );
+   m_packed.resize( count * 8 );
+   for ( unsigned int idx = 0; idx < count; ++idx )
+   {
+      float* data = &m_packed[ idx * 8 ];
+      data[ 0 ] = m_positions[ idx ].x;
+      data[ 1 ] = m_positions[ idx ].y;
+      data[ 2 ] = m_positions[ idx ].z;
+      data[ 3 ] = m_radii[ idx ];
+      data[ 4 ] = m_colors[ idx ].r;
+      data[ 5 ] = m_colors[ idx ].g;
+      data[ 6 ] = m_colors[ idx ].b;
+      data[ 7 ] = static_cast<float>( m_shadowSlots[ idx ] );
+   }
+
+   size_t bytes = m_packed.size( ) * sizeof( float );
+   glBindBuffer( GL_TEXTURE_BUFFER, m_buffer );
+   if ( bytes > m_capacityBytes )
+   {
+      // Reallocation only while the light count grows
+      m_capacityBytes = std::max( bytes, m_capacityBytes * 2 );
+      glBufferData( GL_TEXTURE_BUFFER, m_capacityBytes, nullptr, GL_DYNAMIC_DRAW );
+   }
+   if ( bytes > 0 )
+   {
+      glBufferSubData( GL_TEXTURE_BUFFER, 0, bytes, m_packed.data( ) );
+   }
+   glBindBuffer( GL_TEXTURE_BUFFER, 0 );
+
+   m_dirty = false;
+}
+
+void LightManager::Bind( const Shader& shader, unsigned int textureUnit ) const
+{
+   glActiveTexture( GL_TEXTURE0 + textureUnit );
+   glBindTexture( GL_TEXTURE_BUFFER, m_texture );
+   shader.SetInt( "lightData", textureUnit );
+   glActiveTexture( GL_TEXTURE0 );
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include "Shader.h"
+
+#include <vector>
+
+// Distance where color / distance^2 falls below 'threshold'( per channel ).
+float ComputeLightRadius( const glm::vec3& color, float threshold = 0.02f );
+
+// Point lights stored as parallel arrays( SoA ): culling only touches positions and radii.
+// Upload( ) packs every light into one persistent texture buffer with a single glBufferSubData, the same buffer
+// feeds the clustered shading loops and the instanced light proxies( gl_InstanceID ).
+//  lightData : 2 texels per light( position.xyz + radius, color.rgb + shadow slot )
+class LightManager
+{
+public:
+   LightManager( );
+   ~LightManager( );
+
+   LightManager( const LightManager& ) = delete;
+   LightManager& operator=( const LightManager& ) = delete;
+
+   // Radius <= 0 derives it from the color with ComputeLightRadius.
+   unsigned int Add( const glm::vec3& position, const glm::vec3& color, float radius = 0.0f );
+   void Clear( );
+
+   void SetPosition( unsigned int light, const glm::vec3& position );
+   void SetColor( unsigned int light, const glm::vec3& color, float radius = 0.0f );
+
+   // Shadow map slot sampled for the light, -1 = unshadowed( default ). See PointShadowRenderer.
+   void SetShadowSlot( unsigned int light, int slot );
+
+   unsigned int GetCount( ) const { return static_cast<unsigned int>( m_positions.size( ) ); }
+   const std::vector<glm::vec3>& GetPositions( ) const { return m_positions; }
+   const std::vector<glm::vec3>& GetColors( ) const { return m_colors; }
+   const std::vector<float>& GetRadii( ) const { return m_radii; }
+   const std::vector<int>& GetShadowSlots( ) const { return m_shadowSlots; }
+
+   // Uploads only when something changed since the last call. Storage grows geometrically and is never shrunk.
+   void Upload( );
+
+   // Binds lightData to 'textureUnit' and sets the sampler. Shader must be in use.
+   void Bind( const Shader& shader, unsigned int textureUnit ) const;
+
+private:
+   std::vector<glm::vec3> m_positions;
+   std::vector<glm::vec3> m_colors;
+   std::vector<float> m_radii;
+   std::vector<int> m_shadowSlots;
+
+   std::vector<float> m_packed;
+   unsigned int m_buffer;
+   unsigned int m_texture;
+   size_t m_capacityBytes;
+   bool m_dirty;
+
+};
\ No newline at end of file
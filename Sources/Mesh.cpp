@@ -44,7 +44,7 @@ void Mesh::SetupMesh()
    //glGenBuffers( 1, & )
 }
 
-void Mesh::Draw(Shader shader, unsigned int instAmount)
+void Mesh::Draw(const Shader& shader, unsigned int instAmount)
 {
    unsigned int diffuseNr = 0;
    unsigned int specularNr = 0;
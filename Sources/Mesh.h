@@ -30,7 +30,7 @@ public:
       const std::vector<unsigned int>& indices,
       const std::vector<Texture>& textures );
 
-   void Draw(Shader shader, unsigned int instAmount);
+   void Draw(const Shader& shader, unsigned int instAmount);
 
    unsigned int GetVAO( ) const { return VAO; }
 
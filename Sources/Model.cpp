@@ -1,7 +1,25 @@
 #include "Model.h"
+#include "JobSystem.h"
 
-void Model::Draw(Shader shader)
+#include <algorithm>
+#include <cfloat>
+
+void Model::Draw(const Shader& shader)
 {
+   // Only meshes under a moved node are re uploaded, a static model costs nothing here
+   m_sceneGraph.Update( );
+   const std::vector<unsigned int>& updatedNodes = m_sceneGraph.GetUpdatedNodes( );
+   if ( !updatedNodes.empty( ) )
+   {
+      for ( unsigned int idx = 0; idx < m_meshes.size( ); ++idx )
+      {
+         if ( std::binary_search( updatedNodes.begin( ), updatedNodes.end( ), m_meshNodes[ idx ] ) )
+         {
+            UploadInstances( idx );
+         }
+      }
+   }
+
    for (unsigned int idx = 0; idx < m_meshes.size(); ++idx)
    {
       m_meshes[idx].Draw(shader, m_instAmount);
@@ -21,22 +39,47 @@ void Model::LoadModel(const std::string& path)
    }
    m_directory = path.substr(0, path.find_last_of('/'));
 
-   ProcessNode(scene->mRootNode, scene);
+   ProcessNode(scene->mRootNode, scene, SceneGraph::NoParent);
+   m_sceneGraph.Update( );
 }
 
-void Model::ProcessNode(aiNode* node, const aiScene* scene)
+void Model::ProcessNode(aiNode* node, const aiScene* scene, int parentNode)
 {
+   // aiMatrix4x4 is row major, glm is column major
+   const aiMatrix4x4& transform = node->mTransformation;
+   glm::mat4 local( transform.a1, transform.b1, transform.c1, transform.d1,
+                    transform.a2, transform.b2, transform.c2, transform.d2,
+                    transform.a3, transform.b3, transform.c3, transform.d3,
+                    transform.a4, transform.b4, transform.c4, transform.d4 );
+
+   // Depth first, parents always get a lower index than their children
+   unsigned int sceneNode = m_sceneGraph.AddNode( parentNode, local, node->mName.C_Str( ) );
+
    // Process all the current node's meshes
+   glm::vec3 boundsMin( FLT_MAX );
+   glm::vec3 boundsMax( -FLT_MAX );
    for (unsigned int idx = 0; idx < node->mNumMeshes; ++idx)
    {
       aiMesh* mesh = scene->mMeshes[node->mMeshes[idx]];
       m_meshes.push_back(ProcessMesh(mesh, scene));
+      m_meshNodes.push_back(sceneNode);
+
+      for ( const auto& vertex : m_meshes.back( ).m_vertices )
+      {
+         boundsMin = glm::min( boundsMin, vertex.Position );
+         boundsMax = glm::max( boundsMax, vertex.Position );
+      }
+   }
+
+   if ( node->mNumMeshes > 0 )
+   {
+      m_sceneGraph.SetLocalBounds( sceneNode, boundsMin, boundsMax );
    }
 
    // also call this function recursively for children
    for (unsigned int idx = 0; idx < node->mNumChildren; ++idx)
    {
-      ProcessNode(node->mChildren[idx], scene);
+      ProcessNode(node->mChildren[idx], scene, static_cast<int>( sceneNode ));
    }
 }
 
@@ -46,29 +89,31 @@ Mesh Model::ProcessMesh( aiMesh* mesh, const aiScene* scene )
    std::vector<unsigned int> indices;
    std::vector<Texture> textures;
 
-   // Process vertices
-   for ( unsigned int idx = 0; idx < mesh->mNumVertices; ++idx )
+   // Process vertices, independent per vertex so large meshes are converted in parallel ranges
+   vertices.resize( mesh->mNumVertices );
+   ParallelFor( mesh->mNumVertices, 4096, [ & ]( size_t begin, size_t end )
    {
-      Vertex vertex;
-      vertex.Position = glm::vec3( mesh->mVertices[ idx ].x,
-                                   mesh->mVertices[ idx ].y,
-                                   mesh->mVertices[ idx ].z );
-      vertex.Normal = glm::vec3( mesh->mNormals[ idx ].x,
-                                 mesh->mNormals[ idx ].y,
-                                 mesh->mNormals[ idx ].z );
-
-      if ( mesh->mTextureCoords[ 0 ] != nullptr )
+      for ( size_t idx = begin; idx < end; ++idx )
       {
-         vertex.TexCoords = glm::vec2( mesh->mTextureCoords[ 0 ][ idx ].x,
-                                       mesh->mTextureCoords[ 0 ][ idx ].y );
-      }
-      else
-      {
-         vertex.TexCoords = glm::vec2( 0.0f, 0.0f );
+         Vertex& vertex = vertices[ idx ];
+         vertex.Position = glm::vec3( mesh->mVertices[ idx ].x,
+                                      mesh->mVertices[ idx ].y,
+                                      mesh->mVertices[ idx ].z );
+         vertex.Normal = glm::vec3( mesh->mNormals[ idx ].x,
+                                    mesh->mNormals[ idx ].y,
+                                    mesh->mNormals[ idx ].z );
+
+         if ( mesh->mTextureCoords[ 0 ] != nullptr )
+         {
+            vertex.TexCoords = glm::vec2( mesh->mTextureCoords[ 0 ][ idx ].x,
+                                          mesh->mTextureCoords[ 0 ][ idx ].y );
+         }
+         else
+         {
+            vertex.TexCoords = glm::vec2( 0.0f, 0.0f );
+         }
       }
-
-      vertices.push_back( vertex );
-   }
+   } );
 
    // Process indices
    for ( unsigned int idx = 0; idx < mesh->mNumFaces; ++idx )
@@ -137,13 +182,18 @@ std::vector<Texture> Model::LoadMaterialTextures( aiMaterial* mat, aiTextureType
 
 void Model::SetupMeshes( glm::mat4* worldMatrices )
 {
-   glGenBuffers( 1, &m_instVBO );
-   glBindBuffer( GL_ARRAY_BUFFER, m_instVBO );
-   glBufferData( GL_ARRAY_BUFFER, m_instAmount * sizeof( glm::mat4 ), worldMatrices, GL_STATIC_DRAW );
+   m_instances.assign( worldMatrices, worldMatrices + m_instAmount );
+   m_meshInstances.resize( m_instAmount );
+   m_instVBOs.resize( m_meshes.size( ) );
+   glGenBuffers( static_cast<GLsizei>( m_instVBOs.size( ) ), m_instVBOs.data( ) );
 
    GLsizei vec4Size = sizeof( glm::vec4 );
    for ( unsigned int idx = 0; idx < m_meshes.size( ); ++idx )
    {
+      glBindBuffer( GL_ARRAY_BUFFER, m_instVBOs[ idx ] );
+      glBufferData( GL_ARRAY_BUFFER, m_instAmount * sizeof( glm::mat4 ), nullptr, GL_DYNAMIC_DRAW );
+      UploadInstances( idx );
+
       unsigned int meshVAO = m_meshes[ idx ].GetVAO( );
       glBindVertexArray( meshVAO );
 
@@ -163,4 +213,16 @@ void Model::SetupMeshes( glm::mat4* worldMatrices )
 
       glBindVertexArray( 0 );
    }
+}
+
+void Model::UploadInstances( unsigned int meshIdx )
+{
+   const glm::mat4& nodeWorld = m_sceneGraph.GetWorldTransform( m_meshNodes[ meshIdx ] );
+   for ( unsigned int idx = 0; idx < m_instAmount; ++idx )
+   {
+      m_meshInstances[ idx ] = m_instances[ idx ] * nodeWorld;
+   }
+
+   glBindBuffer( GL_ARRAY_BUFFER, m_instVBOs[ meshIdx ] );
+   glBufferSubData( GL_ARRAY_BUFFER, 0, m_instAmount * sizeof( glm::mat4 ), m_meshInstances.data( ) );
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <stb_image.h>
 
 #include "Mesh.h"
+#include "ImageLoader.h"
+#include "SceneGraph.h"
 
 static unsigned int TextureFromFile( const std::string& textureName, const std::string& directory )
 {
@@ -12,8 +14,8 @@ static unsigned int TextureFromFile( const std::string& textureName, const std::
    glGenTextures( 1, &texture );
 
    int width, height, nrChannels;
-   //stbi_set_flip_vertically_on_load( true );
-   unsigned char* data = stbi_load( fileName.c_str( ), &width, &height, &nrChannels, 0 );
+   // Not flipped, aiProcess_FlipUVs already flips the texture coordinates
+   unsigned char* data = DecodeImage( fileName, width, height, nrChannels, 0, false );
    if ( data != nullptr )
    {
       GLenum format;
@@ -61,11 +63,15 @@ public:
       SetupMeshes( worldMatrices );
    }
 
-   void Draw( Shader shader );
+   void Draw( const Shader& shader );
+
+   // Node hierarchy of the file, animate by SetLocalTransform( ) and the next Draw( ) picks it up
+   SceneGraph& GetSceneGraph( ) { return m_sceneGraph; }
+   const SceneGraph& GetSceneGraph( ) const { return m_sceneGraph; }
 
 private:
    void LoadModel(const std::string& path);
-   void ProcessNode(aiNode* node, const aiScene* scene);
+   void ProcessNode(aiNode* node, const aiScene* scene, int parentNode);
    Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene);
 
    std::vector<Texture> LoadMaterialTextures(aiMaterial* mat,
@@ -73,12 +79,18 @@ private:
       const std::string& typeName);
 
    void SetupMeshes( glm::mat4* worldMatrices );
+   void UploadInstances( unsigned int meshIdx );
 
 private:
    std::vector<Texture> m_loadedTextures;
    std::vector<Mesh> m_meshes;
    std::string       m_directory;
    unsigned int      m_instAmount;
-   unsigned int      m_instVBO;
+
+   SceneGraph                m_sceneGraph;
+   std::vector<unsigned int> m_meshNodes;   // Scene graph node of each mesh
+   std::vector<glm::mat4>    m_instances;   // Instance world matrices, the node world is applied on top per mesh
+   std::vector<glm::mat4>    m_meshInstances;
+   std::vector<unsigned int> m_instVBOs;    // One per mesh, instance * node world
 
 };
@@ -0,0 +1,518 @@
+#include "PointShadowRenderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+   bool HasExtension( const char* name )
+   {
+      int count = 0;
+      glGetIntegerv( GL_NUM_EXTENSIONS, &count );
+      for ( int idx = 0; idx < count; ++idx )
+      {
+         const char* extension = reinterpret_cast<const char*>( glGetStringi( GL_EXTENSIONS, idx ) );
+         if ( extension != nullptr && std::strcmp( extension, name ) == 0 )
+         {
+            return true;
+         }
+      }
+
+      return false;
+   }
+
+   // AABB corner furthest along 'normal'
+   glm::vec3 PositiveVertex( const ShadowCaster& caster, const glm::vec3& normal )
+   {
+      return glm::vec3( ( normal.x >= 0.0f ) ? caster.BoundsMax.x : caster.BoundsMin.x,
+                        ( normal.y >= 0.0f ) ? caster.BoundsMax.y : caster.BoundsMin.y,
+                        ( normal.z >= 0.0f ) ? caster.BoundsMax.z : caster.BoundsMin.z );
+   }
+
+   // Hemisphere 0 faces down, towards the floor. Bloom.fs / DeferredLighting.fs hardcode this orientation.
+   const glm::vec3 ParaboloidAxis( 0.0f, -1.0f, 0.0f );
+   const glm::vec3 ParaboloidUp( 0.0f, 0.0f, 1.0f );
+
+   constexpr unsigned int LayersPerSlot = 6;
+}
+
+const char* ToString( PointShadowMode mode )
+{
+   switch ( mode )
+   {
+   case PointShadowMode::CubeMap:
+      return "Cube map";
+   case PointShadowMode::DualParaboloid:
+      return "Dual paraboloid";
+   default:
+      break;
+   }
+
+   return "Unknown";
+}
+
+std::string GetShaderDefine( PointShadowMode mode )
+{
+   return "POINT_SHADOW_MODE " + std::to_string( static_cast<int>( mode ) );
+}
+
+PointShadowRenderer::PointShadowRenderer( const PointShadowSettings& settings ) :
+   m_settings( settings ),
+   m_mode( PointShadowMode::CubeMap ),
+   m_layered( IsLayeredInstancingSupported( ) ),
+   m_slots( settings.SlotCount ),
+   m_timedFrame( 0 ),
+   m_msPerCasterFace( 0.01f ),
+   m_staticUpdateCount( 0 ),
+   m_pendingCount( 0 ),
+   m_dynamicCasterFaceCount( 0 )
+{
+   std::fill( m_timedCasterFaces, m_timedCasterFaces + GPUTimer::QueryLatency, 0u );
+
+   std::vector<std::string> defines;
+   if ( m_layered )
+   {
+      defines.push_back( "LAYERED" );
+      if ( !HasExtension( "GL_ARB_shader_viewport_layer_array" ) )
+      {
+         defines.push_back( "AMD_LAYER" );
+      }
+   }
+   m_shaders[ 0 ] = std::make_unique<Shader>( "../Resources/Shaders/PointShadowInstanced.vs", "../Resources/Shaders/PointShadowInstanced.fs", defines );
+   defines.push_back( "PARABOLOID" );
+   m_shaders[ 1 ] = std::make_unique<Shader>( "../Resources/Shaders/PointShadowInstanced.vs", "../Resources/Shaders/PointShadowInstanced.fs", defines );
+
+   glGenTextures( 2, m_textures );
+   glGenFramebuffers( 2, m_layeredFBO );
+   glGenFramebuffers( 2, m_layerFBO );
+   for ( unsigned int idx = 0; idx < 2; ++idx )
+   {
+      glBindTexture( GL_TEXTURE_2D_ARRAY, m_textures[ idx ] );
+      glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, m_settings.Resolution, m_settings.Resolution,
+                    m_settings.SlotCount * LayersPerSlot, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr );
+      glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+      glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+      glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE );
+      glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL );
+
+      glBindFramebuffer( GL_FRAMEBUFFER, m_layeredFBO[ idx ] );
+      glFramebufferTexture( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_textures[ idx ], 0 );
+      glDrawBuffer( GL_NONE );
+      glReadBuffer( GL_NONE );
+
+      glBindFramebuffer( GL_FRAMEBUFFER, m_layerFBO[ idx ] );
+      glDrawBuffer( GL_NONE );
+      glReadBuffer( GL_NONE );
+   }
+   glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+   glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+}
+
+PointShadowRenderer::~PointShadowRenderer( )
+{
+   glDeleteFramebuffers( 2, m_layerFBO );
+   glDeleteFramebuffers( 2, m_layeredFBO );
+   glDeleteTextures( 2, m_textures );
+}
+
+bool PointShadowRenderer::IsLayeredInstancingSupported( )
+{
+   return HasExtension( "GL_ARB_shader_viewport_layer_array" ) || HasExtension( "GL_AMD_vertex_shader_layer" );
+}
+
+void PointShadowRenderer::SetMode( PointShadowMode mode )
+{
+   if ( mode != m_mode )
+   {
+      m_mode = mode;
+      InvalidateStatic( );
+
+      // Layers of the other mode are meaningless, unshadowed until refreshed
+      for ( auto& slot : m_slots )
+      {
+         slot.Cleared = false;
+      }
+   }
+}
+
+void PointShadowRenderer::InvalidateStatic( )
+{
+   for ( auto& slot : m_slots )
+   {
+      slot.StaticValid = false;
+   }
+}
+
+void PointShadowRenderer::AssignLights( LightManager& lights, const std::vector<unsigned int>& shadowedLights )
+{
+   size_t shadowedCount = std::min( shadowedLights.size( ), m_slots.size( ) );
+   auto shadowedEnd = shadowedLights.begin( ) + shadowedCount;
+
+   // Release slots of lights which lost their shadow or no longer exist
+   for ( auto& slot : m_slots )
+   {
+      if ( slot.Light >= 0 && ( static_cast<unsigned int>( slot.Light ) >= lights.GetCount( ) ||
+                                std::find( shadowedLights.begin( ), shadowedEnd, static_cast<unsigned int>( slot.Light ) ) == shadowedEnd ) )
+      {
+         if ( static_cast<unsigned int>( slot.Light ) < lights.GetCount( ) )
+         {
+            lights.SetShadowSlot( slot.Light, -1 );
+         }
+         slot.Light = -1;
+      }
+   }
+
+   for ( auto light = shadowedLights.begin( ); light != shadowedEnd; ++light )
+   {
+      if ( *light >= lights.GetCount( ) )
+      {
+         continue;
+      }
+
+      auto found = std::find_if( m_slots.begin( ), m_slots.end( ), [ light ]( const Slot& slot ) { return slot.Light == static_cast<int>( *light ); } );
+      if ( found == m_slots.end( ) )
+      {
+         found = std::find_if( m_slots.begin( ), m_slots.end( ), [ ]( const Slot& slot ) { return slot.Light < 0; } );
+         found->Light = static_cast<int>( *light );
+         found->StaticValid = false;
+         found->FinalIsStatic = false;
+         found->Cleared = false;
+         found->WaitingFrames = 0;
+      }
+
+      // Light manager may have been rebuilt, cache validity is decided by the light position
+      lights.SetShadowSlot( *light, static_cast<int>( found - m_slots.begin( ) ) );
+   }
+}
+
+void PointShadowRenderer::SetupSlot( Slot& slot, const glm::vec3& position, float farPlane )
+{
+   slot.Position = position;
+   slot.FarPlane = farPlane;
+
+   if ( m_mode == PointShadowMode::DualParaboloid )
+   {
+      slot.FaceMatrices[ 0 ] = glm::lookAt( position, position + ParaboloidAxis, ParaboloidUp );
+      return;
+   }
+
+   const glm::vec3 faceDirections[ 6 ][ 2 ] = {
+      { glm::vec3( 1.0f, 0.0f, 0.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ) },
+      { glm::vec3( -1.0f, 0.0f, 0.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ) },
+      { glm::vec3( 0.0f, 1.0f, 0.0f ), glm::vec3( 0.0f, 0.0f, 1.0f ) },
+      { glm::vec3( 0.0f, -1.0f, 0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ) },
+      { glm::vec3( 0.0f, 0.0f, 1.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ) },
+      { glm::vec3( 0.0f, 0.0f, -1.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ) }
+   };
+   glm::mat4 projection = glm::perspective( glm::radians( 90.0f ), 1.0f, 0.05f, farPlane );
+   for ( unsigned int face = 0; face < 6; ++face )
+   {
+      slot.FaceMatrices[ face ] = projection * glm::lookAt( position, position + faceDirections[ face ][ 0 ], faceDirections[ face ][ 1 ] );
+   }
+}
+
+void PointShadowRenderer::CullCasters( const glm::vec3& position, float farPlane, const std::vector<ShadowCaster>& casters,
+                                       bool dynamic, CasterFaces& result ) const
+{
+   result.Faces.resize( casters.size( ) * 6 );
+   result.Counts.assign( casters.size( ), 0 );
+   result.Total = 0;
+
+   for ( unsigned int casterIdx = 0; casterIdx < casters.size( ); ++casterIdx )
+   {
+      const ShadowCaster& caster = casters[ casterIdx ];
+      if ( caster.Dynamic != dynamic )
+      {
+         continue;
+      }
+
+      // Out of range
+      glm::vec3 closest = glm::clamp( position, caster.BoundsMin, caster.BoundsMax );
+      glm::vec3 delta = closest - position;
+      if ( glm::dot( delta, delta ) > farPlane * farPlane )
+      {
+         continue;
+      }
+
+      unsigned int& count = result.Counts[ casterIdx ];
+      for ( int face = 0; face < static_cast<int>( GetFaceCount( ) ); ++face )
+      {
+         bool visible = true;
+         if ( m_mode == PointShadowMode::CubeMap )
+         {
+            // Face frustum: 4 planes through the light, 45 degrees around the face axis
+            glm::vec3 axis( 0.0f );
+            axis[ face / 2 ] = ( face % 2 == 0 ) ? 1.0f : -1.0f;
+            for ( int side = 0; side < 4 && visible; ++side )
+            {
+               glm::vec3 normal = axis;
+               normal[ ( face / 2 + 1 + side / 2 ) % 3 ] = ( side % 2 == 0 ) ? 1.0f : -1.0f;
+               visible = glm::dot( normal, PositiveVertex( caster, normal ) - position ) >= 0.0f;
+            }
+         }
+         else
+         {
+            glm::vec3 normal = ( face == 0 ) ? ParaboloidAxis : -ParaboloidAxis;
+            visible = glm::dot( normal, PositiveVertex( caster, normal ) - position ) >= 0.0f;
+         }
+
+         if ( visible )
+         {
+            result.Faces[ casterIdx * 6 + count++ ] = face;
+         }
+      }
+
+      result.Total += count;
+   }
+}
+
+FrameGraphResource PointShadowRenderer::AddPass( FrameGraph& frameGraph, const LightManager& lights, const glm::vec3& viewPosition,
+                                                 const std::vector<ShadowCaster>& casters, const DrawCallback& drawCaster )
+{
+   m_staticUpdateCount = 0;
+   m_pendingCount = 0;
+   m_dynamicCasterFaceCount = 0;
+
+   // Static refresh candidates by priority: importance to the viewer, aged by frames already waited
+   m_candidates.clear( );
+   for ( unsigned int slotIdx = 0; slotIdx < m_slots.size( ); ++slotIdx )
+   {
+      Slot& slot = m_slots[ slotIdx ];
+      slot.UpdateStatic = false;
+      if ( slot.Light < 0 )
+      {
+         continue;
+      }
+
+      glm::vec3 position = lights.GetPositions( )[ slot.Light ];
+      float farPlane = lights.GetRadii( )[ slot.Light ];
+      if ( position != slot.Position || farPlane != slot.FarPlane )
+      {
+         slot.StaticValid = false;
+      }
+
+      if ( !slot.StaticValid )
+      {
+         glm::vec3 toView = viewPosition - position;
+         float importance = farPlane * farPlane / std::max( glm::dot( toView, toView ), 1.0f );
+         m_candidates.push_back( std::make_pair( importance * ( 1 + slot.WaitingFrames ), slotIdx ) );
+      }
+   }
+   std::sort( m_candidates.begin( ), m_candidates.end( ), [ ]( const std::pair<float, unsigned int>& lhs, const std::pair<float, unsigned int>& rhs )
+   {
+      return lhs.first > rhs.first;
+   } );
+
+   // Cheaper lights further down the list may still fit, the most important one always runs
+   float estimatedMs = 0.0f;
+   for ( const auto& candidate : m_candidates )
+   {
+      // Slot keeps describing the still cached depth until its refresh is scheduled
+      Slot& slot = m_slots[ candidate.second ];
+      glm::vec3 position = lights.GetPositions( )[ slot.Light ];
+      float farPlane = lights.GetRadii( )[ slot.Light ];
+      CullCasters( position, farPlane, casters, false, slot.StaticFaces );
+
+      float cost = slot.StaticFaces.Total * m_msPerCasterFace;
+      if ( m_staticUpdateCount > 0 && estimatedMs + cost > m_settings.StaticBudgetMs )
+      {
+         ++slot.WaitingFrames;
+         ++m_pendingCount;
+         continue;
+      }
+
+      SetupSlot( slot, position, farPlane );
+      slot.UpdateStatic = true;
+      estimatedMs += cost;
+      ++m_staticUpdateCount;
+   }
+
+   for ( auto& slot : m_slots )
+   {
+      if ( slot.Light >= 0 && ( slot.StaticValid || slot.UpdateStatic ) )
+      {
+         CullCasters( slot.Position, slot.FarPlane, casters, true, slot.DynamicFaces );
+         m_dynamicCasterFaceCount += slot.DynamicFaces.Total;
+      }
+   }
+
+   FrameGraphResource shadowMaps = frameGraph.Import( "Point Shadow Maps", m_textures[ Final ], m_settings.Resolution, m_settings.Resolution );
+
+   frameGraph.AddPass( "Point Shadows",
+                       [ & ]( FrameGraphBuilder& builder )
+   {
+      builder.Write( shadowMaps );
+   },
+                       [ this, &casters, drawCaster ]( const FrameGraphPassContext& )
+   {
+      Execute( casters, drawCaster );
+   } );
+
+   return shadowMaps;
+}
+
+void PointShadowRenderer::Render( unsigned int target, unsigned int slotIndex, const CasterFaces& casterFaces,
+                                  const std::vector<ShadowCaster>& casters, const DrawCallback& drawCaster )
+{
+   const Slot& slot = m_slots[ slotIndex ];
+   unsigned int layerBase = slotIndex * LayersPerSlot;
+
+   Shader& shader = *m_shaders[ static_cast<unsigned int>( m_mode ) ];
+   shader.SetVec3f( "lightPos", slot.Position );
+   shader.SetFloat( "farPlane", slot.FarPlane );
+   shader.SetInt( "layerBase", layerBase );
+   shader.SetMat4fArray( "faceMatrices", slot.FaceMatrices, ( m_mode == PointShadowMode::CubeMap ) ? 6 : 1 );
+
+   if ( m_layered )
+   {
+      // Every caster once, one instance per visible face
+      glBindFramebuffer( GL_FRAMEBUFFER, m_layeredFBO[ target ] );
+      for ( unsigned int casterIdx = 0; casterIdx < casters.size( ); ++casterIdx )
+      {
+         unsigned int faceCount = casterFaces.Counts[ casterIdx ];
+         if ( faceCount > 0 )
+         {
+            shader.SetMat4f( "model", casters[ casterIdx ].Model );
+            shader.SetIntArray( "faceLayers", &casterFaces.Faces[ casterIdx * 6 ], faceCount );
+            drawCaster( casterIdx, faceCount );
+         }
+      }
+      return;
+   }
+
+   // One pass per face, each only draws the casters it sees
+   glBindFramebuffer( GL_FRAMEBUFFER, m_layerFBO[ 0 ] );
+   for ( int face = 0; face < static_cast<int>( GetFaceCount( ) ); ++face )
+   {
+      glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_textures[ target ], 0, layerBase + face );
+      shader.SetIntArray( "faceLayers", &face, 1 );
+      for ( unsigned int casterIdx = 0; casterIdx < casters.size( ); ++casterIdx )
+      {
+         const int* faces = &casterFaces.Faces[ casterIdx * 6 ];
+         const int* facesEnd = faces + casterFaces.Counts[ casterIdx ];
+         if ( std::find( faces, facesEnd, face ) != facesEnd )
+         {
+            shader.SetMat4f( "model", casters[ casterIdx ].Model );
+            drawCaster( casterIdx, 1 );
+         }
+      }
+   }
+}
+
+void PointShadowRenderer::CopyLayers( unsigned int source, unsigned int destination, unsigned int firstLayer, unsigned int layerCount )
+{
+   if ( GLAD_GL_VERSION_4_3 )
+   {
+      glCopyImageSubData( m_textures[ source ], GL_TEXTURE_2D_ARRAY, 0, 0, 0, firstLayer,
+                          m_textures[ destination ], GL_TEXTURE_2D_ARRAY, 0, 0, 0, firstLayer,
+                          m_settings.Resolution, m_settings.Resolution, layerCount );
+      return;
+   }
+
+   glBindFramebuffer( GL_READ_FRAMEBUFFER, m_layerFBO[ 0 ] );
+   glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_layerFBO[ 1 ] );
+   for ( unsigned int layer = firstLayer; layer < firstLayer + layerCount; ++layer )
+   {
+      glFramebufferTextureLayer( GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_textures[ source ], 0, layer );
+      glFramebufferTextureLayer( GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_textures[ destination ], 0, layer );
+      glBlitFramebuffer( 0, 0, m_settings.Resolution, m_settings.Resolution, 0, 0, m_settings.Resolution, m_settings.Resolution,
+                         GL_DEPTH_BUFFER_BIT, GL_NEAREST );
+   }
+   glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+}
+
+void PointShadowRenderer::Execute( const std::vector<ShadowCaster>& casters, const DrawCallback& drawCaster )
+{
+   auto clearLayers = [ this ]( unsigned int target, unsigned int slotIndex )
+   {
+      glBindFramebuffer( GL_FRAMEBUFFER, m_layerFBO[ 0 ] );
+      for ( unsigned int layer = 0; layer < LayersPerSlot; ++layer )
+      {
+         glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_textures[ target ], 0, slotIndex * LayersPerSlot + layer );
+         glClear( GL_DEPTH_BUFFER_BIT );
+      }
+   };
+
+   glViewport( 0, 0, m_settings.Resolution, m_settings.Resolution );
+   m_shaders[ static_cast<unsigned int>( m_mode ) ]->Use( );
+   if ( m_mode == PointShadowMode::DualParaboloid )
+   {
+      glEnable( GL_CLIP_DISTANCE0 );
+   }
+
+   // Static refreshes are timed as a whole, the result of QueryLatency timed frames ago refines the cost estimate
+   if ( m_staticUpdateCount > 0 )
+   {
+      m_staticTimer.Begin( );
+      unsigned int& timedCasterFaces = m_timedCasterFaces[ m_timedFrame % GPUTimer::QueryLatency ];
+      if ( timedCasterFaces > 0 && m_staticTimer.GetElapsedMs( ) > 0.0f )
+      {
+         m_msPerCasterFace += ( m_staticTimer.GetElapsedMs( ) / timedCasterFaces - m_msPerCasterFace ) * 0.2f;
+      }
+
+      timedCasterFaces = 0;
+      for ( unsigned int slotIdx = 0; slotIdx < m_slots.size( ); ++slotIdx )
+      {
+         Slot& slot = m_slots[ slotIdx ];
+         if ( slot.UpdateStatic )
+         {
+            clearLayers( Static, slotIdx );
+            Render( Static, slotIdx, slot.StaticFaces, casters, drawCaster );
+            timedCasterFaces += slot.StaticFaces.Total;
+
+            slot.StaticValid = true;
+            slot.FinalIsStatic = false;
+            slot.UpdateStatic = false;
+            slot.WaitingFrames = 0;
+         }
+      }
+      m_staticTimer.End( );
+      ++m_timedFrame;
+   }
+
+   for ( unsigned int slotIdx = 0; slotIdx < m_slots.size( ); ++slotIdx )
+   {
+      Slot& slot = m_slots[ slotIdx ];
+      if ( slot.Light < 0 )
+      {
+         continue;
+      }
+
+      // Newly assigned: unshadowed until the first static refresh
+      if ( !slot.Cleared )
+      {
+         clearLayers( Final, slotIdx );
+         slot.Cleared = true;
+      }
+
+      // Moved lights keep their stale shadow until refreshed, dynamic casters would not line up with it
+      if ( !slot.StaticValid )
+      {
+         continue;
+      }
+
+      if ( slot.DynamicFaces.Total > 0 )
+      {
+         CopyLayers( Static, Final, slotIdx * LayersPerSlot, GetFaceCount( ) );
+         Render( Final, slotIdx, slot.DynamicFaces, casters, drawCaster );
+         slot.FinalIsStatic = false;
+      }
+      else if ( !slot.FinalIsStatic )
+      {
+         CopyLayers( Static, Final, slotIdx * LayersPerSlot, GetFaceCount( ) );
+         slot.FinalIsStatic = true;
+      }
+   }
+
+   glDisable( GL_CLIP_DISTANCE0 );
+}
+
+void PointShadowRenderer::Bind( const Shader& shader, unsigned int textureUnit ) const
+{
+   glActiveTexture( GL_TEXTURE0 + textureUnit );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, m_textures[ Final ] );
+   shader.SetInt( "pointShadowMaps", textureUnit );
+   glActiveTexture( GL_TEXTURE0 );
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include "Shader.h"
+#include "FrameGraph.h"
+#include "GPUTimer.h"
+#include "LightManager.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class PointShadowMode
+{
+   CubeMap = 0,      // Six 90 degree faces
+   DualParaboloid,   // Two hemispheres, needs reasonably tessellated casters
+   EnumMax
+};
+
+const char* ToString( PointShadowMode mode );
+
+// Permutation define selecting the lookup in the scene shaders( POINT_SHADOW_MODE ).
+std::string GetShaderDefine( PointShadowMode mode );
+
+struct ShadowCaster
+{
+   glm::mat4 Model;
+   glm::vec3 BoundsMin;  // World space AABB, used for per face culling
+   glm::vec3 BoundsMax;
+   bool Dynamic = false; // Redrawn every frame on top of the cached static depth
+};
+
+struct PointShadowSettings
+{
+   unsigned int Resolution = 512;   // Per face
+   unsigned int SlotCount = 8;      // Shadowed lights, 6 layers each
+   float StaticBudgetMs = 0.5f;     // GPU time per frame spent refreshing static caches
+};
+
+// Omnidirectional shadows of several point lights without geometry shader amplification.
+// Every shadowed light owns a slot of 6 layers( cube faces, or 2 paraboloid hemispheres ) in one depth texture
+// array, so a single sampler2DArrayShadow serves every light and the slot travels in the light buffer.
+// Casters are culled against every face on the CPU first. With GL_ARB_shader_viewport_layer_array
+// ( or GL_AMD_vertex_shader_layer ) each caster is then drawn once into the layered target, one instance per face
+// it touches with gl_Layer picked in the vertex shader. Without it every face is its own pass drawing only its casters.
+// Static casters are rendered into a cache which only changes when the light moves or the cache is invalidated,
+// those refreshes are scheduled by priority( importance to the viewer, aged by waiting time ) within a GPU time
+// budget. Dynamic casters are drawn every frame on top of a copy of the cache.
+class PointShadowRenderer
+{
+public:
+   // Draws 'caster' with 'instanceCount' instances, model matrix is already set.
+   using DrawCallback = std::function<void( unsigned int caster, unsigned int instanceCount )>;
+
+public:
+   explicit PointShadowRenderer( const PointShadowSettings& settings = PointShadowSettings( ) );
+   ~PointShadowRenderer( );
+
+   PointShadowRenderer( const PointShadowRenderer& ) = delete;
+   PointShadowRenderer& operator=( const PointShadowRenderer& ) = delete;
+
+   static bool IsLayeredInstancingSupported( );
+
+   void SetMode( PointShadowMode mode );
+   PointShadowMode GetMode( ) const { return m_mode; }
+
+   void SetStaticBudgetMs( float budgetMs ) { m_settings.StaticBudgetMs = budgetMs; }
+   const PointShadowSettings& GetSettings( ) const { return m_settings; }
+
+   // Gives 'shadowedLights' a slot( first SlotCount of them ), lights keeping their slot keep their cache.
+   // Writes the slots into the light manager, call before its Upload( ).
+   void AssignLights( LightManager& lights, const std::vector<unsigned int>& shadowedLights );
+
+   // Static casters changed, every cache is refreshed again( still within the budget ).
+   void InvalidateStatic( );
+
+   // Schedules this frame's static refreshes and adds the depth pass. 'viewPosition' drives the priority.
+   // Returned resource is the imported shadow texture array.
+   FrameGraphResource AddPass( FrameGraph& frameGraph, const LightManager& lights, const glm::vec3& viewPosition,
+                               const std::vector<ShadowCaster>& casters, const DrawCallback& drawCaster );
+
+   // Binds the shadow array to 'textureUnit'. The mode is compiled in( GetShaderDefine ). Shader must be in use.
+   void Bind( const Shader& shader, unsigned int textureUnit ) const;
+
+   // Stats of the last scheduled frame
+   unsigned int GetStaticUpdateCount( ) const { return m_staticUpdateCount; }
+   unsigned int GetPendingCount( ) const { return m_pendingCount; }
+   unsigned int GetDynamicCasterFaceCount( ) const { return m_dynamicCasterFaceCount; }
+   float GetStaticMsPerCasterFace( ) const { return m_msPerCasterFace; }
+
+private:
+   // Visible faces per caster, storage reused every frame
+   struct CasterFaces
+   {
+      std::vector<int> Faces;   // 6 entries per caster, visible faces first
+      std::vector<unsigned int> Counts;
+      unsigned int Total = 0;
+   };
+
+   struct Slot
+   {
+      int Light = -1;
+      glm::vec3 Position;
+      float FarPlane = 0.0f;
+      glm::mat4 FaceMatrices[ 6 ];   // Cube mode: view projection per face, paraboloid: [0] = paraboloid view
+      bool StaticValid = false;
+      bool FinalIsStatic = false;    // Final layers hold the plain static cache( no dynamic casters on top )
+      bool Cleared = false;
+      bool UpdateStatic = false;     // Scheduled for this frame
+      unsigned int WaitingFrames = 0;
+      float Priority = 0.0f;
+      CasterFaces StaticFaces;
+      CasterFaces DynamicFaces;
+   };
+
+   unsigned int GetFaceCount( ) const { return ( m_mode == PointShadowMode::CubeMap ) ? 6 : 2; }
+   void SetupSlot( Slot& slot, const glm::vec3& position, float farPlane );
+   void CullCasters( const glm::vec3& position, float farPlane, const std::vector<ShadowCaster>& casters,
+                     bool dynamic, CasterFaces& result ) const;
+   void Render( unsigned int target, unsigned int slotIndex, const CasterFaces& casterFaces,
+                const std::vector<ShadowCaster>& casters, const DrawCallback& drawCaster );
+   void CopyLayers( unsigned int source, unsigned int destination, unsigned int firstLayer, unsigned int layerCount );
+   void Execute( const std::vector<ShadowCaster>& casters, const DrawCallback& drawCaster );
+
+private:
+   PointShadowSettings m_settings;
+   PointShadowMode m_mode;
+   bool m_layered;
+
+   // Per mode
+   std::unique_ptr<Shader> m_shaders[ 2 ];
+
+   enum ShadowTexture
+   {
+      Static = 0,    // Static casters only, cached
+      Final          // Static + dynamic, sampled when shading
+   };
+   unsigned int m_textures[ 2 ];
+   unsigned int m_layeredFBO[ 2 ];
+   unsigned int m_layerFBO[ 2 ];    // Single layer attachments for the per face fallback and copies
+
+   std::vector<Slot> m_slots;
+   std::vector<std::pair<float, unsigned int>> m_candidates;  // Priority, slot
+
+   // Cost model: GPU time of static refreshes per caster face draw
+   GPUTimer m_staticTimer;
+   unsigned int m_timedCasterFaces[ GPUTimer::QueryLatency ];
+   unsigned int m_timedFrame;
+   float m_msPerCasterFace;
+
+   unsigned int m_staticUpdateCount;
+   unsigned int m_pendingCount;
+   unsigned int m_dynamicCasterFaceCount;
+
+};
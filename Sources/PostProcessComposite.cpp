@@ -0,0 +1,215 @@
+#include "PostProcessComposite.h"
+#include "Primitives.h"
+#include "ImageLoader.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+
+const char* ToString( ToneMapper toneMapper )
+{
+   switch ( toneMapper )
+   {
+   case ToneMapper::Exponential:
+      return "Exponential";
+   case ToneMapper::Reinhard:
+      return "Reinhard";
+   case ToneMapper::ACES:
+      return "ACES";
+   case ToneMapper::Filmic:
+      return "Filmic";
+   default:
+      break;
+   }
+
+   return "Unknown";
+}
+
+PostProcessComposite::PostProcessComposite( ) :
+   m_permutations( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/Composite.fs", [ ]( Shader& shader )
+   {
+      shader.SetInt( "scene", 0 );
+      shader.SetInt( "bloomBlur", 1 );
+      shader.SetInt( "colorGradingLUT", 2 );
+      shader.SetInt( "adaptedLuminance", 3 );
+   } ),
+   m_shader( nullptr ),
+   m_shaderKey( 0 ),
+   m_lut( 0 ),
+   m_lutSize( 0 )
+{
+}
+
+void PostProcessComposite::SetColorGradingLUT( unsigned int lut3D, unsigned int lutSize )
+{
+   m_lut = lut3D;
+   m_lutSize = lutSize;
+}
+
+void PostProcessComposite::Draw( const CompositeSettings& settings, unsigned int sceneTexture, unsigned int bloomTexture,
+                                 unsigned int adaptedLuminance, float exposure )
+{
+   CompositeSettings effective = settings;
+   effective.Bloom = settings.Bloom && bloomTexture != 0;
+   effective.AutoExposure = settings.AutoExposure && adaptedLuminance != 0;
+   effective.ColorGrading = settings.ColorGrading && m_lut != 0;
+
+   Shader& shader = GetPermutation( effective );
+   shader.Use( );
+   shader.SetFloat( "exposure", exposure );
+
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D, sceneTexture );
+
+   if ( effective.Bloom )
+   {
+      shader.SetFloat( "bloomStrength", effective.BloomStrength );
+      glActiveTexture( GL_TEXTURE1 );
+      glBindTexture( GL_TEXTURE_2D, bloomTexture );
+   }
+
+   if ( effective.AutoExposure )
+   {
+      glActiveTexture( GL_TEXTURE3 );
+      glBindTexture( GL_TEXTURE_2D, adaptedLuminance );
+   }
+
+   if ( effective.ColorGrading )
+   {
+      shader.SetFloat( "lutSize", static_cast<float>( m_lutSize ) );
+      glActiveTexture( GL_TEXTURE2 );
+      glBindTexture( GL_TEXTURE_3D, m_lut );
+   }
+
+   glDisable( GL_DEPTH_TEST );
+   renderQuad( );
+   glEnable( GL_DEPTH_TEST );
+   glActiveTexture( GL_TEXTURE0 );
+}
+
+void PostProcessComposite::Prewarm( OutputEncoding encoding )
+{
+   std::vector<ShaderPermutations::Defines> defineSets;
+   for ( unsigned int features = 0; features < 8; ++features )
+   {
+      for ( int toneMap = 0; toneMap < static_cast<int>( ToneMapper::EnumMax ); ++toneMap )
+      {
+         CompositeSettings settings;
+         settings.Bloom = ( features & 1 ) != 0;
+         settings.ColorGrading = ( features & 2 ) != 0;
+         settings.AutoExposure = ( features & 4 ) != 0;
+         settings.ToneMap = static_cast<ToneMapper>( toneMap );
+         settings.Encoding = encoding;
+         defineSets.push_back( GetDefines( settings ) );
+      }
+   }
+
+   m_permutations.Prewarm( defineSets );
+}
+
+Shader& PostProcessComposite::GetPermutation( const CompositeSettings& settings )
+{
+   // Define sets are only built when the settings change
+   unsigned int key = ( settings.Bloom ? 1u : 0u ) | ( settings.ColorGrading ? 2u : 0u ) | ( settings.AutoExposure ? 4u : 0u ) |
+                      ( static_cast<unsigned int>( settings.ToneMap ) << 3 ) | ( static_cast<unsigned int>( settings.Encoding ) << 6 );
+   if ( m_shader == nullptr || key != m_shaderKey )
+   {
+      m_shader = &m_permutations.Get( GetDefines( settings ) );
+      m_shaderKey = key;
+   }
+
+   return *m_shader;
+}
+
+ShaderPermutations::Defines PostProcessComposite::GetDefines( const CompositeSettings& settings )
+{
+   ShaderPermutations::Defines defines;
+   if ( settings.Bloom )
+   {
+      defines.push_back( "BLOOM" );
+   }
+   if ( settings.ColorGrading )
+   {
+      defines.push_back( "COLOR_GRADING" );
+   }
+   if ( settings.AutoExposure )
+   {
+      defines.push_back( "AUTO_EXPOSURE" );
+   }
+   defines.push_back( "TONEMAP " + std::to_string( static_cast<int>( settings.ToneMap ) ) );
+   defines.push_back( "OUTPUT_ENCODING " + std::to_string( static_cast<int>( settings.Encoding ) ) );
+
+   return defines;
+}
+
+unsigned int PostProcessComposite::CreateIdentityLUT( unsigned int size )
+{
+   std::vector<unsigned char> data( size * size * size * 3 );
+   for ( unsigned int b = 0; b < size; ++b )
+   {
+      for ( unsigned int g = 0; g < size; ++g )
+      {
+         for ( unsigned int r = 0; r < size; ++r )
+         {
+            unsigned int texel = ( ( b * size + g ) * size + r ) * 3;
+            data[ texel + 0 ] = static_cast<unsigned char>( r * 255 / ( size - 1 ) );
+            data[ texel + 1 ] = static_cast<unsigned char>( g * 255 / ( size - 1 ) );
+            data[ texel + 2 ] = static_cast<unsigned char>( b * 255 / ( size - 1 ) );
+         }
+      }
+   }
+
+   unsigned int lut;
+   glGenTextures( 1, &lut );
+   glBindTexture( GL_TEXTURE_3D, lut );
+   glTexImage3D( GL_TEXTURE_3D, 0, GL_RGB8, size, size, size, 0, GL_RGB, GL_UNSIGNED_BYTE, data.data( ) );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
+   glBindTexture( GL_TEXTURE_3D, 0 );
+
+   return lut;
+}
+
+unsigned int PostProcessComposite::LoadLUT( const std::string& path, unsigned int& outSize )
+{
+   int width, height, channels;
+   unsigned char* data = DecodeImage( path, width, height, channels, 3, false );
+   if ( data == nullptr || width != height * height )
+   {
+      std::cout << "Failed to load color grading LUT : " << path << std::endl;
+      stbi_image_free( data );
+      outSize = 0;
+      return 0;
+   }
+
+   // Strip rows are already r-major inside each blue slice, only slices need to be gathered
+   unsigned int size = static_cast<unsigned int>( height );
+   std::vector<unsigned char> volume( size * size * size * 3 );
+   for ( unsigned int b = 0; b < size; ++b )
+   {
+      for ( unsigned int g = 0; g < size; ++g )
+      {
+         const unsigned char* src = data + ( g * width + b * size ) * 3;
+         unsigned char* dst = volume.data( ) + ( ( b * size + g ) * size ) * 3;
+         std::copy( src, src + size * 3, dst );
+      }
+   }
+   stbi_image_free( data );
+
+   unsigned int lut;
+   glGenTextures( 1, &lut );
+   glBindTexture( GL_TEXTURE_3D, lut );
+   glTexImage3D( GL_TEXTURE_3D, 0, GL_RGB8, size, size, size, 0, GL_RGB, GL_UNSIGNED_BYTE, volume.data( ) );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
+   glBindTexture( GL_TEXTURE_3D, 0 );
+
+   outSize = size;
+   return lut;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "ShaderPermutations.h"
+
+enum class ToneMapper
+{
+   Exponential = 0,
+   Reinhard,
+   ACES,
+   Filmic,
+   EnumMax
+};
+
+enum class OutputEncoding
+{
+   Linear = 0, // Target is a GL_SRGB8 framebuffer, hardware encodes on write
+   Gamma22,
+   SRGB,
+   EnumMax
+};
+
+const char* ToString( ToneMapper toneMapper );
+
+struct CompositeSettings
+{
+   bool           Bloom = true;
+   bool           AutoExposure = false;
+   float          BloomStrength = 1.0f;
+   ToneMapper     ToneMap = ToneMapper::Exponential;
+   bool           ColorGrading = false;
+   OutputEncoding Encoding = OutputEncoding::Gamma22;
+};
+
+// Single full screen pass: bloom add, exposure( manual or adapted luminance ), tonemap, color grading LUT and output encoding.
+// Each settings combination is its own shader permutation so disabled inputs are never sampled.
+class PostProcessComposite
+{
+public:
+   PostProcessComposite( );
+
+   void SetColorGradingLUT( unsigned int lut3D, unsigned int lutSize );
+
+   // Renders into currently bound framebuffer.
+   // With auto exposure 'exposure' scales the key value derived from 'adaptedLuminance'( 1x1 R32F ).
+   void Draw( const CompositeSettings& settings, unsigned int sceneTexture, unsigned int bloomTexture,
+              unsigned int adaptedLuminance, float exposure );
+
+   // Submits every feature / tonemap combination runtime toggles can reach for 'encoding', see ShaderPermutations.
+   void Prewarm( OutputEncoding encoding );
+   void FinishPrewarm( ) { m_permutations.FinishPrewarm( ); }
+
+   // size^3 RGB8 3D texture which maps every color onto itself.
+   static unsigned int CreateIdentityLUT( unsigned int size );
+
+   // Loads the common unwrapped 2D strip layout( size*size x size, blue slices laid out horizontally ).
+   static unsigned int LoadLUT( const std::string& path, unsigned int& outSize );
+
+private:
+   Shader& GetPermutation( const CompositeSettings& settings );
+   static ShaderPermutations::Defines GetDefines( const CompositeSettings& settings );
+
+private:
+   ShaderPermutations m_permutations;
+   Shader* m_shader;           // Permutation of the last settings
+   unsigned int m_shaderKey;   // Settings packed into bits
+   unsigned int m_lut;
+   unsigned int m_lutSize;
+
+};
\ No newline at end of file
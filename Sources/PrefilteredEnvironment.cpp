@@ -0,0 +1,241 @@
+#include "PrefilteredEnvironment.h"
+#include "AssetCache.h"
+#include "Primitives.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+   bool HasExtension( const char* name )
+   {
+      int count = 0;
+      glGetIntegerv( GL_NUM_EXTENSIONS, &count );
+      for ( int idx = 0; idx < count; ++idx )
+      {
+         const char* extension = reinterpret_cast<const char*>( glGetStringi( GL_EXTENSIONS, idx ) );
+         if ( extension != nullptr && std::strcmp( extension, name ) == 0 )
+         {
+            return true;
+         }
+      }
+
+      return false;
+   }
+}
+
+PrefilteredEnvironment::PrefilteredEnvironment( const PrefilterSettings& settings ) :
+   m_settings( settings ),
+   m_cubeMap( 0 ),
+   m_brdfLut( 0 )
+{
+}
+
+PrefilteredEnvironment::~PrefilteredEnvironment( )
+{
+   glDeleteTextures( 1, &m_cubeMap );
+   glDeleteTextures( 1, &m_brdfLut );
+}
+
+void PrefilteredEnvironment::CreateTextures( )
+{
+   glDeleteTextures( 1, &m_cubeMap );
+   glGenTextures( 1, &m_cubeMap );
+   glBindTexture( GL_TEXTURE_CUBE_MAP, m_cubeMap );
+   for ( unsigned int mip = 0; mip < m_settings.MipCount; ++mip )
+   {
+      unsigned int size = std::max( m_settings.Resolution >> mip, 1u );
+      for ( unsigned int face = 0; face < 6; ++face )
+      {
+         glTexImage2D( GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip, GL_RGB16F, size, size, 0, GL_RGB, GL_HALF_FLOAT, nullptr );
+      }
+   }
+   glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BASE_LEVEL, 0 );
+   glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, m_settings.MipCount - 1 );
+   glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+   glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
+   // Rough mips are only a few texels wide, filtering across faces hides their seams.
+   // Set on this texture only, the global GL_TEXTURE_CUBE_MAP_SEAMLESS switch is left to the application.
+   if ( HasExtension( "GL_ARB_seamless_cubemap_per_texture" ) )
+   {
+      glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_CUBE_MAP_SEAMLESS, GL_TRUE );
+   }
+   glBindTexture( GL_TEXTURE_CUBE_MAP, 0 );
+
+   glDeleteTextures( 1, &m_brdfLut );
+   glGenTextures( 1, &m_brdfLut );
+   glBindTexture( GL_TEXTURE_2D, m_brdfLut );
+   glTexImage2D( GL_TEXTURE_2D, 0, GL_RG16F, m_settings.LutResolution, m_settings.LutResolution, 0, GL_RG, GL_HALF_FLOAT, nullptr );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+bool PrefilteredEnvironment::Load( const std::string& cookedPath, const std::vector<std::string>& sources )
+{
+   if ( !IsCacheFresh( cookedPath, sources ) )
+   {
+      return false;
+   }
+
+   std::ifstream file( cookedPath, std::ios::binary );
+   CookedHeader header;
+   file.read( reinterpret_cast<char*>( &header ), sizeof( header ) );
+   if ( !file || std::memcmp( header.Magic, "ENVP", 4 ) != 0 || header.Version != CookedVersion ||
+        header.Resolution != m_settings.Resolution || header.MipCount != m_settings.MipCount ||
+        header.LutResolution != m_settings.LutResolution )
+   {
+      return false;
+   }
+
+   // Read everything first, a truncated file leaves the previous textures untouched
+   std::vector<std::vector<unsigned short>> faces;
+   for ( unsigned int mip = 0; mip < m_settings.MipCount; ++mip )
+   {
+      unsigned int size = std::max( m_settings.Resolution >> mip, 1u );
+      for ( unsigned int face = 0; face < 6; ++face )
+      {
+         faces.emplace_back( size * size * 3 );
+         file.read( reinterpret_cast<char*>( faces.back( ).data( ) ), faces.back( ).size( ) * sizeof( unsigned short ) );
+      }
+   }
+   std::vector<unsigned short> lut( m_settings.LutResolution * m_settings.LutResolution * 2 );
+   file.read( reinterpret_cast<char*>( lut.data( ) ), lut.size( ) * sizeof( unsigned short ) );
+   if ( !file )
+   {
+      std::cout << "Cooked environment truncated : " << cookedPath << std::endl;
+      return false;
+   }
+
+   CreateTextures( );
+   glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+   glBindTexture( GL_TEXTURE_CUBE_MAP, m_cubeMap );
+   for ( unsigned int mip = 0; mip < m_settings.MipCount; ++mip )
+   {
+      unsigned int size = std::max( m_settings.Resolution >> mip, 1u );
+      for ( unsigned int face = 0; face < 6; ++face )
+      {
+         glTexSubImage2D( GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip, 0, 0, size, size, GL_RGB, GL_HALF_FLOAT,
+                          faces[ mip * 6 + face ].data( ) );
+      }
+   }
+   glBindTexture( GL_TEXTURE_2D, m_brdfLut );
+   glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, m_settings.LutResolution, m_settings.LutResolution, GL_RG, GL_HALF_FLOAT, lut.data( ) );
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   glBindTexture( GL_TEXTURE_CUBE_MAP, 0 );
+   glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+   return true;
+}
+
+void PrefilteredEnvironment::Prefilter( unsigned int environmentMap )
+{
+   CreateTextures( );
+
+   int sourceResolution = 0;
+   glBindTexture( GL_TEXTURE_CUBE_MAP, environmentMap );
+   glGetTexLevelParameteriv( GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, GL_TEXTURE_WIDTH, &sourceResolution );
+
+   Shader prefilterShader( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/PrefilterGGX.fs" );
+   Shader brdfShader( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/BRDFIntegration.fs" );
+
+   unsigned int framebuffer;
+   glGenFramebuffers( 1, &framebuffer );
+   glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
+   glDisable( GL_DEPTH_TEST );
+   // Source lookups cross faces at every lod, previous state is restored below
+   GLboolean seamless = glIsEnabled( GL_TEXTURE_CUBE_MAP_SEAMLESS );
+   glEnable( GL_TEXTURE_CUBE_MAP_SEAMLESS );
+
+   prefilterShader.Use( );
+   prefilterShader.SetInt( "environmentMap", 0 );
+   prefilterShader.SetFloat( "sourceResolution", static_cast<float>( sourceResolution ) );
+   prefilterShader.SetInt( "sampleCount", m_settings.SampleCount );
+   glActiveTexture( GL_TEXTURE0 );
+   for ( unsigned int mip = 0; mip < m_settings.MipCount; ++mip )
+   {
+      unsigned int size = std::max( m_settings.Resolution >> mip, 1u );
+      float roughness = ( m_settings.MipCount > 1 ) ? static_cast<float>( mip ) / ( m_settings.MipCount - 1 ) : 0.0f;
+      prefilterShader.SetFloat( "roughness", roughness );
+      prefilterShader.SetFloat( "faceResolution", static_cast<float>( size ) );
+      glViewport( 0, 0, size, size );
+      for ( unsigned int face = 0; face < 6; ++face )
+      {
+         glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, m_cubeMap, mip );
+         prefilterShader.SetInt( "face", face );
+         renderQuad( );
+      }
+   }
+
+   glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_brdfLut, 0 );
+   glViewport( 0, 0, m_settings.LutResolution, m_settings.LutResolution );
+   brdfShader.Use( );
+   brdfShader.SetInt( "sampleCount", m_settings.SampleCount );
+   renderQuad( );
+
+   if ( seamless == GL_FALSE )
+   {
+      glDisable( GL_TEXTURE_CUBE_MAP_SEAMLESS );
+   }
+   glEnable( GL_DEPTH_TEST );
+   glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+   glDeleteFramebuffers( 1, &framebuffer );
+   glBindTexture( GL_TEXTURE_CUBE_MAP, 0 );
+}
+
+bool PrefilteredEnvironment::Save( const std::string& cookedPath ) const
+{
+   std::ofstream file( cookedPath, std::ios::binary );
+   if ( !file )
+   {
+      std::cout << "Failed to write cooked environment : " << cookedPath << std::endl;
+      return false;
+   }
+
+   CookedHeader header = { { 'E', 'N', 'V', 'P' }, CookedVersion, m_settings.Resolution, m_settings.MipCount, m_settings.LutResolution };
+   file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+   glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+   std::vector<unsigned short> pixels;
+   glBindTexture( GL_TEXTURE_CUBE_MAP, m_cubeMap );
+   for ( unsigned int mip = 0; mip < m_settings.MipCount; ++mip )
+   {
+      unsigned int size = std::max( m_settings.Resolution >> mip, 1u );
+      pixels.resize( size * size * 3 );
+      for ( unsigned int face = 0; face < 6; ++face )
+      {
+         glGetTexImage( GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip, GL_RGB, GL_HALF_FLOAT, pixels.data( ) );
+         file.write( reinterpret_cast<const char*>( pixels.data( ) ), pixels.size( ) * sizeof( unsigned short ) );
+      }
+   }
+   glBindTexture( GL_TEXTURE_CUBE_MAP, 0 );
+
+   pixels.resize( m_settings.LutResolution * m_settings.LutResolution * 2 );
+   glBindTexture( GL_TEXTURE_2D, m_brdfLut );
+   glGetTexImage( GL_TEXTURE_2D, 0, GL_RG, GL_HALF_FLOAT, pixels.data( ) );
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   file.write( reinterpret_cast<const char*>( pixels.data( ) ), pixels.size( ) * sizeof( unsigned short ) );
+   glPixelStorei( GL_PACK_ALIGNMENT, 4 );
+
+   return static_cast<bool>( file );
+}
+
+void PrefilteredEnvironment::Bind( const Shader& shader, unsigned int textureUnit, float intensity ) const
+{
+   glActiveTexture( GL_TEXTURE0 + textureUnit );
+   glBindTexture( GL_TEXTURE_CUBE_MAP, m_cubeMap );
+   shader.SetInt( "prefilteredMap", textureUnit );
+   glActiveTexture( GL_TEXTURE0 + textureUnit + 1 );
+   glBindTexture( GL_TEXTURE_2D, m_brdfLut );
+   shader.SetInt( "brdfLut", textureUnit + 1 );
+   glActiveTexture( GL_TEXTURE0 );
+
+   shader.SetFloat( "prefilterMaxLod", static_cast<float>( m_settings.MipCount - 1 ) );
+   shader.SetFloat( "environmentIntensity", intensity );
+}
\ No newline at end of file
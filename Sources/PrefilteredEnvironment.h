@@ -0,0 +1,60 @@
+#pragma once
+#include "Shader.h"
+
+#include <string>
+#include <vector>
+
+struct PrefilterSettings
+{
+   unsigned int Resolution = 128;      // Face size of mip 0( roughness 0 )
+   unsigned int MipCount = 6;          // Roughness of mip N = N / ( MipCount - 1 )
+   unsigned int SampleCount = 512;     // GGX samples per texel, also used for the BRDF LUT
+   unsigned int LutResolution = 128;
+};
+
+// Split sum specular environment lighting. First sum: radiance prefiltered with GGX into the mip chain of a cube map,
+// one roughness per mip. Second sum: BRDF integration LUT( scale, bias to F0 ) over NdotV x roughness.
+// Both are rendered once on the GPU and cooked into one file, later runs only upload it.
+// Shading is one trilinear cube lookup plus one LUT lookup( Bloom.fs / DeferredLighting.fs AmbientSpecular ).
+class PrefilteredEnvironment
+{
+public:
+   explicit PrefilteredEnvironment( const PrefilterSettings& settings = PrefilterSettings( ) );
+   ~PrefilteredEnvironment( );
+
+   PrefilteredEnvironment( const PrefilteredEnvironment& ) = delete;
+   PrefilteredEnvironment& operator=( const PrefilteredEnvironment& ) = delete;
+
+   // Uploads the cooked file when it is newer than every source and matches the settings.
+   bool Load( const std::string& cookedPath, const std::vector<std::string>& sources );
+
+   // Prefilters a source cube map, which is only read. It must have linear radiance( sRGB internal format for
+   // LDR faces ) and a full mip chain with mipmap filtering, filtered importance sampling reads its mips.
+   void Prefilter( unsigned int environmentMap );
+
+   bool Save( const std::string& cookedPath ) const;
+
+   // Binds the prefiltered map to 'textureUnit', the BRDF LUT to 'textureUnit' + 1, radiance scaled by 'intensity'.
+   // Shader must be in use.
+   void Bind( const Shader& shader, unsigned int textureUnit, float intensity ) const;
+
+private:
+   struct CookedHeader
+   {
+      char Magic[ 4 ];
+      unsigned int Version;
+      unsigned int Resolution;
+      unsigned int MipCount;
+      unsigned int LutResolution;
+   };
+
+   void CreateTextures( );
+
+private:
+   static constexpr unsigned int CookedVersion = 1;
+
+   PrefilterSettings m_settings;
+   unsigned int m_cubeMap;  // RGB16F
+   unsigned int m_brdfLut;  // RG16F
+
+};
\ No newline at end of file
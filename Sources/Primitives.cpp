@@ -0,0 +1,118 @@
+#include "Primitives.h"
+
+#include "glad/glad.h"
+
+unsigned int quadVAO = 0;
+unsigned int quadVBO;
+void renderQuad( )
+{
+   if ( quadVAO == 0 )
+   {
+      float quadVertices[ ] = {
+         // positions        // texture Coords
+         -1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
+         -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+         1.0f,  1.0f, 0.0f, 1.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+      };
+      // setup plane VAO
+      glGenVertexArrays( 1, &quadVAO );
+      glGenBuffers( 1, &quadVBO );
+      glBindVertexArray( quadVAO );
+      glBindBuffer( GL_ARRAY_BUFFER, quadVBO );
+      glBufferData( GL_ARRAY_BUFFER, sizeof( quadVertices ), &quadVertices, GL_STATIC_DRAW );
+      glEnableVertexAttribArray( 0 );
+      glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof( float ), ( void* ) 0 );
+      glEnableVertexAttribArray( 1 );
+      glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof( float ), ( void* ) ( 3 * sizeof( float ) ) );
+   }
+   glBindVertexArray( quadVAO );
+   glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+   glBindVertexArray( 0 );
+}
+
+unsigned int cubeVAO = 0;
+unsigned int cubeVBO = 0;
+static void setupCube( )
+{
+   // initialize (if necessary)
+   if ( cubeVAO == 0 )
+   {
+      float vertices[ ] = {
+         // back face
+         -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 0.0f, // bottom-left
+         1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 1.0f, // top-right
+         1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 0.0f, // bottom-right         
+         1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 1.0f, // top-right
+         -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 0.0f, // bottom-left
+         -1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 1.0f, // top-left
+                                                               // front face
+                                                               -1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f, 0.0f, // bottom-left
+                                                               1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, 0.0f, // bottom-right
+                                                               1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, 1.0f, // top-right
+                                                               1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, 1.0f, // top-right
+                                                               -1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f, 1.0f, // top-left
+                                                               -1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f, 0.0f, // bottom-left
+                                                                                                                     // left face
+                                                                                                                     -1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-right
+                                                                                                                     -1.0f,  1.0f, -1.0f, -1.0f,  0.0f,  0.0f, 1.0f, 1.0f, // top-left
+                                                                                                                     -1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-left
+                                                                                                                     -1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-left
+                                                                                                                     -1.0f, -1.0f,  1.0f, -1.0f,  0.0f,  0.0f, 0.0f, 0.0f, // bottom-right
+                                                                                                                     -1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-right
+                                                                                                                                                                           // right face
+                                                                                                                                                                           1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-left
+                                                                                                                                                                           1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-right
+                                                                                                                                                                           1.0f,  1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 1.0f, 1.0f, // top-right         
+                                                                                                                                                                           1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-right
+                                                                                                                                                                           1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-left
+                                                                                                                                                                           1.0f, -1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 0.0f, 0.0f, // bottom-left     
+                                                                                                                                                                                                                                // bottom face
+                                                                                                                                                                                                                                -1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 0.0f, 1.0f, // top-right
+                                                                                                                                                                                                                                1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 1.0f, 1.0f, // top-left
+                                                                                                                                                                                                                                1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 1.0f, 0.0f, // bottom-left
+                                                                                                                                                                                                                                1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 1.0f, 0.0f, // bottom-left
+                                                                                                                                                                                                                                -1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 0.0f, 0.0f, // bottom-right
+                                                                                                                                                                                                                                -1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 0.0f, 1.0f, // top-right
+                                                                                                                                                                                                                                                                                      // top face
+                                                                                                                                                                                                                                                                                      -1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 1.0f, // top-left
+                                                                                                                                                                                                                                                                                      1.0f,  1.0f , 1.0f,  0.0f,  1.0f,  0.0f, 1.0f, 0.0f, // bottom-right
+                                                                                                                                                                                                                                                                                      1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 1.0f, 1.0f, // top-right     
+                                                                                                                                                                                                                                                                                      1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f, 1.0f, 0.0f, // bottom-right
+                                                                                                                                                                                                                                                                                      -1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 1.0f, // top-left
+                                                                                                                                                                                                                                                                                      -1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 0.0f  // bottom-left        
+      };
+      glGenVertexArrays( 1, &cubeVAO );
+      glGenBuffers( 1, &cubeVBO );
+      // fill buffer
+      glBindBuffer( GL_ARRAY_BUFFER, cubeVBO );
+      glBufferData( GL_ARRAY_BUFFER, sizeof( vertices ), vertices, GL_STATIC_DRAW );
+      // link vertex attributes
+      glBindVertexArray( cubeVAO );
+      glEnableVertexAttribArray( 0 );
+      glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof( float ), ( void* ) 0 );
+      glEnableVertexAttribArray( 1 );
+      glVertexAttribPointer( 1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof( float ), ( void* ) ( 3 * sizeof( float ) ) );
+      glEnableVertexAttribArray( 2 );
+      glVertexAttribPointer( 2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof( float ), ( void* ) ( 6 * sizeof( float ) ) );
+      glBindBuffer( GL_ARRAY_BUFFER, 0 );
+      glBindVertexArray( 0 );
+   }
+}
+
+void renderCube( )
+{
+   setupCube( );
+   // render Cube
+   glBindVertexArray( cubeVAO );
+   glDrawArrays( GL_TRIANGLES, 0, 36 );
+   glBindVertexArray( 0 );
+}
+
+void renderCubeInstanced( unsigned int instanceCount )
+{
+   setupCube( );
+   glBindVertexArray( cubeVAO );
+   glDrawArraysInstanced( GL_TRIANGLES, 0, 36, instanceCount );
+   glBindVertexArray( 0 );
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+// Full screen quad in NDC( position, texCoords ).
+void renderQuad( );
+
+// renderCube() renders a 1x1 3D cube in NDC( position, normal, texCoords ).
+void renderCube( );
+
+// Same cube, 'instanceCount' instances in one draw call( per instance data is up to the shader, gl_InstanceID ).
+void renderCubeInstanced( unsigned int instanceCount );
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "RenderQueue.h"
+#include "BatchMath.h"
+
+#include <algorithm>
+
+namespace
+{
+   const ComponentMask RequiredComponents = TransformComponent | BoundsComponent | RenderableComponent;
+
+   uint64_t MakeSortKey( bool dynamic, uint32_t material, uint32_t mesh )
+   {
+      // Material changes( texture binds ) cost more than mesh changes, dynamic batches last so static only passes stop early
+      return ( static_cast<uint64_t>( dynamic ) << 63 ) |
+             ( static_cast<uint64_t>( material & 0x7fffffff ) << 32 ) |
+             static_cast<uint64_t>( mesh );
+   }
+
+   // Rows whose box is not completely behind any plane, box tested at its corner furthest along the plane normal
+   uint32_t CullBoxes( const glm::vec4* planes, const EntityChunk& chunk, uint32_t* visible )
+   {
+      uint32_t visibleCount = 0;
+      for ( uint32_t row = 0; row < chunk.Count; ++row )
+      {
+         bool inside = true;
+         for ( int planeIdx = 0; planeIdx < 6 && inside; ++planeIdx )
+         {
+            const glm::vec4& plane = planes[ planeIdx ];
+            float x = ( plane.x >= 0.0f ) ? chunk.WorldMaxX[ row ] : chunk.WorldMinX[ row ];
+            float y = ( plane.y >= 0.0f ) ? chunk.WorldMaxY[ row ] : chunk.WorldMinY[ row ];
+            float z = ( plane.z >= 0.0f ) ? chunk.WorldMaxZ[ row ] : chunk.WorldMinZ[ row ];
+            inside = ( plane.x * x + plane.y * y + plane.z * z + plane.w ) >= 0.0f;
+         }
+
+         visible[ visibleCount ] = row;
+         visibleCount += inside ? 1 : 0;
+      }
+
+      return visibleCount;
+   }
+}
+
+RenderQueue::RenderQueue( ) :
+   m_culledCount( 0 )
+{
+   m_visibleRows.resize( EntityChunk::Capacity );
+}
+
+void RenderQueue::Build( const EntityStore& entities, const glm::vec4* planes, ComponentMask excluded )
+{
+   m_items.clear( );
+   m_batches.clear( );
+   m_transforms.clear( );
+   m_clipTransforms.clear( );
+   m_instanceData.clear( );
+   m_culledCount = 0;
+
+   entities.ForEachChunk( RequiredComponents, excluded, [ & ]( const EntityChunk& chunk )
+   {
+      uint32_t visibleCount = chunk.Count;
+      if ( planes != nullptr )
+      {
+         visibleCount = CullBoxes( planes, chunk, m_visibleRows.data( ) );
+      }
+      else
+      {
+         for ( uint32_t row = 0; row < chunk.Count; ++row )
+         {
+            m_visibleRows[ row ] = row;
+         }
+      }
+      m_culledCount += chunk.Count - visibleCount;
+
+      bool dynamic = chunk.Has( DynamicComponent );
+      for ( uint32_t idx = 0; idx < visibleCount; ++idx )
+      {
+         uint32_t row = m_visibleRows[ idx ];
+         m_items.push_back( DrawItem{ MakeSortKey( dynamic, chunk.Materials[ row ], chunk.Meshes[ row ] ), &chunk, row } );
+      }
+   } );
+
+   // Stable so equal keys keep chunk order, which keeps the instance array deterministic frame to frame
+   std::stable_sort( m_items.begin( ), m_items.end( ), [ ]( const DrawItem& lhs, const DrawItem& rhs )
+   {
+      return lhs.Key < rhs.Key;
+   } );
+
+   m_transforms.reserve( m_items.size( ) );
+   m_instanceData.reserve( m_items.size( ) );
+   for ( const auto& item : m_items )
+   {
+      const EntityChunk& chunk = *item.Chunk;
+      if ( m_batches.empty( ) || MakeSortKey( m_batches.back( ).Dynamic, m_batches.back( ).Material, m_batches.back( ).Mesh ) != item.Key )
+      {
+         uint32_t first = static_cast<uint32_t>( m_transforms.size( ) );
+         m_batches.push_back( Batch{ chunk.Meshes[ item.Row ], chunk.Materials[ item.Row ], chunk.Has( DynamicComponent ), first, 0 } );
+      }
+
+      m_transforms.push_back( chunk.Transforms[ item.Row ] );
+      m_instanceData.push_back( chunk.Has( InstanceComponent ) ? chunk.Instances[ item.Row ] : glm::vec4( 0.0f ) );
+      ++m_batches.back( ).InstanceCount;
+   }
+
+   m_normalMatrices.resize( m_transforms.size( ) );
+   BuildNormalMatrices( m_transforms.data( ), m_normalMatrices.data( ), m_transforms.size( ) );
+}
+
+void RenderQueue::BuildClipTransforms( const glm::mat4& viewProjection )
+{
+   m_clipTransforms.resize( m_transforms.size( ) );
+   MultiplyMatrices( viewProjection, m_transforms.data( ), m_clipTransforms.data( ), m_transforms.size( ) );
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include "EntityStore.h"
+
+#include <cstdint>
+#include <vector>
+
+// Draw list built from an EntityStore in three streaming passes:
+//  1) Cull   : walks the SoA world bounds of every renderable chunk, keeps rows inside the frustum
+//  2) Sort   : orders survivors by a 64 bit key( static before dynamic, then material, then mesh )
+//  3) Fill   : copies world matrices / instance data into one contiguous array in sorted order, normal matrices in one batch
+// Batches are runs of equal mesh and material over that array, ready for instanced draws or for per draw uniforms.
+class RenderQueue
+{
+public:
+   struct Batch
+   {
+      uint32_t Mesh;
+      uint32_t Material;
+      bool Dynamic;
+      uint32_t FirstInstance;
+      uint32_t InstanceCount;
+   };
+
+public:
+   RenderQueue( );
+
+   // 'planes' as from ExtractFrustumPlanes, nullptr draws everything( ex. shadow passes culled elsewhere ).
+   // Entities with any component of 'excluded' are skipped. Bounds must be up to date( EntityStore::UpdateBounds ).
+   void Build( const EntityStore& entities, const glm::vec4* planes, ComponentMask excluded = 0 );
+   // viewProjection * model of every instance of the last build, queues drawn from other views skip it.
+   void BuildClipTransforms( const glm::mat4& viewProjection );
+
+   const std::vector<Batch>& GetBatches( ) const { return m_batches; }
+   const std::vector<glm::mat4>& GetInstanceTransforms( ) const { return m_transforms; }
+   const std::vector<glm::mat4>& GetInstanceNormalMatrices( ) const { return m_normalMatrices; }
+   // Empty unless BuildClipTransforms was called since the last build
+   const std::vector<glm::mat4>& GetInstanceClipTransforms( ) const { return m_clipTransforms; }
+   const std::vector<glm::vec4>& GetInstanceData( ) const { return m_instanceData; }
+
+   // Stats of the last build
+   uint32_t GetVisibleCount( ) const { return static_cast<uint32_t>( m_transforms.size( ) ); }
+   uint32_t GetCulledCount( ) const { return m_culledCount; }
+
+private:
+   struct DrawItem
+   {
+      uint64_t Key;
+      const EntityChunk* Chunk;
+      uint32_t Row;
+   };
+
+private:
+   std::vector<DrawItem> m_items;
+   std::vector<uint32_t> m_visibleRows;
+   std::vector<Batch> m_batches;
+   std::vector<glm::mat4> m_transforms;
+   std::vector<glm::mat4> m_normalMatrices;
+   std::vector<glm::mat4> m_clipTransforms;
+   std::vector<glm::vec4> m_instanceData;
+   uint32_t m_culledCount;
+
+};
\ No newline at end of file
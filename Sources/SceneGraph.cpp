@@ -0,0 +1,143 @@
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace
+{
+   void SetEmptyBounds( BoundsArray& bounds, unsigned int node )
+   {
+      bounds.MinX[ node ] = bounds.MinY[ node ] = bounds.MinZ[ node ] = FLT_MAX;
+      bounds.MaxX[ node ] = bounds.MaxY[ node ] = bounds.MaxZ[ node ] = -FLT_MAX;
+   }
+}
+
+SceneGraph::SceneGraph( ) :
+   m_firstDirty( 0 )
+{
+}
+
+unsigned int SceneGraph::AddNode( int parent, const glm::mat4& local, const std::string& name )
+{
+   unsigned int node = GetCount( );
+   m_parents.push_back( parent );
+   m_names.push_back( name );
+   m_local.push_back( local );
+   m_world.push_back( local );
+   m_localBoundsMin.push_back( glm::vec3( FLT_MAX ) );
+   m_localBoundsMax.push_back( glm::vec3( -FLT_MAX ) );
+   m_worldBounds.Resize( node + 1 );
+   SetEmptyBounds( m_worldBounds, node );
+   m_dirty.push_back( 0 );
+
+   MarkDirty( node );
+   return node;
+}
+
+void SceneGraph::Clear( )
+{
+   m_parents.clear( );
+   m_names.clear( );
+   m_local.clear( );
+   m_world.clear( );
+   m_localBoundsMin.clear( );
+   m_localBoundsMax.clear( );
+   m_worldBounds.Resize( 0 );
+   m_dirty.clear( );
+   m_updated.clear( );
+   m_firstDirty = 0;
+}
+
+void SceneGraph::SetLocalTransform( unsigned int node, const glm::mat4& local )
+{
+   m_local[ node ] = local;
+   MarkDirty( node );
+}
+
+void SceneGraph::SetLocalBounds( unsigned int node, const glm::vec3& boundsMin, const glm::vec3& boundsMax )
+{
+   m_localBoundsMin[ node ] = boundsMin;
+   m_localBoundsMax[ node ] = boundsMax;
+   MarkDirty( node );
+}
+
+void SceneGraph::MarkDirty( unsigned int node )
+{
+   m_dirty[ node ] = 1;
+   m_firstDirty = std::min( m_firstDirty, node );
+}
+
+void SceneGraph::Update( )
+{
+   m_updated.clear( );
+
+   unsigned int count = GetCount( );
+   for ( unsigned int node = m_firstDirty; node < count; ++node )
+   {
+      int parent = m_parents[ node ];
+      if ( !m_dirty[ node ] && ( parent == NoParent || !m_dirty[ parent ] ) )
+      {
+         continue;
+      }
+
+      // Stays set until the end of the pass so the children below see it
+      m_dirty[ node ] = 1;
+      m_world[ node ] = ( parent == NoParent ) ? m_local[ node ] : m_world[ parent ] * m_local[ node ];
+      m_updated.push_back( node );
+   }
+
+   UpdateBounds( );
+
+   for ( unsigned int node : m_updated )
+   {
+      m_dirty[ node ] = 0;
+   }
+   m_firstDirty = count;
+}
+
+int SceneGraph::FindNode( const std::string& name ) const
+{
+   auto found = std::find( m_names.begin( ), m_names.end( ), name );
+   return ( found != m_names.end( ) ) ? static_cast<int>( found - m_names.begin( ) ) : NoParent;
+}
+
+glm::vec3 SceneGraph::GetWorldBoundsMin( unsigned int node ) const
+{
+   return glm::vec3( m_worldBounds.MinX[ node ], m_worldBounds.MinY[ node ], m_worldBounds.MinZ[ node ] );
+}
+
+glm::vec3 SceneGraph::GetWorldBoundsMax( unsigned int node ) const
+{
+   return glm::vec3( m_worldBounds.MaxX[ node ], m_worldBounds.MaxY[ node ], m_worldBounds.MaxZ[ node ] );
+}
+
+void SceneGraph::UpdateBounds( )
+{
+   // Updated subtrees are consecutive index runs( nodes are added depth first ), each run is one batch
+   size_t runBegin = 0;
+   while ( runBegin < m_updated.size( ) )
+   {
+      size_t runEnd = runBegin + 1;
+      while ( runEnd < m_updated.size( ) && m_updated[ runEnd ] == m_updated[ runEnd - 1 ] + 1 )
+      {
+         ++runEnd;
+      }
+
+      unsigned int first = m_updated[ runBegin ];
+      size_t count = runEnd - runBegin;
+      TransformBounds( &m_world[ first ], &m_localBoundsMin[ first ], &m_localBoundsMax[ first ], count,
+                       &m_worldBounds.MinX[ first ], &m_worldBounds.MinY[ first ], &m_worldBounds.MinZ[ first ],
+                       &m_worldBounds.MaxX[ first ], &m_worldBounds.MaxY[ first ], &m_worldBounds.MaxZ[ first ] );
+
+      // Nodes without geometry stay empty
+      for ( unsigned int node = first; node < first + count; ++node )
+      {
+         if ( m_localBoundsMin[ node ].x > m_localBoundsMax[ node ].x )
+         {
+            SetEmptyBounds( m_worldBounds, node );
+         }
+      }
+
+      runBegin = runEnd;
+   }
+}
\ No newline at end of file
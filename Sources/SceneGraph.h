@@ -0,0 +1,65 @@
+#pragma once
+#include "BatchMath.h"
+
+#include <string>
+#include <vector>
+
+// Node hierarchy stored as flat parallel arrays( SoA ), sorted so every parent comes before its children.
+// Update( ) is then a single forward pass: a node is recomputed when it or its parent changed this pass,
+// which covers exactly the dirty subtrees. World bounds of the updated nodes follow in one batched pass( BatchMath ).
+// Nothing changed since the last update => Update( ) returns immediately, static scenes cost nothing per frame.
+class SceneGraph
+{
+public:
+   static constexpr int NoParent = -1;
+
+public:
+   SceneGraph( );
+
+   // 'parent' must already exist, which keeps the array parent sorted.
+   unsigned int AddNode( int parent, const glm::mat4& local, const std::string& name = std::string( ) );
+   void Clear( );
+
+   void SetLocalTransform( unsigned int node, const glm::mat4& local );
+
+   // Box of the geometry attached to the node in its own space. Nodes without geometry keep an empty box( min > max ).
+   void SetLocalBounds( unsigned int node, const glm::vec3& boundsMin, const glm::vec3& boundsMax );
+
+   void Update( );
+
+   unsigned int GetCount( ) const { return static_cast<unsigned int>( m_parents.size( ) ); }
+   int GetParent( unsigned int node ) const { return m_parents[ node ]; }
+   const std::string& GetName( unsigned int node ) const { return m_names[ node ]; }
+   const glm::mat4& GetLocalTransform( unsigned int node ) const { return m_local[ node ]; }
+
+   // Valid after Update( )
+   const glm::mat4& GetWorldTransform( unsigned int node ) const { return m_world[ node ]; }
+   glm::vec3 GetWorldBoundsMin( unsigned int node ) const;
+   glm::vec3 GetWorldBoundsMax( unsigned int node ) const;
+
+   // Nodes whose world transform was recomputed by the last Update( ), ascending
+   const std::vector<unsigned int>& GetUpdatedNodes( ) const { return m_updated; }
+
+   // First node with the name, NoParent if none
+   int FindNode( const std::string& name ) const;
+
+private:
+   void MarkDirty( unsigned int node );
+   void UpdateBounds( );
+
+private:
+   std::vector<int> m_parents;
+   std::vector<std::string> m_names;
+   std::vector<glm::mat4> m_local;
+   std::vector<glm::mat4> m_world;
+   std::vector<glm::vec3> m_localBoundsMin;
+   std::vector<glm::vec3> m_localBoundsMax;
+   BoundsArray m_worldBounds;
+   std::vector<unsigned char> m_dirty;
+
+   std::vector<unsigned int> m_updated;
+
+   // Lowest dirty node, the pass starts there. GetCount( ) when clean.
+   unsigned int m_firstDirty;
+
+};
\ No newline at end of file
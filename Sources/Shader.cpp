@@ -1,180 +1,606 @@
 #include "Shader.h"
-
-Shader::Shader( const std::string& vertexPath, const std::string& fragmentPath ) 
+#include "AssetCache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace
 {
-   std::string vertexSrc;
-   std::string fragmentSrc;
-   std::ifstream vertexStream;
-   std::ifstream fragmentStream;
+   // GL_KHR_parallel_shader_compile is not part of the generated GLAD loader( ARB variant shares the enums ).
+   typedef void ( APIENTRYP MaxShaderCompilerThreadsProc )( GLuint count );
+
+   bool s_parallelCompile = false;
+   std::vector<Shader*> s_instances;
 
-   vertexStream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-   fragmentStream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-   try
+   bool HasExtension( const char* name )
    {
-      vertexStream.open( vertexPath );
-      fragmentStream.open( fragmentPath );
+      int count = 0;
+      glGetIntegerv( GL_NUM_EXTENSIONS, &count );
+      for ( int idx = 0; idx < count; ++idx )
+      {
+         const char* extension = reinterpret_cast<const char*>( glGetStringi( GL_EXTENSIONS, idx ) );
+         if ( extension != nullptr && std::strcmp( extension, name ) == 0 )
+         {
+            return true;
+         }
+      }
+
+      return false;
+   }
 
-      std::stringstream vertexSS;
-      std::stringstream fragSS;
+   std::string ReadSource( const std::string& path )
+   {
+      std::ifstream stream;
+      stream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
+      try
+      {
+         stream.open( path );
+
+         std::stringstream ss;
+         ss << stream.rdbuf( );
+         stream.close( );
+
+         return ss.str( );
+      }
+      catch ( std::ifstream::failure e )
+      {
+         std::cout << "Error: File not successfully read in shader! " << path << std::endl;
+      }
+
+      return std::string( );
+   }
 
-      vertexSS << vertexStream.rdbuf( );
-      fragSS << fragmentStream.rdbuf( );
+   // Replaces '#include "file"' lines with the file, resolved next to the including file( GLSL has no include
+   // without GL_ARB_shading_language_include ). Every file read is appended to 'dependencies', files already listed are skipped.
+   std::string ExpandIncludes( const std::string& path, std::vector<std::string>& dependencies )
+   {
+      dependencies.push_back( path );
+      std::string directory = path.substr( 0, path.find_last_of( "/\\" ) + 1 );
+
+      std::string result;
+      std::istringstream lines( ReadSource( path ) );
+      std::string line;
+      while ( std::getline( lines, line ) )
+      {
+         size_t directive = line.find_first_not_of( " \t" );
+         if ( directive == std::string::npos || line.compare( directive, 8, "#include" ) != 0 )
+         {
+            result += line + "\n";
+            continue;
+         }
+
+         size_t open = line.find( '"', directive );
+         size_t close = ( open != std::string::npos ) ? line.find( '"', open + 1 ) : std::string::npos;
+         if ( close == std::string::npos )
+         {
+            std::cout << "Error: Malformed include in shader! " << path << std::endl;
+            continue;
+         }
+
+         std::string includePath = directory + line.substr( open + 1, close - open - 1 );
+         if ( std::find( dependencies.begin( ), dependencies.end( ), includePath ) == dependencies.end( ) )
+         {
+            result += ExpandIncludes( includePath, dependencies );
+         }
+      }
+
+      return result;
+   }
+
+   // Only submits the compile, status is checked in Shader::Resolve( ).
+   unsigned int SubmitStage( GLenum type, const std::string& source )
+   {
+      const char* code = source.c_str( );
+
+      unsigned int stage = glCreateShader( type );
+      glShaderSource( stage, 1, &code, nullptr );
+      glCompileShader( stage );
+      return stage;
+   }
+
+   const char* GetStageName( GLenum type )
+   {
+      switch ( type )
+      {
+      case GL_VERTEX_SHADER:
+         return "Vertex";
+      case GL_FRAGMENT_SHADER:
+         return "Fragment";
+      case GL_GEOMETRY_SHADER:
+         return "Geometry";
+      case GL_COMPUTE_SHADER:
+         return "Compute";
+      default:
+         break;
+      }
+
+      return "Unknown";
+   }
 
-      vertexStream.close( );
-      fragmentStream.close( );
+   // Never blocks with parallel compile, without it there is no way to ask.
+   bool IsProgramComplete( unsigned int program )
+   {
+      if ( !s_parallelCompile )
+      {
+         return true;
+      }
+
+      int completed = GL_FALSE;
+      glGetProgramiv( program, GL_COMPLETION_STATUS_KHR, &completed );
+      return completed == GL_TRUE;
+   }
 
-      vertexSrc = vertexSS.str( );
-      fragmentSrc = fragSS.str( );
+   // Waits for the driver, logs errors and releases the stage objects.
+   bool CheckProgram( unsigned int program, std::vector<unsigned int>& stages )
+   {
+      int success = 0;
+      char infoLog[ 512 ];
+
+      glGetProgramiv( program, GL_LINK_STATUS, &success );
+      bool linked = ( success != 0 );
+      if ( !linked )
+      {
+         // Stage logs are only fetched on failure, compile status of a linked program is implied.
+         for ( unsigned int stage : stages )
+         {
+            glGetShaderiv( stage, GL_COMPILE_STATUS, &success );
+            if ( !success )
+            {
+               int type = 0;
+               glGetShaderiv( stage, GL_SHADER_TYPE, &type );
+               glGetShaderInfoLog( stage, 512, nullptr, infoLog );
+               std::cout << GetStageName( static_cast<GLenum>( type ) ) << " shader compilation failed: " << infoLog << std::endl;
+            }
+         }
+
+         glGetProgramInfoLog( program, 512, nullptr, infoLog );
+         std::cout << infoLog << std::endl;
+      }
+
+      for ( unsigned int stage : stages )
+      {
+         glDetachShader( program, stage );
+         glDeleteShader( stage );
+      }
+      stages.clear( );
+      return linked;
    }
-   catch ( std::ifstream::failure e )
+
+   void DiscardProgram( unsigned int& program, std::vector<unsigned int>& stages )
    {
-      std::cout << "Error: File not successfully read in shader!" << std::endl;
+      for ( unsigned int stage : stages )
+      {
+         glDeleteShader( stage );
+      }
+      stages.clear( );
+
+      if ( program != 0 )
+      {
+         glDeleteProgram( program );
+         program = 0;
+      }
    }
 
-   const char* vShaderCode = vertexSrc.c_str( );
-   const char* fShaderCode = fragmentSrc.c_str( );
+   // Copies the current value of every uniform 'to' shares with 'from'( same name and type ).
+   void CopyUniforms( unsigned int from, unsigned int to )
+   {
+      int previous = 0;
+      glGetIntegerv( GL_CURRENT_PROGRAM, &previous );
+      glUseProgram( to );
+
+      int count = 0;
+      glGetProgramiv( to, GL_ACTIVE_UNIFORMS, &count );
+      for ( int idx = 0; idx < count; ++idx )
+      {
+         char name[ 256 ];
+         int size = 0;
+         GLenum type = GL_NONE;
+         glGetActiveUniform( to, idx, sizeof( name ), nullptr, &size, &type, name );
+
+         // Arrays are reported as 'name[0]', every element is looked up on its own
+         std::string base = name;
+         size_t bracket = base.find( '[' );
+         if ( bracket != std::string::npos )
+         {
+            base.resize( bracket );
+         }
+
+         for ( int element = 0; element < size; ++element )
+         {
+            std::string elementName = ( size > 1 ) ? base + "[" + std::to_string( element ) + "]" : std::string( name );
+            int source = glGetUniformLocation( from, elementName.c_str( ) );
+            int target = glGetUniformLocation( to, elementName.c_str( ) );
+            if ( source < 0 || target < 0 )
+            {
+               continue;
+            }
+
+            float floats[ 16 ];
+            int ints[ 4 ];
+            unsigned int uints[ 4 ];
+            switch ( type )
+            {
+            case GL_FLOAT:
+               glGetUniformfv( from, source, floats );
+               glUniform1fv( target, 1, floats );
+               break;
+            case GL_FLOAT_VEC2:
+               glGetUniformfv( from, source, floats );
+               glUniform2fv( target, 1, floats );
+               break;
+            case GL_FLOAT_VEC3:
+               glGetUniformfv( from, source, floats );
+               glUniform3fv( target, 1, floats );
+               break;
+            case GL_FLOAT_VEC4:
+               glGetUniformfv( from, source, floats );
+               glUniform4fv( target, 1, floats );
+               break;
+            case GL_FLOAT_MAT3:
+               glGetUniformfv( from, source, floats );
+               glUniformMatrix3fv( target, 1, GL_FALSE, floats );
+               break;
+            case GL_FLOAT_MAT4:
+               glGetUniformfv( from, source, floats );
+               glUniformMatrix4fv( target, 1, GL_FALSE, floats );
+               break;
+            case GL_INT_VEC2:
+            case GL_BOOL_VEC2:
+               glGetUniformiv( from, source, ints );
+               glUniform2iv( target, 1, ints );
+               break;
+            case GL_INT_VEC3:
+            case GL_BOOL_VEC3:
+               glGetUniformiv( from, source, ints );
+               glUniform3iv( target, 1, ints );
+               break;
+            case GL_INT_VEC4:
+            case GL_BOOL_VEC4:
+               glGetUniformiv( from, source, ints );
+               glUniform4iv( target, 1, ints );
+               break;
+            case GL_UNSIGNED_INT:
+               glGetUniformuiv( from, source, uints );
+               glUniform1uiv( target, 1, uints );
+               break;
+            case GL_UNSIGNED_INT_VEC2:
+               glGetUniformuiv( from, source, uints );
+               glUniform2uiv( target, 1, uints );
+               break;
+            case GL_UNSIGNED_INT_VEC3:
+               glGetUniformuiv( from, source, uints );
+               glUniform3uiv( target, 1, uints );
+               break;
+            case GL_UNSIGNED_INT_VEC4:
+               glGetUniformuiv( from, source, uints );
+               glUniform4uiv( target, 1, uints );
+               break;
+            default:
+               // int, bool and every sampler / image type
+               glGetUniformiv( from, source, ints );
+               glUniform1i( target, ints[ 0 ] );
+               break;
+            }
+         }
+      }
+
+      glUseProgram( static_cast<unsigned int>( previous ) );
+   }
+}
 
-   unsigned int vertex;
-   unsigned int fragment;
-   int success = 0;
-   char infoLog[ 512 ];
 
-   vertex = glCreateShader( GL_VERTEX_SHADER );
-   glShaderSource( vertex, 1, &vShaderCode, nullptr );
-   glCompileShader( vertex );
-   glGetShaderiv( vertex, GL_COMPILE_STATUS, &success );
-   if ( !success )
+// Inserts '#define ...' lines right after the #version directive.
+static std::string InjectDefines( const std::string& source, const std::vector<std::string>& defines )
+{
+   if ( defines.empty( ) )
    {
-      glGetShaderInfoLog( vertex, 512, nullptr, infoLog );
-      std::cout << "Vertex shader compilation failed: " << infoLog << std::endl;
+      return source;
    }
 
-   fragment = glCreateShader( GL_FRAGMENT_SHADER );
-   glShaderSource( fragment, 1, &fShaderCode, nullptr );
-   glCompileShader( fragment );
-   glGetShaderiv( fragment, GL_COMPILE_STATUS, &success );
-   if ( !success )
+   std::string defineBlock;
+   for ( const auto& define : defines )
    {
-      glGetShaderInfoLog( fragment, 512, nullptr, infoLog );
-      std::cout << "Fragment shader compilation failed: " << infoLog << std::endl;
+      defineBlock += "#define " + define + "\n";
    }
 
-   m_id = glCreateProgram( );
-   glAttachShader( m_id, vertex );
-   glAttachShader( m_id, fragment );
-   glLinkProgram( m_id );
+   size_t versionPos = source.find( "#version" );
+   if ( versionPos == std::string::npos )
+   {
+      return defineBlock + source;
+   }
 
-   glGetProgramiv( m_id, GL_LINK_STATUS, &success );
-   if ( !success )
+   size_t lineEnd = source.find( '\n', versionPos );
+   if ( lineEnd == std::string::npos )
    {
-      glGetProgramInfoLog( m_id, 512, nullptr, infoLog );
-      std::cout << "Failed to linking program : " << infoLog << std::endl;
+      return source + "\n" + defineBlock;
    }
 
-   glDeleteShader( vertex );
-   glDeleteShader( fragment );
+   return source.substr( 0, lineEnd + 1 ) + defineBlock + source.substr( lineEnd + 1 );
 }
 
-Shader::Shader( const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath )
+namespace
 {
-   std::string vertexSrc;
-   std::string fragmentSrc;
-   std::ifstream vertexStream;
-   std::ifstream fragmentStream;
+   // Output of Tools/ShaderCompiler( pre build step of the demo ), relative to the working directory so nothing is
+   // written into Resources/. Programs are keyed by file names, the demo loads every shader from one directory.
+   const char* ShaderCacheDirectory = "ShaderCache/";
+   const char* ProgramManifest = "programs.txt";
+
+   // FNV-1a over the program description, names the optimized files.
+   std::string GetProgramKey( const std::string& vertexName, const std::string& fragmentName, const std::vector<std::string>& defines )
+   {
+      std::string description = vertexName + "\n" + fragmentName + "\n";
+      for ( const auto& define : defines )
+      {
+         description += define + "\n";
+      }
+
+      uint64_t hash = 14695981039346656037ull;
+      for ( char c : description )
+      {
+         hash ^= static_cast<unsigned char>( c );
+         hash *= 1099511628211ull;
+      }
+
+      char key[ 17 ];
+      std::snprintf( key, sizeof( key ), "%016llx", static_cast<unsigned long long>( hash ) );
+      return key;
+   }
+
+   // Programs without up to date optimized output are listed for the offline compiler:
+   //    <key> <vertex> <fragment> [define|define...]
+   void RecordProgram( const std::string& manifestPath, const std::string& key, const std::string& vertexName,
+                       const std::string& fragmentName, const std::vector<std::string>& defines )
+   {
+      static std::map<std::string, std::set<std::string>> recorded;
+
+      auto found = recorded.find( manifestPath );
+      if ( found == recorded.end( ) )
+      {
+         found = recorded.emplace( manifestPath, std::set<std::string>( ) ).first;
+
+         std::ifstream manifest( manifestPath );
+         std::string line;
+         while ( std::getline( manifest, line ) )
+         {
+            found->second.insert( line.substr( 0, line.find( ' ' ) ) );
+         }
+      }
+
+      if ( !found->second.insert( key ).second )
+      {
+         return;
+      }
+
+      std::string line = key + " " + vertexName + " " + fragmentName + " ";
+      for ( size_t idx = 0; idx < defines.size( ); ++idx )
+      {
+         line += ( idx > 0 ? "|" : "" ) + defines[ idx ];
+      }
+
+      // Fails silently when the directory does not exist( created by the pre build step ), the pipeline is optional
+      std::ofstream manifest( manifestPath, std::ios::app );
+      manifest << line << std::endl;
+   }
 
-   vertexStream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-   fragmentStream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-   try
+   // Replaces the sources with the offline optimized GLSL( defines and includes already applied ) while it is newer than
+   // every file in 'dependencies'.
+   bool LoadOptimizedProgram( const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines,
+                              const std::vector<std::string>& dependencies, std::string& vertexSrc, std::string& fragmentSrc )
    {
-      vertexStream.open( vertexPath );
-      fragmentStream.open( fragmentPath );
+      size_t vertexSplit = vertexPath.find_last_of( "/\\" ) + 1;
+      size_t fragmentSplit = fragmentPath.find_last_of( "/\\" ) + 1;
+      std::string directory = fragmentPath.substr( 0, fragmentSplit );
+      if ( vertexPath.substr( 0, vertexSplit ) != directory )
+      {
+         return false;
+      }
+
+      std::string vertexName = vertexPath.substr( vertexSplit );
+      std::string fragmentName = fragmentPath.substr( fragmentSplit );
+      std::string key = GetProgramKey( vertexName, fragmentName, defines );
+      std::string optimizedVertex = ShaderCacheDirectory + key + ".vert.glsl";
+      std::string optimizedFragment = ShaderCacheDirectory + key + ".frag.glsl";
+
+      if ( !IsCacheFresh( optimizedVertex, dependencies ) || !IsCacheFresh( optimizedFragment, dependencies ) )
+      {
+         RecordProgram( ShaderCacheDirectory + std::string( ProgramManifest ), key, vertexName, fragmentName, defines );
+         return false;
+      }
+
+      vertexSrc = ReadSource( optimizedVertex );
+      fragmentSrc = ReadSource( optimizedFragment );
+      return true;
+   }
+}
+
+Shader::Shader( const std::string& vertexPath, const std::string& fragmentPath ) :
+   Shader( vertexPath, fragmentPath, std::vector<std::string>( ) )
+{
+}
+
+Shader::Shader( const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines ) :
+   m_sources{ { GL_VERTEX_SHADER, vertexPath }, { GL_FRAGMENT_SHADER, fragmentPath } },
+   m_defines( defines )
+{
+   Submit( );
+}
+
+Shader::Shader( const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath ) :
+   m_sources{ { GL_VERTEX_SHADER, vertexPath }, { GL_FRAGMENT_SHADER, fragmentPath }, { GL_GEOMETRY_SHADER, geometryPath } }
+{
+   Submit( );
+}
 
-      std::stringstream vertexSS;
-      std::stringstream fragSS;
+Shader::Shader( const std::string& computePath ) :
+   m_sources{ { GL_COMPUTE_SHADER, computePath } }
+{
+   Submit( );
+}
 
-      vertexSS << vertexStream.rdbuf( );
-      fragSS << fragmentStream.rdbuf( );
+Shader::~Shader( )
+{
+   s_instances.erase( std::find( s_instances.begin( ), s_instances.end( ), this ) );
 
-      vertexStream.close( );
-      fragmentStream.close( );
+   DiscardProgram( m_pendingId, m_pendingStages );
+   DiscardProgram( m_id, m_stages );
+}
 
-      vertexSrc = vertexSS.str( );
-      fragmentSrc = fragSS.str( );
+void Shader::Submit( )
+{
+   m_id = SubmitProgram( m_stages );
+   m_resolved = false;
+   m_pendingId = 0;
+   s_instances.push_back( this );
+}
+
+void Shader::InitializeParallelCompile( GLADloadproc load )
+{
+   const char* function = nullptr;
+   if ( HasExtension( "GL_KHR_parallel_shader_compile" ) )
+   {
+      function = "glMaxShaderCompilerThreadsKHR";
+   }
+   else if ( HasExtension( "GL_ARB_parallel_shader_compile" ) )
+   {
+      function = "glMaxShaderCompilerThreadsARB";
    }
-   catch ( std::ifstream::failure e )
+
+   auto maxCompilerThreads = ( function != nullptr ) ? reinterpret_cast<MaxShaderCompilerThreadsProc>( load( function ) ) : nullptr;
+   s_parallelCompile = ( maxCompilerThreads != nullptr );
+   if ( s_parallelCompile )
    {
-      std::cout << "Error: File not successfully read in shader!" << std::endl;
+      // Implementation picks the thread count
+      maxCompilerThreads( 0xFFFFFFFF );
    }
+}
 
-   const char* vShaderCode = vertexSrc.c_str( );
-   const char* fShaderCode = fragmentSrc.c_str( );
+bool Shader::IsParallelCompileSupported( )
+{
+   return s_parallelCompile;
+}
 
-   unsigned int vertex;
-   unsigned int fragment;
-   int success = 0;
-   char infoLog[ 512 ];
+bool Shader::IsReady( ) const
+{
+   return m_resolved || IsProgramComplete( m_id );
+}
 
-   vertex = glCreateShader( GL_VERTEX_SHADER );
-   glShaderSource( vertex, 1, &vShaderCode, nullptr );
-   glCompileShader( vertex );
-   glGetShaderiv( vertex, GL_COMPILE_STATUS, &success );
-   if ( !success )
+void Shader::Resolve( )
+{
+   if ( m_resolved )
    {
-      glGetShaderInfoLog( vertex, 512, nullptr, infoLog );
-      std::cout << "Vertex shader compilation failed: " << infoLog << std::endl;
+      return;
    }
+   m_resolved = true;
 
-   fragment = glCreateShader( GL_FRAGMENT_SHADER );
-   glShaderSource( fragment, 1, &fShaderCode, nullptr );
-   glCompileShader( fragment );
-   glGetShaderiv( fragment, GL_COMPILE_STATUS, &success );
-   if ( !success )
+   if ( !CheckProgram( m_id, m_stages ) )
    {
-      glGetShaderInfoLog( fragment, 512, nullptr, infoLog );
-      std::cout << "Fragment shader compilation failed: " << infoLog << std::endl;
+      std::cout << "Failed to linking program : " << m_sources.back( ).second << std::endl;
    }
+}
 
-   std::ifstream geoFileStream;
-   geoFileStream.open( geometryPath.c_str( ) );
-   std::stringstream geoSS;
-   geoSS << geoFileStream.rdbuf( );
-   geoFileStream.close( );
-
-   auto geoSrcStr = geoSS.str( );
-   const char* geoSrc = geoSrcStr.c_str( );
+void Shader::Use( )
+{
+   Resolve( );
+   glUseProgram( m_id );
+}
 
-   unsigned int geometry{ 0 };
-   geometry = glCreateShader( GL_GEOMETRY_SHADER );
-   glShaderSource( geometry, 1, &geoSrc, nullptr );
-   glCompileShader( geometry );
-   glGetShaderiv( geometry, GL_COMPILE_STATUS, &success );
-   if ( !success )
+bool Shader::UsesFile( const std::string& fileName ) const
+{
+   for ( const auto& path : m_dependencies )
    {
-      glGetShaderInfoLog( geometry, 512, nullptr, infoLog );
-      std::cout << "Geometry shader compilation failed: " << infoLog << std::endl;
+      size_t split = path.find_last_of( "/\\" ) + 1;
+      if ( path.compare( split, std::string::npos, fileName ) == 0 )
+      {
+         return true;
+      }
    }
 
-   m_id = glCreateProgram( );
-   glAttachShader( m_id, vertex );
-   glAttachShader( m_id, fragment );
-   glAttachShader( m_id, geometry );
-   glLinkProgram( m_id );
+   return false;
+}
 
-   glGetProgramiv( m_id, GL_LINK_STATUS, &success );
-   if ( !success )
+void Shader::BeginReload( )
+{
+   // The live program keeps drawing until the new one is linked
+   Resolve( );
+   DiscardProgram( m_pendingId, m_pendingStages );
+   m_pendingId = SubmitProgram( m_pendingStages );
+}
+
+bool Shader::IsReloadReady( ) const
+{
+   return m_pendingId != 0 && IsProgramComplete( m_pendingId );
+}
+
+bool Shader::FinishReload( )
+{
+   if ( m_pendingId == 0 )
+   {
+      return false;
+   }
+
+   unsigned int program = m_pendingId;
+   m_pendingId = 0;
+   if ( !CheckProgram( program, m_pendingStages ) )
    {
-      glGetProgramInfoLog( m_id, 512, nullptr, infoLog );
-      std::cout << "Failed to linking program : " << infoLog << std::endl;
+      std::cout << "Reload failed, keeping previous program : " << m_sources.back( ).second << std::endl;
+      glDeleteProgram( program );
+      return false;
    }
 
-   glDeleteShader( geometry );
-   glDeleteShader( vertex );
-   glDeleteShader( fragment );
+   // Values set once( sampler units, settings ) carry over, per draw uniforms are set again anyway
+   CopyUniforms( m_id, program );
+   glDeleteProgram( m_id );
+   m_id = program;
+   std::cout << "Reloaded : " << m_sources.back( ).second << std::endl;
+   return true;
 }
 
-void Shader::Use( )
+const std::vector<Shader*>& Shader::GetInstances( )
 {
-   glUseProgram( m_id );
+   return s_instances;
+}
+
+unsigned int Shader::SubmitProgram( std::vector<unsigned int>& stages )
+{
+   // Sources are always expanded, the includes they name are part of the optimized program's freshness check
+   std::vector<std::string> sources;
+   m_dependencies.clear( );
+   for ( const auto& source : m_sources )
+   {
+      std::vector<std::string> stageFiles;
+      sources.push_back( InjectDefines( ExpandIncludes( source.second, stageFiles ), m_defines ) );
+      m_dependencies.insert( m_dependencies.end( ), stageFiles.begin( ), stageFiles.end( ) );
+   }
+   if ( m_sources.size( ) == 2 && m_sources[ 0 ].first == GL_VERTEX_SHADER && m_sources[ 1 ].first == GL_FRAGMENT_SHADER )
+   {
+      LoadOptimizedProgram( m_sources[ 0 ].second, m_sources[ 1 ].second, m_defines, m_dependencies, sources[ 0 ], sources[ 1 ] );
+   }
+
+   stages.clear( );
+   for ( size_t idx = 0; idx < m_sources.size( ); ++idx )
+   {
+      stages.push_back( SubmitStage( m_sources[ idx ].first, sources[ idx ] ) );
+   }
+
+   // Linking right away is fine, the driver resolves the stages on its side without waiting for us.
+   unsigned int program = glCreateProgram( );
+   for ( unsigned int stage : stages )
+   {
+      glAttachShader( program, stage );
+   }
+   glLinkProgram( program );
+   return program;
 }
 
 void Shader::SetBool( const std::string& name, bool value ) const
@@ -210,4 +636,24 @@ void Shader::SetVec4f( const std::string& name, float x, float y, float z, float
 void Shader::SetMat4f( const std::string& name, const glm::mat4& mat ) const
 {
    glUniformMatrix4fv( glGetUniformLocation( m_id, name.c_str( ) ), 1, GL_FALSE, glm::value_ptr( mat ) );
+}
+
+void Shader::SetIntArray( const std::string& name, const int* values, int count ) const
+{
+   glUniform1iv( glGetUniformLocation( m_id, name.c_str( ) ), count, values );
+}
+
+void Shader::SetFloatArray( const std::string& name, const float* values, int count ) const
+{
+   glUniform1fv( glGetUniformLocation( m_id, name.c_str( ) ), count, values );
+}
+
+void Shader::SetVec3fArray( const std::string& name, const glm::vec3* values, int count ) const
+{
+   glUniform3fv( glGetUniformLocation( m_id, name.c_str( ) ), count, glm::value_ptr( values[ 0 ] ) );
+}
+
+void Shader::SetMat4fArray( const std::string& name, const glm::mat4* values, int count ) const
+{
+   glUniformMatrix4fv( glGetUniformLocation( m_id, name.c_str( ) ), count, GL_FALSE, glm::value_ptr( values[ 0 ] ) );
 }
\ No newline at end of file
@@ -6,20 +6,56 @@
 #include "glm/gtc/type_ptr.hpp"
 
 #include <string>
+#include <utility>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+// Constructors only submit compile and link, nothing waits on the driver until the program is first used( Resolve ).
+// Programs created back to back therefore compile concurrently when the driver supports parallel compilation.
+// Sources may '#include "file"' relative to their own directory, includes are expanded before the compile.
 class Shader
 {
 public:
    Shader( const std::string& vertexPath, const std::string& fragmentPath );
+   // Each define is injected as '#define <define>' right after #version, ex) "BLOOM", "TONEMAP 2"
+   // Loads the offline optimized GLSL from 'ShaderCache/'( Tools/ShaderCompiler ) instead while it is up to date,
+   // otherwise the program is listed in 'ShaderCache/programs.txt' for the next build.
+   Shader( const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines );
    Shader( const std::string& vertexPath, const std::string& fargmentPath, const std::string& geometryPath );
+   // Compute program. Requires a 4.3+ context.
+   explicit Shader( const std::string& computePath );
+   ~Shader( );
+
+   Shader( const Shader& ) = delete;
+   Shader& operator=( const Shader& ) = delete;
+
+   // Lets the driver compile on its own threads( GL_KHR_parallel_shader_compile ). Call once after loading GL.
+   static void InitializeParallelCompile( GLADloadproc load );
+   static bool IsParallelCompileSupported( );
+
+   // Waits for the driver and reports compile / link errors, once. Use( ) does this implicitly.
+   void Resolve( );
+
+   // Whether Resolve( ) would return without stalling. Without parallel compile there is no way to ask, always true.
+   bool IsReady( ) const;
 
    void Use( );
 
    int GetID( ) const { return m_id; }
 
+   // Hot reload( ShaderHotReload ). The new program is built from the same files and defines next to the live one
+   // and only replaces it once it links, uniforms already set on the live program carry over. Includes count as used files.
+   bool UsesFile( const std::string& fileName ) const;
+   void BeginReload( );
+   bool IsReloadPending( ) const { return m_pendingId != 0; }
+   bool IsReloadReady( ) const;
+   bool FinishReload( );
+
+   // Every live shader
+   static const std::vector<Shader*>& GetInstances( );
+
    void SetBool( const std::string& name, bool value ) const;
    void SetInt( const std::string& name, int value ) const;
    void SetFloat( const std::string& name, float value ) const;
@@ -39,8 +75,25 @@ public:
       SetVec4f( name, vec.x, vec.y, vec.z, vec.w );
    }
    void SetMat4f( const std::string& name, const glm::mat4& mat ) const;
+   void SetIntArray( const std::string& name, const int* values, int count ) const;
+   void SetFloatArray( const std::string& name, const float* values, int count ) const;
+   void SetVec3fArray( const std::string& name, const glm::vec3* values, int count ) const;
+   void SetMat4fArray( const std::string& name, const glm::mat4* values, int count ) const;
+
+private:
+   void Submit( );
+   unsigned int SubmitProgram( std::vector<unsigned int>& stages );
 
 private:
+   std::vector<std::pair<GLenum, std::string>> m_sources;
+   std::vector<std::string> m_defines;
+   std::vector<std::string> m_dependencies;  // Stage files and their includes, as of the last submit
+
    unsigned int m_id;
+   std::vector<unsigned int> m_stages;  // Kept until Resolve( ) for the error log
+   bool m_resolved;
+
+   unsigned int m_pendingId;
+   std::vector<unsigned int> m_pendingStages;
 
 };
\ No newline at end of file
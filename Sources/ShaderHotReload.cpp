@@ -0,0 +1,29 @@
+#include "ShaderHotReload.h"
+
+ShaderHotReload::ShaderHotReload( const std::string& directory ) :
+   m_watcher( directory )
+{
+}
+
+void ShaderHotReload::Update( )
+{
+   for ( const auto& fileName : m_watcher.ConsumeChanges( ) )
+   {
+      for ( Shader* shader : Shader::GetInstances( ) )
+      {
+         // Saving again before the previous edit finished compiling restarts the rebuild
+         if ( shader->UsesFile( fileName ) )
+         {
+            shader->BeginReload( );
+         }
+      }
+   }
+
+   for ( Shader* shader : Shader::GetInstances( ) )
+   {
+      if ( shader->IsReloadPending( ) && shader->IsReloadReady( ) )
+      {
+         shader->FinishReload( );
+      }
+   }
+}
\ No newline at end of file
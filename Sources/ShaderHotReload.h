@@ -0,0 +1,21 @@
+#pragma once
+#include "Shader.h"
+#include "FileWatcher.h"
+
+// Rebuilds every live Shader whose files change on disk while the demo runs.
+// Changed programs are submitted right away and swapped in on a later frame once the driver reports them
+// complete( parallel compile ), a program which fails to compile or link keeps the previous one running.
+// Without parallel compile IsReloadReady( ) is immediately true, the swap happens in the same Update( ),
+// which waits for the compile.
+class ShaderHotReload
+{
+public:
+   explicit ShaderHotReload( const std::string& directory );
+
+   // Once per frame on the GL thread.
+   void Update( );
+
+private:
+   FileWatcher m_watcher;
+
+};
\ No newline at end of file
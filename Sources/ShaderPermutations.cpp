@@ -0,0 +1,79 @@
+#include "ShaderPermutations.h"
+
+#include <algorithm>
+
+ShaderPermutations::ShaderPermutations( const std::string& vertexPath, const std::string& fragmentPath, const InitCallback& init ) :
+   m_vertexPath( vertexPath ),
+   m_fragmentPath( fragmentPath ),
+   m_init( init )
+{
+}
+
+Shader& ShaderPermutations::Get( const Defines& defines )
+{
+   Permutation& permutation = Submit( defines );
+   if ( !permutation.Initialized )
+   {
+      Initialize( permutation );
+   }
+
+   return *permutation.Program;
+}
+
+void ShaderPermutations::Prewarm( const std::vector<Defines>& defineSets )
+{
+   for ( const auto& defines : defineSets )
+   {
+      Submit( defines );
+   }
+}
+
+void ShaderPermutations::FinishPrewarm( )
+{
+   for ( auto& entry : m_permutations )
+   {
+      if ( !entry.second.Initialized )
+      {
+         Initialize( entry.second );
+      }
+   }
+}
+
+bool ShaderPermutations::IsPrewarmComplete( ) const
+{
+   for ( const auto& entry : m_permutations )
+   {
+      if ( !entry.second.Initialized && !entry.second.Program->IsReady( ) )
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+ShaderPermutations::Permutation& ShaderPermutations::Submit( const Defines& defines )
+{
+   Defines key = defines;
+   std::sort( key.begin( ), key.end( ) );
+   key.erase( std::unique( key.begin( ), key.end( ) ), key.end( ) );
+
+   Permutation& permutation = m_permutations[ key ];
+   if ( !permutation.Program )
+   {
+      permutation.Program = std::make_unique<Shader>( m_vertexPath, m_fragmentPath, key );
+   }
+
+   return permutation;
+}
+
+void ShaderPermutations::Initialize( Permutation& permutation )
+{
+   // Use( ) is the first point that waits on the driver
+   permutation.Program->Use( );
+   if ( m_init )
+   {
+      m_init( *permutation.Program );
+   }
+   permutation.Initialized = true;
+}
\ No newline at end of file
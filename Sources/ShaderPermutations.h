@@ -0,0 +1,60 @@
+#pragma once
+#include "Shader.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Compiled variants of one vertex / fragment pair, one program per define set( injected after #version, see Shader ).
+// Features which stay constant over a draw become preprocessor branches and compile time loop counts instead of
+// uniforms, so every program only contains the code its draws run.
+// Define sets are normalized( sorted, duplicates dropped ), the same features in another order share a program.
+class ShaderPermutations
+{
+public:
+   using Defines = std::vector<std::string>;
+
+   // Called once on every new program while it is in use, ex) sampler units
+   using InitCallback = std::function<void( Shader& )>;
+
+public:
+   ShaderPermutations( const std::string& vertexPath, const std::string& fragmentPath, const InitCallback& init = nullptr );
+
+   ShaderPermutations( const ShaderPermutations& ) = delete;
+   ShaderPermutations& operator=( const ShaderPermutations& ) = delete;
+
+   // Compiled on first use unless prewarmed. Normalizes the set and searches the map on every call, callers drawing
+   // every frame keep the returned program( stable for the lifetime of this object ) until their features change.
+   Shader& Get( const Defines& defines );
+
+   // Submits every set at once without waiting, the driver compiles them( in parallel where supported ) while
+   // loading continues. FinishPrewarm( ) at the end of loading so switching features never stalls a frame.
+   void Prewarm( const std::vector<Defines>& defineSets );
+   void FinishPrewarm( );
+
+   // Whether every submitted program has finished compiling, never blocks.
+   bool IsPrewarmComplete( ) const;
+
+   size_t GetCount( ) const { return m_permutations.size( ); }
+
+private:
+   struct Permutation
+   {
+      std::unique_ptr<Shader> Program;
+      bool Initialized = false;
+   };
+
+private:
+   Permutation& Submit( const Defines& defines );
+   void Initialize( Permutation& permutation );
+
+private:
+   std::string m_vertexPath;
+   std::string m_fragmentPath;
+   InitCallback m_init;
+
+   std::map<Defines, Permutation> m_permutations;
+
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "ShadowFilter.h"
+#include "glad/glad.h"
+
+const char* ToString( ShadowFilter filter )
+{
+   switch ( filter )
+   {
+   case ShadowFilter::Hardware:
+      return "Hardware PCF";
+   case ShadowFilter::PoissonPCF:
+      return "Poisson PCF";
+   case ShadowFilter::OptimizedPCF:
+      return "Optimized PCF";
+   case ShadowFilter::EVSM:
+      return "EVSM";
+   default:
+      break;
+   }
+
+   return "Unknown";
+}
+
+std::string GetShaderDefine( ShadowFilter filter )
+{
+   return "SHADOW_FILTER " + std::to_string( static_cast<int>( filter ) );
+}
+
+ShadowFilter GetPlatformShadowFilter( )
+{
+   return GLAD_GL_VERSION_4_3 ? ShadowFilter::OptimizedPCF : ShadowFilter::Hardware;
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+
+// Shadow filtering quality tiers, cheapest first. Values match SHADOW_FILTER in Bloom.fs / DeferredLighting.fs.
+// Every tier samples through a comparison sampler( GL_COMPARE_REF_TO_TEXTURE ), so each tap is already a 2x2 bilinear PCF.
+enum class ShadowFilter
+{
+   Hardware = 0,   // Single comparison tap
+   PoissonPCF,     // 16 comparison taps on a per pixel rotated Poisson disk
+   OptimizedPCF,   // 5x5 tent filter out of 9 weighted comparison taps
+   EVSM,           // Exponential variance shadow map, pre blurred once so every lookup is one tap( sun only )
+   EnumMax
+};
+
+const char* ToString( ShadowFilter filter );
+
+// Permutation define selecting the tier in the scene shaders, see ShaderPermutations.
+std::string GetShaderDefine( ShadowFilter filter );
+
+// Default tier for the current context, 3.3 fallback contexts get the single tap.
+ShadowFilter GetPlatformShadowFilter( );
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "TemporalAA.h"
+#include "Primitives.h"
+
+TemporalAA::TemporalAA( ) :
+   m_shader( "../Resources/Shaders/FullScreen.vs", "../Resources/Shaders/TAA.fs" ),
+   m_width( 0 ),
+   m_height( 0 ),
+   m_current( 0 ),
+   m_historyValid( false )
+{
+   glGenTextures( 2, m_history );
+   for ( unsigned int texture : m_history )
+   {
+      glBindTexture( GL_TEXTURE_2D, texture );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   }
+   glBindTexture( GL_TEXTURE_2D, 0 );
+
+   m_shader.Use( );
+   m_shader.SetInt( "currentColor", 0 );
+   m_shader.SetInt( "velocityBuffer", 1 );
+   m_shader.SetInt( "depthBuffer", 2 );
+   m_shader.SetInt( "history", 3 );
+}
+
+TemporalAA::~TemporalAA( )
+{
+   glDeleteTextures( 2, m_history );
+}
+
+void TemporalAA::ResizeHistory( unsigned int width, unsigned int height )
+{
+   for ( unsigned int texture : m_history )
+   {
+      glBindTexture( GL_TEXTURE_2D, texture );
+      glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr );
+   }
+   glBindTexture( GL_TEXTURE_2D, 0 );
+
+   m_width = width;
+   m_height = height;
+   m_historyValid = false;
+}
+
+FrameGraphResource TemporalAA::AddPass( FrameGraph& frameGraph, FrameGraphResource color, FrameGraphResource velocity,
+                                        FrameGraphResource depth, const glm::vec2& jitter )
+{
+   unsigned int width = frameGraph.GetOutputWidth( );
+   unsigned int height = frameGraph.GetOutputHeight( );
+   if ( width != m_width || height != m_height )
+   {
+      ResizeHistory( width, height );
+   }
+
+   m_current = 1 - m_current;
+   FrameGraphResource previous = frameGraph.Import( "TAA History", m_history[ 1 - m_current ], width, height );
+   FrameGraphResource resolved = frameGraph.Import( "TAA Resolved", m_history[ m_current ], width, height );
+
+   frameGraph.AddPass( "TAA",
+                       [ & ]( FrameGraphBuilder& builder )
+   {
+      builder.Read( color );
+      builder.Read( velocity );
+      builder.Read( depth );
+      builder.Read( previous );
+      builder.WriteColor( resolved, 0 );
+   },
+                       [ this, color, velocity, depth, previous, jitter ]( const FrameGraphPassContext& context )
+   {
+      m_shader.Use( );
+      m_shader.SetVec2f( "jitter", jitter );
+      m_shader.SetVec2f( "renderSize", glm::vec2( context.GetWidth( color ), context.GetHeight( color ) ) );
+      m_shader.SetVec2f( "outputSize", glm::vec2( m_width, m_height ) );
+      m_shader.SetFloat( "blendFactor", m_settings.BlendFactor );
+      m_shader.SetInt( "historyValid", m_historyValid );
+
+      glActiveTexture( GL_TEXTURE0 );
+      glBindTexture( GL_TEXTURE_2D, context.GetTexture( color ) );
+      glActiveTexture( GL_TEXTURE1 );
+      glBindTexture( GL_TEXTURE_2D, context.GetTexture( velocity ) );
+      glActiveTexture( GL_TEXTURE2 );
+      glBindTexture( GL_TEXTURE_2D, context.GetTexture( depth ) );
+      glActiveTexture( GL_TEXTURE3 );
+      glBindTexture( GL_TEXTURE_2D, context.GetTexture( previous ) );
+
+      glDisable( GL_DEPTH_TEST );
+      renderQuad( );
+      glEnable( GL_DEPTH_TEST );
+      glActiveTexture( GL_TEXTURE0 );
+
+      m_historyValid = true;
+   } );
+
+   return resolved;
+}
\ No newline at end of file
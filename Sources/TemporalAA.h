@@ -0,0 +1,48 @@
+#pragma once
+#include "Shader.h"
+#include "FrameGraph.h"
+
+struct TemporalAASettings
+{
+   float BlendFactor = 0.1f;        // Weight of the current frame
+   unsigned int JitterSequence = 8; // Halton( 2, 3 ) points before the pattern repeats
+};
+
+// Temporal anti aliasing and upsampling.
+// Resolves the jittered render resolution color into an output resolution history buffer, history is
+// owned here( persists across frames ) and imported into the frame graph every frame.
+class TemporalAA
+{
+public:
+   TemporalAA( );
+   ~TemporalAA( );
+
+   TemporalAA( const TemporalAA& ) = delete;
+   TemporalAA& operator=( const TemporalAA& ) = delete;
+
+   void SetSettings( const TemporalAASettings& settings ) { m_settings = settings; }
+   const TemporalAASettings& GetSettings( ) const { return m_settings; }
+
+   // Drops accumulated history( ex. TAA was disabled, camera cut ).
+   void Invalidate( ) { m_historyValid = false; }
+
+   // Adds the resolve pass, 'jitter' is the projection offset( in render pixels ) 'color' was rendered with.
+   // Returns the resolved color at frame graph output resolution.
+   FrameGraphResource AddPass( FrameGraph& frameGraph, FrameGraphResource color, FrameGraphResource velocity,
+                               FrameGraphResource depth, const glm::vec2& jitter );
+
+private:
+   void ResizeHistory( unsigned int width, unsigned int height );
+
+private:
+   TemporalAASettings m_settings;
+   Shader m_shader;
+
+   // Storage is respecified in place on resize, texture names stay valid for cached framebuffers
+   unsigned int m_history[ 2 ];
+   unsigned int m_width;
+   unsigned int m_height;
+   unsigned int m_current;
+   bool m_historyValid;
+
+};
\ No newline at end of file
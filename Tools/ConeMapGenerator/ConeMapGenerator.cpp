@@ -0,0 +1,286 @@
+// Cone step map generator
+// Offline tool for ConeStepMapping.fs, converts a depth map( white = deep, ex. bricks2_disp.jpg ) into a cone map:
+//    R = depth, G = sqrt( cone ratio ), B = 0
+// The cone ratio of a texel is the widest cone( horizontal uv distance / depth ), standing on the surface at that texel,
+// which contains no higher texel. A ray can step that far without missing any geometry.
+// sqrt spreads the 8 bit precision towards narrow cones, values are rounded down so the cones stay conservative.
+//
+// Brute force, every texel searches square rings around itself until no ring can hold a narrower cone.
+// Ring rows are evaluated 4 texels at a time with SSE, rows are spread over all hardware threads.
+//
+// Build: Projects/ConeMapGenerator.vcxproj( part of opengl-study.sln ), or standalone:
+//    cl /O2 /EHsc /I..\..\Thirdparty\stb_image ConeMapGenerator.cpp
+//    g++ -O2 -std=c++14 -pthread -I../../Thirdparty/stb_image ConeMapGenerator.cpp -o ConeMapGenerator
+// Usage:
+//    ConeMapGenerator <depth map> <output.tga> [--height] [--clamp]
+//    --height : input is a height map( white = high )
+//    --clamp  : texture does not tile, texels outside the image never occlude
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+   struct HeightField
+   {
+      std::vector<float> Heights;   // Padded by half the image on every side( wrapped or 'never higher' )
+      int Width = 0;
+      int Height = 0;
+      int PadX = 0;
+      int PadY = 0;
+      int Stride = 0;
+      float MaxHeight = 0.0f;
+
+      const float* Row( int y ) const { return Heights.data( ) + ( y + PadY ) * Stride + PadX; }
+   };
+
+   HeightField BuildHeightField( const unsigned char* pixels, int width, int height, bool isHeightMap, bool wrap )
+   {
+      HeightField field;
+      field.Width = width;
+      field.Height = height;
+      field.PadX = width / 2;
+      field.PadY = height / 2;
+      field.Stride = width + 2 * field.PadX;
+      field.Heights.assign( static_cast<size_t>( field.Stride ) * ( height + 2 * field.PadY ), -1.0f );
+
+      for ( int y = -field.PadY; y < height + field.PadY; ++y )
+      {
+         for ( int x = -field.PadX; x < width + field.PadX; ++x )
+         {
+            bool inside = x >= 0 && x < width && y >= 0 && y < height;
+            if ( !inside && !wrap )
+            {
+               continue;
+            }
+
+            int srcX = ( x + width ) % width;
+            int srcY = ( y + height ) % height;
+            float value = pixels[ srcY * width + srcX ] / 255.0f;
+            float heightValue = isHeightMap ? value : 1.0f - value;
+            field.Heights[ ( y + field.PadY ) * field.Stride + x + field.PadX ] = heightValue;
+            field.MaxHeight = std::max( field.MaxHeight, heightValue );
+         }
+      }
+
+      return field;
+   }
+
+   // Narrowest squared cone ratio among 'count' contiguous texels of one row, starting 'dx' texels from the center
+   float RowMinRatioSq( const float* heights, int count, int dx, float dyTermSq, float center, float invWidth, float best )
+   {
+      const __m128 centerV = _mm_set1_ps( center );
+      const __m128 invWidthV = _mm_set1_ps( invWidth );
+      const __m128 dyTermV = _mm_set1_ps( dyTermSq );
+      const __m128 stepV = _mm_set1_ps( 4.0f );
+      const __m128 zero = _mm_setzero_ps( );
+      __m128 dxV = _mm_setr_ps( static_cast<float>( dx ), dx + 1.0f, dx + 2.0f, dx + 3.0f );
+      __m128 bestV = _mm_set1_ps( best );
+
+      int idx = 0;
+      for ( ; idx + 4 <= count; idx += 4 )
+      {
+         __m128 dh = _mm_sub_ps( _mm_loadu_ps( heights + idx ), centerV );
+         __m128 u = _mm_mul_ps( dxV, invWidthV );
+         __m128 distSq = _mm_add_ps( _mm_mul_ps( u, u ), dyTermV );
+         __m128 ratioSq = _mm_div_ps( distSq, _mm_mul_ps( dh, dh ) );
+
+         // Only higher texels occlude
+         __m128 higher = _mm_cmpgt_ps( dh, zero );
+         ratioSq = _mm_or_ps( _mm_and_ps( higher, ratioSq ), _mm_andnot_ps( higher, bestV ) );
+         bestV = _mm_min_ps( bestV, ratioSq );
+         dxV = _mm_add_ps( dxV, stepV );
+      }
+
+      float lanes[ 4 ];
+      _mm_storeu_ps( lanes, bestV );
+      best = std::min( std::min( lanes[ 0 ], lanes[ 1 ] ), std::min( lanes[ 2 ], lanes[ 3 ] ) );
+
+      for ( ; idx < count; ++idx )
+      {
+         float dh = heights[ idx ] - center;
+         if ( dh > 0.0f )
+         {
+            float u = ( dx + idx ) * invWidth;
+            best = std::min( best, ( u * u + dyTermSq ) / ( dh * dh ) );
+         }
+      }
+
+      return best;
+   }
+
+   float ConeRatio( const HeightField& field, int x, int y )
+   {
+      const float center = field.Row( y )[ x ];
+      const float maxRise = field.MaxHeight - center;
+      if ( maxRise <= 0.0f )
+      {
+         return 1.0f;
+      }
+
+      const float invWidth = 1.0f / field.Width;
+      const float invHeight = 1.0f / field.Height;
+      const float ringUV = 1.0f / std::max( field.Width, field.Height );   // Closest uv distance per ring
+      const int maxRing = std::min( field.PadX, field.PadY );
+
+      // Stored ratios saturate at 1
+      float bestSq = 1.0f;
+      for ( int ring = 1; ring <= maxRing; ++ring )
+      {
+         // Nothing in this ring or beyond can be narrower than the best cone so far
+         float ringDist = ring * ringUV;
+         if ( ringDist * ringDist >= bestSq * maxRise * maxRise )
+         {
+            break;
+         }
+
+         // Top and bottom rows
+         for ( int dy = -ring; dy <= ring; dy += 2 * ring )
+         {
+            float v = dy * invHeight;
+            bestSq = RowMinRatioSq( field.Row( y + dy ) + x - ring, 2 * ring + 1, -ring, v * v, center, invWidth, bestSq );
+         }
+
+         // Left and right columns
+         for ( int dy = -ring + 1; dy < ring; ++dy )
+         {
+            const float* row = field.Row( y + dy );
+            float v = dy * invHeight;
+            for ( int dx = -ring; dx <= ring; dx += 2 * ring )
+            {
+               float dh = row[ x + dx ] - center;
+               if ( dh > 0.0f )
+               {
+                  float u = dx * invWidth;
+                  bestSq = std::min( bestSq, ( u * u + v * v ) / ( dh * dh ) );
+               }
+            }
+         }
+      }
+
+      return std::sqrt( bestSq );
+   }
+
+   bool WriteTGA( const std::string& path, int width, int height, const std::vector<unsigned char>& bgr )
+   {
+      std::ofstream file( path, std::ios::binary );
+      if ( !file )
+      {
+         return false;
+      }
+
+      unsigned char header[ 18 ] = { };
+      header[ 2 ] = 2;   // Uncompressed true color
+      header[ 12 ] = static_cast<unsigned char>( width & 0xFF );
+      header[ 13 ] = static_cast<unsigned char>( width >> 8 );
+      header[ 14 ] = static_cast<unsigned char>( height & 0xFF );
+      header[ 15 ] = static_cast<unsigned char>( height >> 8 );
+      header[ 16 ] = 24;
+      header[ 17 ] = 0x20;  // Top left origin, same row order as the source image
+      file.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+      file.write( reinterpret_cast<const char*>( bgr.data( ) ), bgr.size( ) );
+      return static_cast<bool>( file );
+   }
+}
+
+int main( int argc, char** argv )
+{
+   if ( argc < 3 )
+   {
+      std::cout << "Usage: ConeMapGenerator <depth map> <output.tga> [--height] [--clamp]" << std::endl;
+      return 1;
+   }
+
+   bool isHeightMap = false;
+   bool wrap = true;
+   for ( int idx = 3; idx < argc; ++idx )
+   {
+      if ( std::strcmp( argv[ idx ], "--height" ) == 0 )
+      {
+         isHeightMap = true;
+      }
+      else if ( std::strcmp( argv[ idx ], "--clamp" ) == 0 )
+      {
+         wrap = false;
+      }
+      else
+      {
+         std::cout << "Unknown option: " << argv[ idx ] << std::endl;
+         return 1;
+      }
+   }
+
+   int width = 0;
+   int height = 0;
+   int channels = 0;
+   unsigned char* pixels = stbi_load( argv[ 1 ], &width, &height, &channels, 1 );
+   if ( pixels == nullptr )
+   {
+      std::cout << "Failed to load " << argv[ 1 ] << std::endl;
+      return 1;
+   }
+   if ( width > 0xFFFF || height > 0xFFFF )
+   {
+      std::cout << "Image too large for TGA" << std::endl;
+      stbi_image_free( pixels );
+      return 1;
+   }
+
+   auto begin = std::chrono::steady_clock::now( );
+   HeightField field = BuildHeightField( pixels, width, height, isHeightMap, wrap );
+
+   std::vector<unsigned char> output( static_cast<size_t>( width ) * height * 3 );
+   std::atomic<int> nextRow( 0 );
+   auto worker = [ & ]( )
+   {
+      for ( int y = nextRow++; y < height; y = nextRow++ )
+      {
+         for ( int x = 0; x < width; ++x )
+         {
+            // Rounded down, a wider stored cone could step over geometry
+            float encoded = std::sqrt( ConeRatio( field, x, y ) );
+            unsigned char cone = static_cast<unsigned char>( std::max( std::floor( encoded * 255.0f ), 1.0f ) );
+
+            unsigned char* texel = &output[ ( static_cast<size_t>( y ) * width + x ) * 3 ];
+            texel[ 0 ] = 0;
+            texel[ 1 ] = cone;
+            texel[ 2 ] = isHeightMap ? static_cast<unsigned char>( 255 - pixels[ y * width + x ] ) : pixels[ y * width + x ];
+         }
+      }
+   };
+
+   unsigned int threadCount = std::max( 1u, std::thread::hardware_concurrency( ) );
+   std::vector<std::thread> threads;
+   for ( unsigned int idx = 1; idx < threadCount; ++idx )
+   {
+      threads.emplace_back( worker );
+   }
+   worker( );
+   for ( auto& thread : threads )
+   {
+      thread.join( );
+   }
+   stbi_image_free( pixels );
+
+   float seconds = std::chrono::duration<float>( std::chrono::steady_clock::now( ) - begin ).count( );
+   if ( !WriteTGA( argv[ 2 ], width, height, output ) )
+   {
+      std::cout << "Failed to write " << argv[ 2 ] << std::endl;
+      return 1;
+   }
+
+   printf( "%dx%d cone map written to %s in %.2f s( %u threads )\n", width, height, argv[ 2 ], seconds, threadCount );
+   return 0;
+}
\ No newline at end of file
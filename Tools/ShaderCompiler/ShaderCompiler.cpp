@@ -0,0 +1,398 @@
+// Offline shader compiler
+// Validates every shader in a directory and optimizes the programs the demo actually builds, so the driver front end
+// only ever sees small, pre checked GLSL.
+//
+// 1) Every stage file( .vs .fs .gs .cs, legacy *VS.glsl / *PS.glsl ) is validated with glslang for OpenGL.
+//    Files without main( ) are includes / samples for copy paste and are skipped, '#include "file"' is expanded first
+//    the same way Shader does.
+// 2) Every program listed in '<output>/programs.txt'( appended by Shader at runtime whenever a program has
+//    no up to date optimized output ) is compiled to SPIR-V with its defines applied, linked across both stages,
+//    run through spirv-opt -O( inlining, constant folding, dead code elimination ) and emitted back out as GLSL 330
+//    by spirv-cross. Output is validated again, anything that fails is deleted so runtime keeps using the sources.
+//    Outputs: <key>.vert.glsl / <key>.frag.glsl( loaded by Shader ) and the optimized <key>.vert.spv / <key>.frag.spv.
+//    The SPIR-V is not loaded through ARB_gl_spirv on 4.6 contexts: SPIR-V programs have no uniform names to query,
+//    every default block uniform would need an explicit layout( location ) and Shader sets all of them by name.
+//
+// Requires glslangValidator, spirv-opt and spirv-cross on PATH( all ship with the Vulkan SDK ).
+//
+// Build: Projects/ShaderCompiler.vcxproj, run by the pre build step of opengl-study.vcxproj into Projects/ShaderCache.
+// Standalone build:
+//    cl /O2 /EHsc ShaderCompiler.cpp
+//    g++ -O2 -std=c++14 ShaderCompiler.cpp -o ShaderCompiler
+// Usage:
+//    ShaderCompiler <shader directory> <output directory>    ex) ShaderCompiler ..\Resources\Shaders ShaderCache
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+   const char* ProgramManifest = "programs.txt";
+
+   struct Program
+   {
+      std::string Key;
+      std::string Vertex;
+      std::string Fragment;
+      std::vector<std::string> Defines;
+   };
+
+   bool ReadFile( const std::string& path, std::string& contents )
+   {
+      std::ifstream stream( path, std::ios::binary );
+      if ( !stream )
+      {
+         return false;
+      }
+
+      std::stringstream ss;
+      ss << stream.rdbuf( );
+      contents = ss.str( );
+      return true;
+   }
+
+   bool WriteFile( const std::string& path, const std::string& contents )
+   {
+      std::ofstream stream( path, std::ios::binary );
+      stream << contents;
+      return static_cast<bool>( stream );
+   }
+
+   // Succeeds when the directory already exists
+   void MakeDirectory( const std::string& directory )
+   {
+#ifdef _WIN32
+      _mkdir( directory.c_str( ) );
+#else
+      mkdir( directory.c_str( ), 0755 );
+#endif
+   }
+
+   std::vector<std::string> ListDirectory( const std::string& directory )
+   {
+      std::vector<std::string> names;
+#ifdef _WIN32
+      _finddata_t data;
+      intptr_t handle = _findfirst( ( directory + "*" ).c_str( ), &data );
+      if ( handle != -1 )
+      {
+         do
+         {
+            if ( ( data.attrib & _A_SUBDIR ) == 0 )
+            {
+               names.push_back( data.name );
+            }
+         } while ( _findnext( handle, &data ) == 0 );
+         _findclose( handle );
+      }
+#else
+      if ( DIR* dir = opendir( directory.c_str( ) ) )
+      {
+         while ( dirent* entry = readdir( dir ) )
+         {
+            if ( entry->d_type != DT_DIR )
+            {
+               names.push_back( entry->d_name );
+            }
+         }
+         closedir( dir );
+      }
+#endif
+      return names;
+   }
+
+   bool EndsWith( const std::string& value, const std::string& suffix )
+   {
+      return value.size( ) >= suffix.size( ) && value.compare( value.size( ) - suffix.size( ), suffix.size( ), suffix ) == 0;
+   }
+
+   // glslang stage name, empty for anything that is not a shader
+   std::string GetStage( const std::string& name )
+   {
+      if ( EndsWith( name, ".vs" ) || EndsWith( name, "VS.glsl" ) )
+      {
+         return "vert";
+      }
+      if ( EndsWith( name, ".fs" ) || EndsWith( name, "PS.glsl" ) )
+      {
+         return "frag";
+      }
+      if ( EndsWith( name, ".gs" ) )
+      {
+         return "geom";
+      }
+      if ( EndsWith( name, ".cs" ) )
+      {
+         return "comp";
+      }
+
+      return std::string( );
+   }
+
+   // Same as Shader.cpp, defines go right after #version.
+   std::string InjectDefines( const std::string& source, const std::vector<std::string>& defines )
+   {
+      std::string defineBlock;
+      for ( const auto& define : defines )
+      {
+         defineBlock += "#define " + define + "\n";
+      }
+
+      size_t versionPos = source.find( "#version" );
+      if ( versionPos == std::string::npos )
+      {
+         return defineBlock + source;
+      }
+
+      size_t lineEnd = source.find( '\n', versionPos );
+      if ( lineEnd == std::string::npos )
+      {
+         return source + "\n" + defineBlock;
+      }
+
+      return source.substr( 0, lineEnd + 1 ) + defineBlock + source.substr( lineEnd + 1 );
+   }
+
+   // Same as Shader.cpp, '#include "file"' lines are replaced with the file, resolved next to the including file.
+   bool ExpandIncludes( const std::string& path, std::vector<std::string>& included, std::string& result )
+   {
+      std::string source;
+      if ( !ReadFile( path, source ) )
+      {
+         std::cout << "Missing source: " << path << std::endl;
+         return false;
+      }
+      included.push_back( path );
+      std::string directory = path.substr( 0, path.find_last_of( "/\\" ) + 1 );
+
+      std::istringstream lines( source );
+      std::string line;
+      while ( std::getline( lines, line ) )
+      {
+         size_t directive = line.find_first_not_of( " \t" );
+         if ( directive == std::string::npos || line.compare( directive, 8, "#include" ) != 0 )
+         {
+            result += line + "\n";
+            continue;
+         }
+
+         size_t open = line.find( '"', directive );
+         size_t close = ( open != std::string::npos ) ? line.find( '"', open + 1 ) : std::string::npos;
+         if ( close == std::string::npos )
+         {
+            std::cout << "Malformed include: " << path << std::endl;
+            return false;
+         }
+
+         std::string includePath = directory + line.substr( open + 1, close - open - 1 );
+         bool listed = false;
+         for ( const auto& file : included )
+         {
+            listed = listed || ( file == includePath );
+         }
+         if ( !listed && !ExpandIncludes( includePath, included, result ) )
+         {
+            return false;
+         }
+      }
+
+      return true;
+   }
+
+   bool ExpandIncludes( const std::string& path, std::string& result )
+   {
+      std::vector<std::string> included;
+      return ExpandIncludes( path, included, result );
+   }
+
+   bool Run( const std::string& command )
+   {
+      if ( std::system( command.c_str( ) ) != 0 )
+      {
+         std::cout << "Failed: " << command << std::endl;
+         return false;
+      }
+
+      return true;
+   }
+
+   // Runs 'command' inside 'directory', glslang writes linked stages to fixed names in the working directory.
+   bool RunIn( const std::string& directory, const std::string& command )
+   {
+#ifdef _WIN32
+      return Run( "cd /d \"" + directory + "\" && " + command );
+#else
+      return Run( "cd \"" + directory + "\" && " + command );
+#endif
+   }
+
+   std::vector<Program> ReadManifest( const std::string& path )
+   {
+      std::vector<Program> programs;
+
+      std::ifstream manifest( path );
+      std::string line;
+      while ( std::getline( manifest, line ) )
+      {
+         if ( !line.empty( ) && line.back( ) == '\r' )
+         {
+            line.pop_back( );
+         }
+
+         // <key> <vertex> <fragment> [define|define...], defines may contain spaces( "TONEMAP 2" )
+         std::istringstream fields( line );
+         Program program;
+         if ( !( fields >> program.Key >> program.Vertex >> program.Fragment ) )
+         {
+            continue;
+         }
+
+         std::string defines;
+         std::getline( fields >> std::ws, defines );
+         size_t begin = 0;
+         while ( begin < defines.size( ) )
+         {
+            size_t end = defines.find( '|', begin );
+            if ( end == std::string::npos )
+            {
+               end = defines.size( );
+            }
+            if ( end > begin )
+            {
+               program.Defines.push_back( defines.substr( begin, end - begin ) );
+            }
+            begin = end + 1;
+         }
+
+         programs.push_back( program );
+      }
+
+      return programs;
+   }
+
+   // glslang sees the expanded copy written to 'output', includes are not a GLSL 330 feature
+   bool ValidateFile( const std::string& directory, const std::string& output, const std::string& name )
+   {
+      std::string stage = GetStage( name );
+      std::string source;
+      if ( stage.empty( ) || !ReadFile( directory + name, source ) || source.find( "main(" ) == std::string::npos )
+      {
+         return true;
+      }
+
+      std::string expanded;
+      if ( !ExpandIncludes( directory + name, expanded ) )
+      {
+         return false;
+      }
+
+      const std::string copy = output + name + ".src";
+      WriteFile( copy, expanded );
+      bool succeeded = Run( "glslangValidator -S " + stage + " \"" + copy + "\"" );
+      std::remove( copy.c_str( ) );
+      return succeeded;
+   }
+
+   bool OptimizeProgram( const std::string& directory, const std::string& output, const Program& program )
+   {
+      const std::string stages[ 2 ] = { "vert", "frag" };
+      const std::string sources[ 2 ] = { program.Vertex, program.Fragment };
+
+      for ( int idx = 0; idx < 2; ++idx )
+      {
+         std::string source;
+         if ( !ExpandIncludes( directory + sources[ idx ], source ) )
+         {
+            return false;
+         }
+         WriteFile( output + program.Key + ".src." + stages[ idx ], InjectDefines( source, program.Defines ) );
+      }
+
+      // Both stages in one glslang program so varyings and uniforms get matching locations
+      bool succeeded = RunIn( output, "glslangValidator -G --auto-map-locations --auto-map-bindings -l " +
+                              program.Key + ".src.vert " + program.Key + ".src.frag" );
+
+      for ( int idx = 0; idx < 2 && succeeded; ++idx )
+      {
+         const std::string spirv = output + program.Key + "." + stages[ idx ] + ".spv";
+         const std::string glsl = output + program.Key + "." + stages[ idx ] + ".glsl";
+
+         // Debug names are kept, Shader sets every uniform by name
+         succeeded = Run( "spirv-opt -O --target-env=opengl4.5 \"" + output + stages[ idx ] + ".spv\" -o \"" + spirv + "\"" ) &&
+                     Run( "spirv-cross \"" + spirv + "\" --version 330 --no-es --no-420pack-extension --output \"" + glsl + "\"" );
+      }
+
+      succeeded = succeeded && RunIn( output, "glslangValidator -l " + program.Key + ".vert.glsl " + program.Key + ".frag.glsl" );
+
+      for ( const auto& stage : stages )
+      {
+         std::remove( ( output + program.Key + ".src." + stage ).c_str( ) );
+         std::remove( ( output + stage + ".spv" ).c_str( ) );
+         if ( !succeeded )
+         {
+            std::remove( ( output + program.Key + "." + stage + ".spv" ).c_str( ) );
+            std::remove( ( output + program.Key + "." + stage + ".glsl" ).c_str( ) );
+         }
+      }
+
+      return succeeded;
+   }
+}
+
+int main( int argc, char** argv )
+{
+   if ( argc < 3 )
+   {
+      std::cout << "Usage: ShaderCompiler <shader directory> <output directory>" << std::endl;
+      return 1;
+   }
+
+   std::string directory = argv[ 1 ];
+   std::string output = argv[ 2 ];
+   for ( std::string* path : { &directory, &output } )
+   {
+      if ( path->back( ) != '/' && path->back( ) != '\\' )
+      {
+         *path += '/';
+      }
+   }
+   MakeDirectory( output );
+
+   unsigned int fileFailures = 0;
+   std::vector<std::string> files = ListDirectory( directory );
+   for ( const auto& name : files )
+   {
+      if ( !ValidateFile( directory, output, name ) )
+      {
+         ++fileFailures;
+      }
+   }
+
+   unsigned int programFailures = 0;
+   std::vector<Program> programs = ReadManifest( output + ProgramManifest );
+   for ( const auto& program : programs )
+   {
+      std::cout << program.Key << " " << program.Vertex << " + " << program.Fragment << std::endl;
+      if ( !OptimizeProgram( directory, output, program ) )
+      {
+         ++programFailures;
+      }
+   }
+
+   std::cout << files.size( ) << " files checked, " << fileFailures << " failed" << std::endl;
+   std::cout << programs.size( ) << " programs optimized, " << programFailures << " failed" << std::endl;
+
+   return ( fileFailures == 0 && programFailures == 0 ) ? 0 : 1;
+}
\ No newline at end of file